@@ -49,7 +49,8 @@
 
 
 /*DAC Output Config*/
-#define CONFIG_ENABLE_DAC
+// The DAC shares its chip select with the flash, which holds the checkpoints of the pi race
+// #define CONFIG_ENABLE_DAC
 #ifdef CONFIG_ENABLE_DAC
     // #define CONFIG_DAC_STREAMING
     #ifdef CONFIG_DAC_STREAMING
@@ -94,6 +95,6 @@
     // #define CONFIG_RTC_SHOW_TIME
 #endif
 
-//#define CONFIG_ENABLE_FLASH //Not yet implemented
+#define CONFIG_ENABLE_FLASH
 
 //#define CONFIG_ENABLE_SDCARD //Not yet implemented
@@ -1,6 +1,25 @@
 #pragma once
 
 #include <stdio.h>
+#include <stdbool.h>
+#include "lfs.h"
+
+// W25Q32 on the shared SPI bus, 1024 sectors of 4 KiB programmed in pages of 256 bytes
+#define FLASH_BLOCK_SIZE        4096
+#define FLASH_BLOCK_COUNT       1024
+#define FLASH_PAGE_SIZE         256
+// The last blocks are left out of the filesystem for raw users, like the checkpoints of the pi race
+#define FLASH_RESERVED_BLOCKS   16
 
 void flash_checkConnection();
-void eduboard_init_flash();
\ No newline at end of file
+void eduboard_init_flash();
+// False on a board whose littlefs was formatted over all FLASH_BLOCK_COUNT blocks before the
+// reserve. Its files are kept and the reserved blocks stay with littlefs until a new format.
+bool eduboard_flash_reserved_free();
+
+// The littlefs block device on top of w25.c, also usable on the reserved blocks. cfg is not read,
+// reads and programs must stay within one page.
+int storage_lfs_read(const struct lfs_config *cfg, lfs_block_t block, lfs_off_t off, void *buffer, lfs_size_t size);
+int storage_lfs_prog(const struct lfs_config *cfg, lfs_block_t block, lfs_off_t off, const void *buffer, lfs_size_t size);
+int storage_lfs_erase(const struct lfs_config *cfg, lfs_block_t block);
+int storage_lfs_sync(const struct lfs_config *cfg);
@@ -9,9 +9,7 @@
 #include "esp_log.h"
 #include "esp_system.h"
 
-#ifndef CONFIG_ENABLE_FLASH
-#include "../lfs/lfs.h"
-#endif
+#include "lfs.h"
 
 #include "w25.h"
 
@@ -19,16 +17,11 @@
 
 #define TAG "Flash_driver"
 
-int storage_lfs_read(const struct lfs_config *cfg, lfs_block_t block, lfs_off_t off, void *buffer, lfs_size_t size);
-int storage_lfs_prog(const struct lfs_config *cfg, lfs_block_t block, lfs_off_t off, const void *buffer, lfs_size_t size);
-int storage_lfs_erase(const struct lfs_config *cfg, lfs_block_t block);
-int storage_lfs_sync(const struct lfs_config *cfg);
-
 // variables used by the filesystem
 lfs_t lfs;
 lfs_file_t file;
 
-#define BLOCK_SIZE 4096
+#define BLOCK_SIZE FLASH_BLOCK_SIZE
 
 // configuration of the filesystem is provided by this struct
 const struct lfs_config cfg = {
@@ -42,12 +35,16 @@ const struct lfs_config cfg = {
     .read_size = 16,
     .prog_size = 16,
     .block_size = BLOCK_SIZE,
-    .block_count = 1024, // 32Mbit
+    .block_count = FLASH_BLOCK_COUNT - FLASH_RESERVED_BLOCKS, // 32Mbit without the reserved blocks
     .cache_size = 16,
     .lookahead_size = 16,
     .block_cycles = 500,
 };
 
+// the geometry before FLASH_RESERVED_BLOCKS, littlefs keeps a pointer to it while mounted
+struct lfs_config cfgWhole;
+bool reservedFree = true;
+
 int storage_lfs_read(const struct lfs_config *cfg, lfs_block_t block, lfs_off_t off, void *buffer, lfs_size_t size)
 {
     uint32_t addr = (block * BLOCK_SIZE) + off;
@@ -132,6 +129,21 @@ void eduboard_init_flash() {
     // mount the filesystem
     int err = lfs_mount(&lfs, &cfg);
 
+    // a filesystem formatted over the whole chip before the reserve does not mount with fewer
+    // blocks. Its files stay, it may use the reserved blocks, so they are not free for raw users.
+    if (err)
+    {
+        cfgWhole = cfg;
+        cfgWhole.block_count = FLASH_BLOCK_COUNT;
+        if (lfs_mount(&lfs, &cfgWhole) == LFS_ERR_OK)
+        {
+            reservedFree = false;
+            err = LFS_ERR_OK;
+            ESP_LOGW(TAG, "littlefs spans all %d blocks, the last %d are not reserved until it is formatted again",
+                     FLASH_BLOCK_COUNT, FLASH_RESERVED_BLOCKS);
+        }
+    }
+
     // reformat if we can't mount the filesystem
     // this should only happen on the first boot
     if (err)
@@ -141,4 +153,8 @@ void eduboard_init_flash() {
     }
 
     ESP_LOGI(TAG, "init flash done");
-}
\ No newline at end of file
+}
+
+bool eduboard_flash_reserved_free() {
+    return reservedFree;
+}
@@ -0,0 +1,1261 @@
+/********************************************************************************************* */
+//    picalc host benchmarks
+//    Runs the same engine code that ships on the board on a Linux host. Timings only, the
+//    pass/fail checks are in test/picalc_test.c.
+//
+//    Usage: picalc_bench <benchmark> [args]
+/********************************************************************************************* */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <math.h>
+#include <pthread.h>
+#include <stdatomic.h>
+
+#include "picalc_bigint.h"
+#include "picalc_ntt.h"
+#include "picalc_chudnovsky.h"
+#include "picalc_spigot.h"
+#include "picalc_bbp.h"
+#include "picalc_machin.h"
+#include "picalc_agm.h"
+#include "picalc_accel.h"
+#include "picalc_series.h"
+#include "picalc_mailbox.h"
+#include "picalc_executor.h"
+#include "picalc_simd.h"
+#include "picalc_algo.h"
+#include "picalc_montecarlo.h"
+#include "picalc_sweep.h"
+#include "picalc_race.h"
+#include "picalc_checkpoint.h"
+#include "picalc_port.h"
+
+static double bench_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static uint64_t benchBigintSeed = 0x2545F4914F6CDD1Dull;
+
+static uint64_t bench_bigint_random(void) {
+    benchBigintSeed ^= benchBigintSeed << 13;
+    benchBigintSeed ^= benchBigintSeed >> 7;
+    benchBigintSeed ^= benchBigintSeed << 17;
+    return benchBigintSeed;
+}
+
+// Random limbs, some operands all ones or with runs of zero limbs to hit the carries
+static void bench_bigint_fill(bigint_limb_t* a, size_t n) {
+    uint64_t pattern = bench_bigint_random() % 4;
+    for(size_t i = 0; i < n; i++) {
+        bigint_limb_t limb = (bigint_limb_t)bench_bigint_random();
+        a[i] = (pattern == 0) ? (bigint_limb_t)~(bigint_limb_t)0 : (pattern == 1 && i % 3 == 1) ? 0 : limb;
+    }
+    if(n > 0 && a[n - 1] == 0) {
+        a[n - 1] = 1;
+    }
+}
+
+// Products of n x n limbs from 1024 limbs up: Toom-3 as long as it takes less than a second or
+// so, the transforms on the calling thread and on an executor with a worker per core
+static int bench_bigint_ntt(size_t maxLimbs) {
+    executor_t ex;
+    uint32_t workers = picalc_core_count();
+    executor_init(&ex, workers, 1);
+    bigint_limb_t* a = malloc(2 * maxLimbs * sizeof(bigint_limb_t));
+    bigint_limb_t* b = &a[maxLimbs];
+    bigint_limb_t* serial = malloc(2 * maxLimbs * sizeof(bigint_limb_t));
+    bigint_limb_t* parallel = malloc(2 * maxLimbs * sizeof(bigint_limb_t));
+    bigint_limb_t* toom = malloc(2 * maxLimbs * sizeof(bigint_limb_t));
+    const bigintMulThresholds_t noNtt = {BIGINT_KARATSUBA_THRESHOLD, BIGINT_TOOM3_THRESHOLD, SIZE_MAX};
+    printf("%u bit limbs, NTT from %u limbs, %u workers\n", (unsigned)BIGINT_LIMB_BITS, (unsigned)BIGINT_NTT_THRESHOLD,
+           (unsigned)workers);
+    printf("%9s %10s %12s %12s %12s %8s\n", "limbs", "digits", "toom3[ms]", "ntt[ms]", "parallel[ms]", "speedup");
+    for(size_t n = 1024; n <= maxLimbs; n *= 2) {
+        bench_bigint_fill(a, n);
+        bench_bigint_fill(b, n);
+        double toomMs = 0.0;
+        if(n <= 16384) {
+            double t0 = bench_seconds();
+            bigint_mul_limbs(toom, a, n, b, n, BIGINT_MUL_AUTO, &noNtt);
+            toomMs = (bench_seconds() - t0) * 1e3;
+        }
+        ntt_set_executor(NULL);
+        double t0 = bench_seconds();
+        bool done = ntt_mul(serial, a, n, b, n);
+        double serialMs = (bench_seconds() - t0) * 1e3;
+        ntt_set_executor(&ex);
+        t0 = bench_seconds();
+        done = done && ntt_mul(parallel, a, n, b, n);
+        double parallelMs = (bench_seconds() - t0) * 1e3;
+        ntt_set_executor(NULL);
+        if(!done) {
+            printf("%9u too long for the transforms\n", (unsigned)n);
+            break;
+        }
+
+        char toomText[16] = "-";
+        if(toomMs > 0.0) {
+            snprintf(toomText, sizeof(toomText), "%.3f", toomMs);
+        }
+        printf("%9u %10.0f %12s %12.3f %12.3f %7.2fx\n", (unsigned)n, n * BIGINT_LIMB_BITS * 0.30103, toomText, serialMs,
+               parallelMs, serialMs / parallelMs);
+    }
+    executor_shutdown(&ex);
+    free(a);
+    free(serial);
+    free(parallel);
+    free(toom);
+    return 0;
+}
+
+static int bench_bigint(int argc, char** argv) {
+    if(argc > 0 && strcmp(argv[0], "ntt") == 0) {
+        return bench_bigint_ntt((argc > 1) ? (size_t)strtoul(argv[1], NULL, 10) : (size_t)1 << 18);
+    }
+    if(argc > 0 && strcmp(argv[0], "tune") == 0) {
+        size_t maxLimbs = (argc > 1) ? (size_t)strtoul(argv[1], NULL, 10) : 1000;
+        bigintMulThresholds_t thresholds;
+        printf("%u bit limbs, built with Karatsuba from %u, Toom-3 from %u and NTT from %u limbs\n",
+               (unsigned)BIGINT_LIMB_BITS, (unsigned)BIGINT_KARATSUBA_THRESHOLD, (unsigned)BIGINT_TOOM3_THRESHOLD,
+               (unsigned)BIGINT_NTT_THRESHOLD);
+        bigint_tune(&thresholds, maxLimbs, stdout);
+        printf("#define BIGINT_KARATSUBA_THRESHOLD  %u\n", (unsigned)thresholds.karatsuba);
+        printf("#define BIGINT_TOOM3_THRESHOLD      %u\n", (unsigned)thresholds.toom3);
+        printf("#define BIGINT_NTT_THRESHOLD        %u\n", (unsigned)thresholds.ntt);
+        return 0;
+    }
+    size_t maxLimbs = (argc > 0) ? (size_t)strtoul(argv[0], NULL, 10) : 4096;
+    static const bigintMul_t methods[] = {BIGINT_MUL_SCHOOLBOOK, BIGINT_MUL_KARATSUBA, BIGINT_MUL_TOOM3, BIGINT_MUL_NTT,
+                                          BIGINT_MUL_AUTO};
+    bigint_limb_t* a = malloc(2 * maxLimbs * sizeof(bigint_limb_t));
+    bigint_limb_t* b = &a[maxLimbs];
+    bigint_limb_t* r = malloc(2 * maxLimbs * sizeof(bigint_limb_t));
+    if(a == NULL || r == NULL) {
+        free(a);
+        free(r);
+        return 1;
+    }
+    // n x n products of each method, repeated for about 20 ms
+    printf("%u bit limbs, us per product\n", (unsigned)BIGINT_LIMB_BITS);
+    printf("%9s %12s %12s %12s %12s %12s\n", "limbs", "schoolbook", "karatsuba", "toom3", "ntt", "auto");
+    for(size_t n = 8; n <= maxLimbs; n *= 2) {
+        bench_bigint_fill(a, n);
+        bench_bigint_fill(b, n);
+        printf("%9u", (unsigned)n);
+        for(size_t m = 0; m < sizeof(methods) / sizeof(methods[0]); m++) {
+            uint32_t repeats = 0;
+            double start = bench_seconds();
+            double elapsed;
+            do {
+                bigint_mul_limbs(r, a, n, b, n, methods[m], NULL);
+                repeats++;
+                elapsed = bench_seconds() - start;
+            } while(elapsed < 0.02);
+            printf(" %12.2f", elapsed * 1e6 / repeats);
+        }
+        printf("\n");
+    }
+    free(a);
+    free(r);
+    return 0;
+}
+
+static int bench_chudnovsky(int argc, char** argv) {
+    uint32_t maxDigits = (argc > 0) ? (uint32_t)strtoul(argv[0], NULL, 10) : 100000;
+    char* out = malloc(maxDigits + 3);
+    if(out == NULL) {
+        return 1;
+    }
+    printf("%10s %10s %12s %14s  %s\n", "digits", "terms", "time[ms]", "digits/s", "tail");
+    for(uint32_t digits = 100; digits <= maxDigits; digits *= 10) {
+        chudnovskyStats_t stats;
+        double start = bench_seconds();
+        if(!chudnovsky_compute(digits, out, maxDigits + 3, NULL, &stats)) {
+            fprintf(stderr, "chudnovsky: computation of %u digits failed\n", (unsigned)digits);
+            free(out);
+            return 1;
+        }
+        double elapsed = bench_seconds() - start;
+        printf("%10u %10u %12.3f %14.0f  ...%s\n", (unsigned)stats.digits, (unsigned)stats.terms,
+               elapsed * 1000.0, stats.digits / elapsed, &out[digits + 2 - 10]);
+    }
+    free(out);
+    return 0;
+}
+
+static int bench_spigot(int argc, char** argv) {
+    uint32_t maxDigits = (argc > 0) ? (uint32_t)strtoul(argv[0], NULL, 10) : 10000;
+    if(maxDigits > SPIGOT_DIGIT_LIMIT) {
+        fprintf(stderr, "spigot: at most %u digits\n", (unsigned)SPIGOT_DIGIT_LIMIT);
+        return 1;
+    }
+    uint32_t* cells = malloc(SPIGOT_CELLS(maxDigits) * sizeof(uint32_t));
+    uint8_t storage[256];
+    ringbuf_t rb;
+    if(cells == NULL) {
+        return 1;
+    }
+
+    printf("%10s %10s %12s %14s\n", "digits", "cells", "time[ms]", "digits/s");
+    for(uint32_t target = 100; target <= maxDigits; target *= 10) {
+        spigot_t spigot;
+        uint8_t value;
+        double start = bench_seconds();
+        spigot_init(&spigot, target, cells);
+        ringbuf_init(&rb, storage, sizeof(storage));
+        while(!spigot_done(&spigot) || ringbuf_count(&rb) > 0) {
+            spigot_generate(&spigot, &rb, UINT32_MAX);
+            while(ringbuf_pop(&rb, &value)) {
+            }
+        }
+        double elapsed = bench_seconds() - start;
+        printf("%10u %10u %12.3f %14.0f\n", (unsigned)target, (unsigned)SPIGOT_CELLS(target),
+               elapsed * 1000.0, target / elapsed);
+    }
+    free(cells);
+    return 0;
+}
+
+static int bench_bbp(int argc, char** argv) {
+    uint32_t position = (argc > 0) ? (uint32_t)strtoul(argv[0], NULL, 10) : 999999;
+    uint32_t count = (argc > 1) ? (uint32_t)strtoul(argv[1], NULL, 10) : 64;
+    char* out = malloc(count + 1);
+    if(out == NULL) {
+        return 1;
+    }
+
+    printf("position %u, %u hex digits\n", (unsigned)position, (unsigned)count);
+    printf("%8s %12s %14s %9s\n", "workers", "time[ms]", "digits/s", "speedup");
+    double single = 0.0;
+    for(uint32_t workers = 1; workers <= picalc_core_count(); workers *= 2) {
+        double start = bench_seconds();
+        if(!bbp_hex_digits(position, count, out, workers)) {
+            fprintf(stderr, "bbp: position out of range\n");
+            free(out);
+            return 1;
+        }
+        double elapsed = bench_seconds() - start;
+        if(workers == 1) {
+            single = elapsed;
+        }
+        printf("%8u %12.3f %14.0f %8.2fx\n", (unsigned)workers, elapsed * 1000.0, count / elapsed, single / elapsed);
+    }
+    printf("digits: %.64s%s\n", out, count > 64 ? "..." : "");
+    free(out);
+    return 0;
+}
+
+static int bench_machin(int argc, char** argv) {
+    uint32_t digits = (argc > 0) ? (uint32_t)strtoul(argv[0], NULL, 10) : 20000;
+    char* out = malloc(digits + 3);
+    int result = 0;
+    if(out == NULL) {
+        return 1;
+    }
+    for(machinFormula_t formula = MACHIN_FORMULA_MACHIN; formula <= MACHIN_FORMULA_STORMER; formula++) {
+        for(uint32_t workers = 1; workers <= 2; workers++) {
+            machinStats_t stats;
+            // workers = 2 hands every series its own worker, like the tasks on the board
+            if(!machin_compute(formula, digits, out, digits + 3, workers == 1 ? 1 : 0, NULL, &stats)) {
+                fprintf(stderr, "machin: computation failed\n");
+                result = 1;
+                break;
+            }
+            printf("%s, %u digits, %u limbs, %s: %.3f ms\n", machin_formula_name(formula), (unsigned)digits,
+                   (unsigned)stats.limbs, workers == 1 ? "sequential" : "one worker per series", stats.timeUs / 1000.0);
+            printf("    %8s %5s %7s %10s %12s %14s\n", "k", "coeff", "worker", "terms", "terms/s", "limbs/s");
+            for(uint32_t i = 0; i < stats.seriesCount; i++) {
+                machinSeriesStats_t* series = &stats.series[i];
+                double seconds = series->timeUs / 1e6;
+                printf("    %8u %5d %7u %10u %12.0f %14.0f\n", (unsigned)series->k, (int)series->coefficient,
+                       (unsigned)series->worker, (unsigned)series->terms, series->terms / seconds, series->limbOps / seconds);
+            }
+            // workers are spread over the cores round robin, like the pinned tasks on the board
+            uint32_t cores = picalc_core_count();
+            for(uint32_t core = 0; core < cores && core < stats.seriesCount; core++) {
+                uint64_t terms = 0, limbOps = 0;
+                int64_t timeUs = 0;
+                for(uint32_t i = 0; i < stats.seriesCount; i++) {
+                    if(stats.series[i].worker % cores == core) {
+                        terms += stats.series[i].terms;
+                        limbOps += stats.series[i].limbOps;
+                        timeUs += stats.series[i].timeUs;
+                    }
+                }
+                if(timeUs > 0) {
+                    printf("    core %u: %.0f terms/s, %.0f limbs/s\n", (unsigned)core, terms / (timeUs / 1e6), limbOps / (timeUs / 1e6));
+                }
+            }
+        }
+        if(result != 0) {
+            break;
+        }
+    }
+    free(out);
+    return result;
+}
+
+static int bench_agm(int argc, char** argv) {
+    uint32_t digits = (argc > 0) ? (uint32_t)strtoul(argv[0], NULL, 10) : 20000;
+    char* out = malloc(digits + 3);
+    agmStats_t stats;
+    int result = 0;
+    if(out == NULL) {
+        return 1;
+    }
+    if(!agm_compute(digits, out, digits + 3, NULL, &stats)) {
+        fprintf(stderr, "agm: computation failed\n");
+        result = 1;
+    } else {
+        printf("Gauss-Legendre, %u digits, %u bits: %.3f ms\n", (unsigned)digits, (unsigned)stats.precisionBits, stats.timeUs / 1000.0);
+        printf("%5s %10s %10s %10s %6s %7s %8s\n", "iter", "time[ms]", "sqrt[ms]", "mul[ms]", "muls", "mul[%]", "digits");
+        for(uint32_t i = 0; i < stats.iterations; i++) {
+            agmIterationStats_t* it = &stats.iteration[i];
+            printf("%5u %10.3f %10.3f %10.3f %6u %6.1f%% %8u\n", (unsigned)i + 1, it->timeUs / 1000.0, it->sqrtUs / 1000.0,
+                   it->mulUs / 1000.0, (unsigned)it->mulCount, it->timeUs > 0 ? 100.0 * it->mulUs / it->timeUs : 0.0, (unsigned)it->digits);
+        }
+        printf("final (a+b)^2/4t: %.3f ms\n", stats.finalUs / 1000.0);
+    }
+    free(out);
+    return result;
+}
+
+// Terms until the estimate is within tolerance of pi, 0 if maxTerms is not enough
+static uint32_t bench_accel_terms(bool leibniz, seriesAccel_t mode, double tolerance, uint32_t maxTerms) {
+    seriesAccelerator_t acc;
+    accel_init(&acc, mode);
+    double sum = 0.0;
+    for(uint32_t n = 0; n < maxTerms; n++) {
+        double estimate;
+        if(leibniz) {
+            sum += ((n & 1) ? -1.0 : 1.0) / (2.0 * n + 1.0);
+            accel_push(&acc, sum);
+            estimate = 4.0 * (mode == SERIES_ACCEL_NONE ? sum : accel_estimate(&acc));
+        } else {
+            double k = (double)n + 1.0;
+            sum += 1.0 / (k * k);
+            estimate = sqrt(6.0 * (sum + (mode == SERIES_ACCEL_EULER_MACLAURIN ? accel_basel_tail(n + 1) : 0.0)));
+        }
+        if(fabs(estimate - M_PI) < tolerance) {
+            return n + 1;
+        }
+    }
+    return 0;
+}
+
+static int bench_accel(int argc, char** argv) {
+    uint32_t maxTerms = (argc > 0) ? (uint32_t)strtoul(argv[0], NULL, 10) : 100000000;
+    static const struct {
+        bool leibniz;
+        seriesAccel_t mode;
+    } configs[] = {
+        {true, SERIES_ACCEL_NONE},
+        {true, SERIES_ACCEL_EULER},
+        {true, SERIES_ACCEL_WYNN},
+        {false, SERIES_ACCEL_NONE},
+        {false, SERIES_ACCEL_EULER_MACLAURIN},
+    };
+    printf("terms until |estimate - pi| < 0.5e-d\n%-16s", "series");
+    for(int d = 4; d <= 14; d += 2) {
+        printf(" %10s%-2d", "d=", d);
+    }
+    printf("\n");
+    for(size_t c = 0; c < sizeof(configs) / sizeof(configs[0]); c++) {
+        char name[32];
+        snprintf(name, sizeof(name), "%s %s", configs[c].leibniz ? "Leibniz" : "Basel", accel_mode_name(configs[c].mode));
+        printf("%-16s", name);
+        for(int d = 4; d <= 14; d += 2) {
+            // the windowed transforms cost a full table per term, they never need many terms anyway
+            uint32_t limit = (configs[c].mode == SERIES_ACCEL_NONE) ? maxTerms : 1000000;
+            uint32_t terms = bench_accel_terms(configs[c].leibniz, configs[c].mode, 0.5 * pow(10.0, -d), limit);
+            if(terms == 0) {
+                printf(" %12s", "-");
+            } else {
+                printf(" %12u", (unsigned)terms);
+            }
+        }
+        printf("\n");
+    }
+    return 0;
+}
+
+// Relative error in bits below 1, i.e. how many mantissa bits are right
+static double bench_bits(long double value, long double reference) {
+    long double error = fabsl(value - reference);
+    if(error == 0.0L) {
+        return 64.0;
+    }
+    return -log2((double)(error / fabsl(reference)));
+}
+
+static long double bench_series_long_double(bool leibniz, uint32_t terms) {
+    long double sum = 0.0L;
+    for(uint32_t k = 0; k < terms; k++) {
+        if(leibniz) {
+            long double term = 1.0L / (2.0L * k + 1.0L);
+            sum += (k & 1) ? -term : term;
+        } else {
+            long double d = (long double)k + 1.0L;
+            sum += 1.0L / (d * d);
+        }
+    }
+    return sum;
+}
+
+static int bench_ff(int argc, char** argv) {
+    uint32_t maxTerms = (argc > 0) ? (uint32_t)strtoul(argv[0], NULL, 10) : 10000000;
+
+    // the operations against long double on random operands
+    static const char* opNames[] = {"add", "mul", "div", "recip", "sqrt"};
+    double worst[5] = {64.0, 64.0, 64.0, 64.0, 64.0};
+    srand(1);
+    for(int i = 0; i < 100000; i++) {
+        double x = ldexp((double)rand() / RAND_MAX + 0.5, rand() % 40 - 20);
+        double y = ldexp((double)rand() / RAND_MAX + 0.5, rand() % 40 - 20);
+        ff_t a = ff_from_double(x);
+        ff_t b = ff_from_double(y);
+        long double la = ff_to_long_double(a);
+        long double lb = ff_to_long_double(b);
+        double bits[5] = {
+            bench_bits(ff_to_long_double(ff_add(a, b)), la + lb),
+            bench_bits(ff_to_long_double(ff_mul(a, b)), la * lb),
+            bench_bits(ff_to_long_double(ff_div(a, b)), la / lb),
+            bench_bits(ff_to_long_double(ff_recip(b)), 1.0L / lb),
+            bench_bits(ff_to_long_double(ff_sqrt(a)), sqrtl(la)),
+        };
+        for(int op = 0; op < 5; op++) {
+            if(bits[op] < worst[op]) {
+                worst[op] = bits[op];
+            }
+        }
+    }
+    printf("float-float vs long double, worst correct bits over 100000 random operands (fma %s)\n",
+           FF_HAS_FMA ? "fused" : "split");
+    for(int op = 0; op < 5; op++) {
+        printf("  %-6s %5.1f\n", opNames[op], worst[op]);
+    }
+
+    printf("\n%-8s %10s %12s %12s %12s %12s %10s\n", "series", "terms", "double c/t", "ff c/t",
+           "double bits", "ff bits", "ff pi err");
+    for(int leibniz = 1; leibniz >= 0; leibniz--) {
+        for(uint32_t terms = 1000; terms <= maxTerms; terms *= 10) {
+            long double reference = bench_series_long_double(leibniz, terms);
+            uint64_t start = picalc_cycle_count();
+            double d = leibniz ? series_leibniz_double(0.0, 0, terms) : series_basel_double(0.0, 1, terms);
+            uint64_t doubleCycles = picalc_cycle_count() - start;
+            start = picalc_cycle_count();
+            ff_t f = leibniz ? series_leibniz_ff(ff_from_float(0.0f), 0, terms) : series_basel_ff(ff_from_float(0.0f), 1, terms);
+            uint64_t ffCycles = picalc_cycle_count() - start;
+            double ffPi = leibniz ? 4.0 * ff_to_double(f) : sqrt(6.0 * ff_to_double(f));
+            double doubleBits = bench_bits(d, reference);
+            double ffBits = bench_bits(ff_to_long_double(f), reference);
+            printf("%-8s %10u %12.1f %12.1f %12.1f %12.1f %10.2e\n", leibniz ? "Leibniz" : "Basel", (unsigned)terms,
+                   (double)doubleCycles / terms, (double)ffCycles / terms, doubleBits, ffBits, fabs(ffPi - M_PI));
+        }
+    }
+    return 0;
+}
+
+typedef struct {
+    seriesSimd_t backend;
+    ff_t (*leibnizFf)(ff_t sum, uint64_t start, uint32_t count);
+    ff_t (*baselFf)(ff_t sum, uint64_t start, uint32_t count);
+    double (*leibnizDouble)(double sum, uint64_t start, uint32_t count);
+    double (*baselDouble)(double sum, uint64_t start, uint32_t count);
+} benchSimdKernels_t;
+
+static const benchSimdKernels_t benchSimdKernels[] = {
+    {SERIES_SIMD_SCALAR, series_leibniz_ff_scalar4, series_basel_ff_scalar4, series_leibniz_double_scalar4, series_basel_double_scalar4},
+#if SERIES_SIMD_HAS_X86
+    {SERIES_SIMD_SSE2, series_leibniz_ff_sse2, series_basel_ff_sse2, series_leibniz_double_sse2, series_basel_double_sse2},
+    {SERIES_SIMD_AVX2, series_leibniz_ff_avx2, series_basel_ff_avx2, series_leibniz_double_avx2, series_basel_double_avx2},
+#endif
+};
+
+static int bench_simd(int argc, char** argv) {
+    uint32_t terms = (argc > 0) ? (uint32_t)strtoul(argv[0], NULL, 10) : 4000000;
+    printf("compiled back end: %s, %u terms per series\n", series_simd_name(SERIES_SIMD), (unsigned)terms);
+    printf("%-8s %-8s %6s %12s %12s %12s %12s\n", "back end", "series", "lanes", "ff Mt/s", "ff bits",
+           "double Mt/s", "double bits");
+    for(int leibniz = 1; leibniz >= 0; leibniz--) {
+        long double reference = bench_series_long_double(leibniz, terms);
+        uint32_t start = leibniz ? 0 : 1;
+
+        // the one term at a time kernels of picalc_series.h as the baseline
+        double t0 = bench_seconds();
+        ff_t f = leibniz ? series_leibniz_ff(ff_from_float(0.0f), start, terms) : series_basel_ff(ff_from_float(0.0f), start, terms);
+        double ffTime = bench_seconds() - t0;
+        t0 = bench_seconds();
+        double d = leibniz ? series_leibniz_double(0.0, start, terms) : series_basel_double(0.0, start, terms);
+        double doubleTime = bench_seconds() - t0;
+        printf("%-8s %-8s %6u %12.1f %12.1f %12.1f %12.1f\n", "series", leibniz ? "Leibniz" : "Basel", 1u,
+               terms / ffTime * 1e-6, bench_bits(ff_to_long_double(f), reference),
+               terms / doubleTime * 1e-6, bench_bits(d, reference));
+
+        for(size_t i = 0; i < sizeof(benchSimdKernels) / sizeof(benchSimdKernels[0]); i++) {
+            const benchSimdKernels_t* k = &benchSimdKernels[i];
+            if(!series_simd_available(k->backend)) {
+                printf("%-8s not supported by this CPU\n", series_simd_name(k->backend));
+                continue;
+            }
+            t0 = bench_seconds();
+            f = leibniz ? k->leibnizFf(ff_from_float(0.0f), start, terms) : k->baselFf(ff_from_float(0.0f), start, terms);
+            ffTime = bench_seconds() - t0;
+            t0 = bench_seconds();
+            d = leibniz ? k->leibnizDouble(0.0, start, terms) : k->baselDouble(0.0, start, terms);
+            doubleTime = bench_seconds() - t0;
+            double ffBits = bench_bits(ff_to_long_double(f), reference);
+            double doubleBits = bench_bits(d, reference);
+            printf("%-8s %-8s %6u %12.1f %12.1f %12.1f %12.1f\n", series_simd_name(k->backend), leibniz ? "Leibniz" : "Basel",
+                   (unsigned)series_simd_lanes(k->backend), terms / ffTime * 1e-6, ffBits, terms / doubleTime * 1e-6, doubleBits);
+        }
+    }
+    return 0;
+}
+
+static int bench_fixed(int argc, char** argv) {
+    uint32_t maxTerms = (argc > 0) ? (uint32_t)strtoul(argv[0], NULL, 10) : 10000000;
+    printf("%-8s %10s %10s %10s %12s %10s %10s\n", "series", "terms", "fixed c/t", "double c/t",
+           "width", "certified", "string");
+    for(int leibniz = 1; leibniz >= 0; leibniz--) {
+        seriesFixed_t fixed;
+        series_fixed_init(&fixed);
+        for(uint32_t terms = 1000; terms <= maxTerms; terms *= 10) {
+            // continue the running sum up to the next decade, like the tasks do
+            uint32_t count = terms - fixed.terms;
+            uint64_t start = picalc_cycle_count();
+            if(leibniz) {
+                series_leibniz_fixed(&fixed, count);
+            } else {
+                series_basel_fixed(&fixed, count);
+            }
+            uint64_t fixedCycles = picalc_cycle_count() - start;
+            start = picalc_cycle_count();
+            double d = leibniz ? series_leibniz_double(0.0, 0, count) : series_basel_double(0.0, 1, count);
+            uint64_t doubleCycles = picalc_cycle_count() - start;
+            (void)d;
+
+            uint64_t lo, hi;
+            if(leibniz) {
+                series_leibniz_fixed_pi(&fixed, &lo, &hi);
+            } else {
+                series_basel_fixed_pi(&fixed, &lo, &hi);
+            }
+            uint32_t certified = series_fixed_certified_digits(lo, hi);
+            // what a string compare of the midpoint would claim
+            char calc[32], ref[32];
+            snprintf(calc, sizeof(calc), "%.15f", series_fixed_to_double(lo / 2 + hi / 2));
+            snprintf(ref, sizeof(ref), "%.15f", M_PI);
+            uint32_t string = 0;
+            while(calc[2 + string] != '\0' && calc[2 + string] == ref[2 + string]) {
+                string++;
+            }
+            printf("%-8s %10u %10.1f %10.1f %12.3e %10u %10u\n", leibniz ? "Leibniz" : "Basel", (unsigned)terms,
+                   (double)fixedCycles / count, (double)doubleCycles / count,
+                   series_fixed_to_double(hi - lo), (unsigned)certified, (unsigned)string);
+        }
+    }
+    return 0;
+}
+
+static int bench_sum(int argc, char** argv) {
+    uint32_t maxTerms = (argc > 0) ? (uint32_t)strtoul(argv[0], NULL, 10) : 100000000;
+    const long double pi = 3.14159265358979323846264338327950288L;
+    printf("rounding error against a reverse long double sum, truncation error of the series itself\n");
+    printf("%-8s %10s %-9s %8s %12s %7s %6s %12s\n", "series", "terms", "mode", "c/t", "rounding",
+           "digits", "gain", "truncation");
+    for(int leibniz = 1; leibniz >= 0; leibniz--) {
+        for(uint32_t terms = 10000; terms <= maxTerms; terms *= 10) {
+            long double reference = 0.0L;
+            for(uint32_t k = terms; k > 0; k--) {
+                if(leibniz) {
+                    long double term = 1.0L / (2.0L * (k - 1) + 1.0L);
+                    reference += ((k - 1) & 1) ? -term : term;
+                } else {
+                    reference += 1.0L / ((long double)k * (long double)k);
+                }
+            }
+            long double limit = leibniz ? pi / 4.0L : pi * pi / 6.0L;
+            double naiveDigits = 0.0;
+            for(int mode = 0; mode < SERIES_SUM_MODES; mode++) {
+                seriesDouble_t sum;
+                series_double_init(&sum, (seriesSumMode_t)mode);
+                uint64_t start = picalc_cycle_count();
+                if(leibniz) {
+                    series_leibniz_sum(&sum, terms);
+                } else {
+                    series_basel_sum(&sum, terms);
+                }
+                uint64_t cycles = picalc_cycle_count() - start;
+                long double error = fabsl((long double)series_double_value(&sum) - reference);
+                double digits = (error == 0.0L) ? 19.0 : -log10((double)(error / reference));
+                if(mode == SERIES_SUM_NAIVE) {
+                    naiveDigits = digits;
+                }
+                printf("%-8s %10u %-9s %8.1f %12.3e %7.2f %+6.2f %12.3e\n", leibniz ? "Leibniz" : "Basel",
+                       (unsigned)terms, series_sum_mode_name((seriesSumMode_t)mode), (double)cycles / terms,
+                       (double)error, digits, digits - naiveDigits, (double)fabsl(limit - reference));
+            }
+        }
+    }
+    return 0;
+}
+
+// Same layout as piResult_t of the firmware
+typedef struct {
+    double piValue;
+    double piAccelerated;
+    uint32_t tickCount;
+    uint32_t iterations;
+    uint32_t digits;
+} benchResult_t;
+
+#define BENCH_QUEUE_LENGTH  100
+
+// Stand-in for the 100 deep FreeRTOS queue: every send and receive is a critical section
+typedef struct {
+    pthread_mutex_t lock;
+    benchResult_t items[BENCH_QUEUE_LENGTH];
+    uint32_t count;
+} benchQueue_t;
+
+typedef struct {
+    bool useMailbox;
+    uint32_t publishTerms;
+    int64_t publishUs;
+    atomic_bool stop;
+    benchQueue_t queue;
+    mailbox_t mailbox;
+    benchResult_t mailboxStorage;
+    uint64_t terms;
+    uint64_t publishes;
+    uint64_t reads;
+} benchPublish_t;
+
+static void* bench_publish_reader(void* arg) {
+    benchPublish_t* b = (benchPublish_t*)arg;
+    benchResult_t result;
+    uint32_t sequence = 0;
+    // controlTask polls every 10 ms
+    while(!atomic_load(&b->stop)) {
+        if(b->useMailbox) {
+            b->reads += mailbox_read(&b->mailbox, &result, &sequence);
+        } else {
+            pthread_mutex_lock(&b->queue.lock);
+            if(b->queue.count > 0) {
+                result = b->queue.items[0];
+                b->queue.count = 0;
+                b->reads++;
+            }
+            pthread_mutex_unlock(&b->queue.lock);
+        }
+        struct timespec delay = {0, 10000000};
+        nanosleep(&delay, NULL);
+    }
+    return NULL;
+}
+
+static void bench_publish_writer(benchPublish_t* b, double seconds) {
+    benchResult_t result = {0};
+    ff_t sum = ff_from_float(0.0f);
+    uint32_t k = 0;
+    uint32_t published = 0;
+    int64_t start = picalc_time_us();
+    int64_t publishTime = start;
+    int64_t end = start + (int64_t)(seconds * 1e6);
+    for(;;) {
+        if(b->useMailbox) {
+            sum = series_leibniz_ff(sum, k, 1000);
+            k += 1000;
+            int64_t now = picalc_time_us();
+            if(k - published >= b->publishTerms || now - publishTime >= b->publishUs) {
+                result.piValue = 4.0 * ff_to_double(sum);
+                result.piAccelerated = result.piValue;
+                result.iterations = k;
+                mailbox_publish(&b->mailbox, &result);
+                b->publishes++;
+                published = k;
+                publishTime = now;
+                if(now >= end) {
+                    break;
+                }
+            }
+        } else {
+            // what leibnizTask did: one term, then xQueueSendToFront
+            sum = series_leibniz_ff(sum, k, 1);
+            k++;
+            result.piValue = 4.0 * ff_to_double(sum);
+            result.piAccelerated = result.piValue;
+            result.iterations = k;
+            pthread_mutex_lock(&b->queue.lock);
+            if(b->queue.count < BENCH_QUEUE_LENGTH) {
+                memmove(&b->queue.items[1], &b->queue.items[0], b->queue.count * sizeof(benchResult_t));
+                b->queue.items[0] = result;
+                b->queue.count++;
+            }
+            pthread_mutex_unlock(&b->queue.lock);
+            b->publishes++;
+            if((k & 0xFFF) == 0 && picalc_time_us() >= end) {
+                break;
+            }
+        }
+    }
+    b->terms = k;
+}
+
+static int bench_publish(int argc, char** argv) {
+    double seconds = (argc > 0) ? atof(argv[0]) : 1.0;
+    uint32_t publishTerms = (argc > 1) ? (uint32_t)strtoul(argv[1], NULL, 10) : 100000;
+    int64_t publishUs = (argc > 2) ? strtoll(argv[2], NULL, 10) : 20000;
+    printf("%-28s %14s %12s %10s\n", "publishing", "terms/s", "publishes", "reads");
+    for(int useMailbox = 0; useMailbox <= 1; useMailbox++) {
+        benchPublish_t* b = calloc(1, sizeof(benchPublish_t));
+        if(b == NULL) {
+            return 1;
+        }
+        b->useMailbox = useMailbox;
+        b->publishTerms = publishTerms;
+        b->publishUs = publishUs;
+        atomic_init(&b->stop, false);
+        pthread_mutex_init(&b->queue.lock, NULL);
+        mailbox_init(&b->mailbox, &b->mailboxStorage, sizeof(benchResult_t));
+        pthread_t reader;
+        pthread_create(&reader, NULL, bench_publish_reader, b);
+        double start = bench_seconds();
+        bench_publish_writer(b, seconds);
+        double elapsed = bench_seconds() - start;
+        atomic_store(&b->stop, true);
+        pthread_join(reader, NULL);
+        printf("%-28s %14.0f %12llu %10llu\n", useMailbox ? "mailbox, batched" : "queue per term",
+               b->terms / elapsed, (unsigned long long)b->publishes, (unsigned long long)b->reads);
+        pthread_mutex_destroy(&b->queue.lock);
+        free(b);
+    }
+    return 0;
+}
+
+static int bench_parallel(int argc, char** argv) {
+    uint32_t terms = (argc > 0) ? (uint32_t)strtoul(argv[0], NULL, 10) : 20000000;
+    uint32_t maxWorkers = (argc > 1) ? (uint32_t)strtoul(argv[1], NULL, 10) : 2 * picalc_core_count();
+    if(maxWorkers > SERIES_PARALLEL_CHUNKS) {
+        maxWorkers = SERIES_PARALLEL_CHUNKS;
+    }
+    printf("%u terms per run, %u cores\n", (unsigned)terms, (unsigned)picalc_core_count());
+    printf("%-8s %-12s %-12s %8s %14s %8s  %s\n", "series", "format", "split", "workers", "terms/s", "speedup", "bits");
+    for(int kind = SERIES_LEIBNIZ; kind <= SERIES_BASEL; kind++) {
+        for(int format = SERIES_FORMAT_DOUBLE; format <= SERIES_FORMAT_FLOAT; format++) {
+            double reference = 0.0;
+            double baseRate = 0.0;
+            for(int split = SERIES_SPLIT_BLOCKED; split <= SERIES_SPLIT_INTERLEAVED; split++) {
+                for(uint32_t workers = 1; workers <= maxWorkers; workers *= 2) {
+                    series_t series;
+                    series_init(&series, (seriesKind_t)kind, (seriesFormat_t)format, SERIES_SUM_NEUMAIER);
+                    double start = bench_seconds();
+                    double value = series_advance_parallel(&series, terms, workers, (seriesSplit_t)split);
+                    double elapsed = bench_seconds() - start;
+                    bool first = (split == SERIES_SPLIT_BLOCKED && workers == 1);
+                    if(first) {
+                        reference = value;
+                        baseRate = terms / elapsed;
+                    }
+                    bool same = memcmp(&value, &reference, sizeof(double)) == 0;
+                    printf("%-8s %-12s %-12s %8u %14.0f %8.2f  %s\n", kind == SERIES_LEIBNIZ ? "Leibniz" : "Basel",
+                           series_format_name((seriesFormat_t)format), split == SERIES_SPLIT_BLOCKED ? "blocked" : "interleaved",
+                           (unsigned)workers, terms / elapsed, terms / elapsed / baseRate, same ? "same" : "DIFFERENT");
+                }
+            }
+        }
+    }
+    return 0;
+}
+
+// Item i costs about i * 64 terms, the first half of the range is far cheaper than the second
+#define BENCH_UNEVEN_ITEMS  2048
+
+typedef struct {
+    double result[BENCH_UNEVEN_ITEMS];
+} benchUneven_t;
+
+static void bench_uneven_range(void* arg, uint32_t begin, uint32_t end) {
+    benchUneven_t* u = (benchUneven_t*)arg;
+    for(uint32_t i = begin; i < end; i++) {
+        u->result[i] = series_leibniz_double(0.0, 0, i * 64);
+    }
+}
+
+static void bench_uneven_static(void* arg, uint32_t worker, uint32_t workers) {
+    bench_uneven_range(arg, worker * BENCH_UNEVEN_ITEMS / workers, (worker + 1) * BENCH_UNEVEN_ITEMS / workers);
+}
+
+static int bench_executor(int argc, char** argv) {
+    uint32_t maxWorkers = (argc > 0) ? (uint32_t)strtoul(argv[0], NULL, 10) : picalc_core_count();
+    if(maxWorkers > EXECUTOR_MAX_WORKERS) {
+        maxWorkers = EXECUTOR_MAX_WORKERS;
+    }
+    benchUneven_t* u = malloc(sizeof(benchUneven_t));
+    if(u == NULL) {
+        return 1;
+    }
+
+    printf("uneven items (cost grows with the index), static blocked split vs work stealing\n");
+    printf("%8s %12s %12s  %s\n", "workers", "static[ms]", "stealing[ms]", "per worker executed/stolen");
+    for(uint32_t workers = 1; workers <= maxWorkers; workers *= 2) {
+        double start = bench_seconds();
+        picalc_parallel_run(bench_uneven_static, u, workers);
+        double staticTime = bench_seconds() - start;
+
+        executor_t* ex = malloc(sizeof(executor_t));
+        if(ex == NULL) {
+            abort();
+        }
+        executor_init(ex, workers, 1);
+        memset(u, 0, sizeof(benchUneven_t));
+        start = bench_seconds();
+        executor_parallel_for(ex, 0, BENCH_UNEVEN_ITEMS, 16, bench_uneven_range, u);
+        double stealTime = bench_seconds() - start;
+        printf("%8u %12.2f %12.2f ", (unsigned)workers, staticTime * 1000.0, stealTime * 1000.0);
+        for(uint32_t w = 0; w < workers; w++) {
+            printf(" %u/%u", (unsigned)ex->stats[w].executed, (unsigned)ex->stats[w].stolen);
+        }
+        printf("\n");
+        executor_shutdown(ex);
+        free(ex);
+    }
+    free(u);
+    return 0;
+}
+
+// Every registered engine in turn, one slice each like the race workers on the board
+static int bench_race(int argc, char** argv) {
+    double seconds = (argc > 0) ? strtod(argv[0], NULL) : 2.0;
+    int64_t sliceUs = (argc > 1) ? strtoll(argv[1], NULL, 10) : 10000;
+    piAlgoConfig_t config = {SERIES_FORMAT_FF, SERIES_SUM_NEUMAIER, SERIES_ACCEL_NONE, 1, SERIES_SPLIT_BLOCKED, NULL, 1, 0};
+    void* states[PI_ALGO_COUNT];
+    uint32_t batch[PI_ALGO_COUNT];
+    int64_t busyUs[PI_ALGO_COUNT];
+    uint64_t cycles[PI_ALGO_COUNT];
+    for(uint32_t id = 0; id < PI_ALGO_COUNT; id++) {
+        states[id] = algo_create(&piAlgos[id], &config);
+        batch[id] = piAlgos[id].batch;
+        busyUs[id] = 0;
+        cycles[id] = 0;
+    }
+    int64_t end = picalc_time_us() + (int64_t)(seconds * 1e6);
+    while(picalc_time_us() < end) {
+        for(uint32_t id = 0; id < PI_ALGO_COUNT; id++) {
+            uint64_t cycleStart = picalc_cycle_count();
+            int64_t start = picalc_time_us();
+            piAlgos[id].step(states[id], batch[id]);
+            int64_t elapsed = picalc_time_us() - start;
+            cycles[id] += picalc_cycle_count() - cycleStart;
+            busyUs[id] += elapsed;
+            batch[id] = algo_next_batch(batch[id], elapsed, sliceUs);
+        }
+    }
+
+    printf("%.1f s round robin, %lld us slices\n", seconds, (long long)sliceUs);
+    printf("%-12s %14s %12s %12s %20s %12s %12s\n", "engine", "count", "count/s", "cycles/count", "estimate", "error", "bound");
+    for(uint32_t id = 0; id < PI_ALGO_COUNT; id++) {
+        const piAlgo_t* algo = &piAlgos[id];
+        double estimate = algo->estimate(states[id]);
+        double bound = algo->error_bound(states[id]);
+        double error = fabs(estimate - M_PI);
+        uint64_t count = algo->count(states[id]);
+        printf("%-12s %14llu %12.3e %12.2f %20.15f %12.2e %12.2e\n", algo->name, (unsigned long long)count,
+               count / (busyUs[id] * 1e-6), (double)cycles[id] / count, estimate, error, bound);
+        free(states[id]);
+    }
+    return 0;
+}
+
+// Digits the sprintf compare of the estimate against M_PI claims, the way the digits were counted
+// before the intervals
+static uint32_t bench_string_digits(double estimate) {
+    char calc[32], ref[32];
+    snprintf(calc, sizeof(calc), "%.15f", estimate);
+    snprintf(ref, sizeof(ref), "%.15f", M_PI);
+    uint32_t digits = 0;
+    while(calc[2 + digits] != '\0' && calc[2 + digits] == ref[2 + digits]) {
+        digits++;
+    }
+    return digits;
+}
+
+// Digits proven by the interval of every engine and mode, and what algo_digits costs next to the
+// sprintf compare. Monte-Carlo is left out, its interval is a confidence interval.
+static int bench_certify(int argc, char** argv) {
+    uint64_t maxCount = (argc > 0) ? strtoull(argv[0], NULL, 10) : 10000000;
+    static const struct {
+        piAlgoId_t id;
+        seriesFormat_t format;
+        seriesAccel_t accel;
+        uint32_t digitTarget;       // adaptive only, where it widens along the run
+    } modes[] = {
+        {PI_ALGO_LEIBNIZ, SERIES_FORMAT_DOUBLE, SERIES_ACCEL_NONE, 0},
+        {PI_ALGO_LEIBNIZ, SERIES_FORMAT_FLOAT, SERIES_ACCEL_NONE, 0},
+        {PI_ALGO_LEIBNIZ, SERIES_FORMAT_FF, SERIES_ACCEL_NONE, 0},
+        {PI_ALGO_LEIBNIZ, SERIES_FORMAT_FIXED, SERIES_ACCEL_NONE, 0},
+        {PI_ALGO_LEIBNIZ, SERIES_FORMAT_FF, SERIES_ACCEL_EULER, 0},
+        {PI_ALGO_LEIBNIZ, SERIES_FORMAT_FIXED, SERIES_ACCEL_EULER, 0},
+        {PI_ALGO_LEIBNIZ, SERIES_FORMAT_FF, SERIES_ACCEL_WYNN, 0},
+        {PI_ALGO_LEIBNIZ, SERIES_FORMAT_ADAPTIVE, SERIES_ACCEL_NONE, 3},
+        {PI_ALGO_LEIBNIZ, SERIES_FORMAT_ADAPTIVE, SERIES_ACCEL_NONE, 8},
+        {PI_ALGO_LEIBNIZ, SERIES_FORMAT_ADAPTIVE, SERIES_ACCEL_EULER, 12},
+        {PI_ALGO_BASEL, SERIES_FORMAT_DOUBLE, SERIES_ACCEL_NONE, 0},
+        {PI_ALGO_BASEL, SERIES_FORMAT_FLOAT, SERIES_ACCEL_NONE, 0},
+        {PI_ALGO_BASEL, SERIES_FORMAT_FIXED, SERIES_ACCEL_NONE, 0},
+        {PI_ALGO_BASEL, SERIES_FORMAT_FF, SERIES_ACCEL_EULER_MACLAURIN, 0},
+        {PI_ALGO_BASEL, SERIES_FORMAT_ADAPTIVE, SERIES_ACCEL_NONE, 3},
+        {PI_ALGO_BASEL, SERIES_FORMAT_ADAPTIVE, SERIES_ACCEL_EULER_MACLAURIN, 10},
+        {PI_ALGO_NILAKANTHA, SERIES_FORMAT_DOUBLE, SERIES_ACCEL_NONE, 0},
+        {PI_ALGO_WALLIS, SERIES_FORMAT_DOUBLE, SERIES_ACCEL_NONE, 0},
+        {PI_ALGO_VIETE, SERIES_FORMAT_DOUBLE, SERIES_ACCEL_NONE, 0},
+        {PI_ALGO_RAMANUJAN, SERIES_FORMAT_DOUBLE, SERIES_ACCEL_NONE, 0},
+    };
+    printf("most digits over the steps up to %llu terms, the sprintf compare of the estimate at the same step\n",
+           (unsigned long long)maxCount);
+    printf("%-12s %-12s %-5s %7s %12s %9s %7s %12s %12s\n", "engine", "format", "accel", "steps", "count",
+           "certified", "string", "cy/digits", "cy/sprintf");
+    for(size_t m = 0; m < sizeof(modes) / sizeof(modes[0]); m++) {
+        const piAlgo_t* algo = &piAlgos[modes[m].id];
+        piAlgoConfig_t config = {modes[m].format, SERIES_SUM_NEUMAIER, modes[m].accel, 1, SERIES_SPLIT_BLOCKED, NULL, 1,
+                                 modes[m].digitTarget};
+        void* state = algo_create(algo, &config);
+        uint64_t digitCycles = 0;
+        uint64_t stringCycles = 0;
+        uint32_t steps = 0;
+        uint32_t best = 0;
+        uint32_t bestString = 0;
+        uint64_t bestCount = 0;
+        // the batches grow 2x per step up to ALGO_MAX_BATCH, the engines with a cap stop counting
+        uint32_t batch = 1;
+        uint64_t last = UINT64_MAX;
+        while(algo->count(state) < maxCount && algo->count(state) != last) {
+            last = algo->count(state);
+            algo->step(state, batch);
+            steps++;
+            batch = (batch < ALGO_MAX_BATCH) ? batch * 2 : ALGO_MAX_BATCH;
+
+            uint64_t start = picalc_cycle_count();
+            uint32_t certified = algo_digits(algo, state);
+            digitCycles += picalc_cycle_count() - start;
+            double estimate = (algo->accelerated != NULL) ? algo->accelerated(state) : algo->estimate(state);
+            start = picalc_cycle_count();
+            uint32_t string = bench_string_digits(estimate);
+            stringCycles += picalc_cycle_count() - start;
+            if(certified > best) {
+                best = certified;
+                bestString = string;
+                bestCount = algo->count(state);
+            }
+        }
+        printf("%-12s %-12s %-5s %7u %12llu %9u %7u %12.0f %12.0f\n", algo->name, series_format_name(modes[m].format),
+               accel_mode_name(modes[m].accel), (unsigned)steps, (unsigned long long)bestCount, (unsigned)best,
+               (unsigned)bestString, (double)digitCycles / steps, (double)stringCycles / steps);
+        free(state);
+    }
+    return 0;
+}
+
+// Time to a digit target in each fixed format and adaptive, which starts on float and widens
+// only as far as the target needs. An engine stops at the first target no format reaches.
+static int bench_adaptive(int argc, char** argv) {
+    uint32_t maxDigits = (argc > 0) ? (uint32_t)strtoul(argv[0], NULL, 10) : ALGO_MAX_DIGITS;
+    uint64_t maxCount = (argc > 1) ? strtoull(argv[1], NULL, 10) : 20000000;
+    static const struct {
+        piAlgoId_t id;
+        seriesAccel_t accel;
+    } engines[] = {
+        {PI_ALGO_LEIBNIZ, SERIES_ACCEL_NONE},
+        {PI_ALGO_LEIBNIZ, SERIES_ACCEL_EULER},
+        {PI_ALGO_BASEL, SERIES_ACCEL_NONE},
+        {PI_ALGO_BASEL, SERIES_ACCEL_EULER_MACLAURIN},
+    };
+    static const seriesFormat_t formats[] = {SERIES_FORMAT_FLOAT, SERIES_FORMAT_FF, SERIES_FORMAT_FIXED, SERIES_FORMAT_ADAPTIVE};
+    printf("ms to the target, - if the format cannot prove it within %llu terms\n", (unsigned long long)maxCount);
+    printf("%-12s %-5s %6s", "engine", "accel", "digits");
+    for(size_t f = 0; f < sizeof(formats) / sizeof(formats[0]); f++) {
+        printf(" %12s", series_format_name(formats[f]));
+    }
+    printf("\n");
+    for(size_t e = 0; e < sizeof(engines) / sizeof(engines[0]); e++) {
+        const piAlgo_t* algo = &piAlgos[engines[e].id];
+        bool any = true;
+        for(uint32_t digits = 1; digits <= maxDigits && any; digits++) {
+            double best = INFINITY;
+            double adaptive = INFINITY;
+            printf("%-12s %-5s %6u", algo->name, accel_mode_name(engines[e].accel), (unsigned)digits);
+            for(size_t f = 0; f < sizeof(formats) / sizeof(formats[0]); f++) {
+                piAlgoConfig_t config = {formats[f], SERIES_SUM_NEUMAIER, engines[e].accel, 1, SERIES_SPLIT_BLOCKED, NULL, 1,
+                                         digits};
+                void* state = algo_create(algo, &config);
+                uint32_t batch = 1;
+                bool reached = false;
+                double start = bench_seconds();
+                while(algo->count(state) < maxCount && !reached) {
+                    algo->step(state, batch);
+                    batch = (batch < ALGO_MAX_BATCH) ? batch * 2 : ALGO_MAX_BATCH;
+                    reached = algo_digits(algo, state) >= digits;
+                }
+                double elapsed = bench_seconds() - start;
+                free(state);
+                if(!reached) {
+                    printf(" %12s", "-");
+                    continue;
+                }
+                printf(" %12.3f", elapsed * 1e3);
+                if(formats[f] == SERIES_FORMAT_ADAPTIVE) {
+                    adaptive = elapsed;
+                } else if(elapsed < best) {
+                    best = elapsed;
+                }
+            }
+            printf("\n");
+            any = !isinf(best) || !isinf(adaptive);
+        }
+    }
+    return 0;
+}
+
+// Steps with batches doubling from 1 until the engine reaches digits, from wherever it stands
+static void bench_step_to(const piAlgo_t* algo, void* state, uint32_t* batch, uint32_t digits, uint64_t maxCount) {
+    while(algo_digits(algo, state) < digits && algo->count(state) < maxCount) {
+        algo->step(state, *batch);
+        *batch = (*batch < ALGO_MAX_BATCH) ? *batch * 2 : ALGO_MAX_BATCH;
+    }
+}
+
+// Raising the target after a finished run: the count of the extra terms a run restored from its
+// snapshot needs, next to a fresh run to the higher target. Engines that cannot reach a target
+// stop at maxCount.
+static int bench_resume(int argc, char** argv) {
+    uint32_t digits = (argc > 0) ? (uint32_t)strtoul(argv[0], NULL, 10) : 5;
+    uint64_t maxCount = (argc > 1) ? strtoull(argv[1], NULL, 10) : 20000000;
+    if(digits == 0 || digits >= ALGO_MAX_DIGITS) {
+        fprintf(stderr, "resume: digits must be 1..%u\n", (unsigned)ALGO_MAX_DIGITS - 1);
+        return 1;
+    }
+    printf("%u digits, then %u\n", (unsigned)digits, (unsigned)digits + 1);
+    printf("%-12s %14s %14s %14s %10s\n", "engine", "count first", "count resumed", "count fresh", "snapshot");
+    for(uint32_t id = 0; id < PI_ALGO_COUNT; id++) {
+        const piAlgo_t* algo = &piAlgos[id];
+        piAlgoConfig_t config = {SERIES_FORMAT_ADAPTIVE, SERIES_SUM_NEUMAIER, SERIES_ACCEL_NONE, 1, SERIES_SPLIT_BLOCKED, NULL, 1,
+                                 digits};
+        void* kept = algo_create(algo, &config);
+        void* restored = algo_create(algo, &config);
+        uint32_t batch = 1;
+        bench_step_to(algo, kept, &batch, digits, maxCount);
+        uint64_t first = algo->count(kept);
+        algoSnapshot_t snapshot;
+        algo_snapshot(algo, kept, &snapshot);
+        algo_restore(algo, restored, &snapshot);
+        config.digitTarget = digits + 1;
+        bench_step_to(algo, restored, &batch, digits + 1, maxCount);
+
+        void* fresh = algo_create(algo, &config);
+        batch = 1;
+        bench_step_to(algo, fresh, &batch, digits + 1, maxCount);
+        printf("%-12s %14llu %14llu %14llu %10u\n", algo->name, (unsigned long long)first,
+               (unsigned long long)(algo->count(restored) - first), (unsigned long long)algo->count(fresh),
+               (unsigned)snapshot.size);
+        free(kept);
+        free(restored);
+        free(fresh);
+    }
+    return 0;
+}
+
+// NOR flash in memory for the checkpoints: programs only clear bits and stay within a page, an
+// erase sets a sector
+#define BENCH_FLASH_PAGE    256
+#define BENCH_FLASH_SECTOR  4096
+
+typedef struct {
+    uint8_t memory[CHECKPOINT_SECTORS * BENCH_FLASH_SECTOR];
+} benchFlash_t;
+
+static bool bench_flash_read(void* context, uint32_t address, void* data, uint32_t size) {
+    benchFlash_t* flash = context;
+    memcpy(data, &flash->memory[address], size);
+    return true;
+}
+
+static bool bench_flash_prog(void* context, uint32_t address, const void* data, uint32_t size) {
+    benchFlash_t* flash = context;
+    for(uint32_t i = 0; i < size; i++) {
+        flash->memory[address + i] &= ((const uint8_t*)data)[i];
+    }
+    return true;
+}
+
+static bool bench_flash_erase(void* context, uint32_t address) {
+    benchFlash_t* flash = context;
+    memset(&flash->memory[address - address % BENCH_FLASH_SECTOR], 0xFF, BENCH_FLASH_SECTOR);
+    return true;
+}
+
+// Record sizes, then checkpoints through the writer task while the race runs: records, page
+// programs and erases, the longest write, and how long the scan at boot takes
+static int bench_checkpoint(int argc, char** argv) {
+    double seconds = (argc > 0) ? strtod(argv[0], NULL) : 1.0;
+    static benchFlash_t flash;
+    memset(flash.memory, 0xFF, sizeof(flash.memory));
+    checkpointFlash_t port = {&flash, bench_flash_read, bench_flash_prog, bench_flash_erase,
+                              BENCH_FLASH_PAGE, BENCH_FLASH_SECTOR, 0, sizeof(flash.memory)};
+    uint32_t mask = PI_ALGO_MASK(PI_ALGO_LEIBNIZ) | PI_ALGO_MASK(PI_ALGO_BASEL) | PI_ALGO_MASK(PI_ALGO_NILAKANTHA) |
+                    PI_ALGO_MASK(PI_ALGO_MONTE_CARLO);
+    piAlgoConfig_t config = {SERIES_FORMAT_ADAPTIVE, SERIES_SUM_NEUMAIER, SERIES_ACCEL_NONE, 1, SERIES_SPLIT_BLOCKED, NULL, 1, 0};
+
+    static race_t race;
+    static checkpoint_t checkpoint;
+    race_init(&race, &config, 1000, 100000);
+    race_start_workers(&race, 1, 3 * 2048);
+    if(!checkpoint_init(&checkpoint, &port, &race)) {
+        fprintf(stderr, "checkpoint: the region does not fit\n");
+        return 1;
+    }
+    printf("%-12s %8s %6s %6s\n", "engine", "record", "pages", "slots");
+    for(uint32_t id = 0; id < PI_ALGO_COUNT; id++) {
+        const checkpointEngine_t* engine = &checkpoint.engines[id];
+        printf("%-12s %8u %6u %6u\n", piAlgos[id].name,
+               (unsigned)(sizeof(checkpointHeader_t) + piAlgos[id].stateSize - piAlgos[id].runOffset),
+               (unsigned)(engine->slotSize / BENCH_FLASH_PAGE), (unsigned)(2 * engine->slots));
+    }
+    checkpoint_start_writer(&checkpoint, 20, 1, 3 * 2048, 0);
+    race_start(&race, mask, ALGO_MAX_DIGITS);
+    vTaskDelay(pdMS_TO_TICKS((uint32_t)(seconds * 1000)));
+    for(uint32_t id = 0; id < PI_ALGO_COUNT; id++) {
+        race.engines[id].running = false;
+    }
+    // the last step ends and the writer catches up
+    vTaskDelay(pdMS_TO_TICKS(200));
+    checkpointStats_t stats = checkpoint.stats;
+    printf("writer: %u records, %u page programs, %u erases, %u errors, %.3f ms longest write\n", (unsigned)stats.records,
+           (unsigned)stats.pagePrograms, (unsigned)stats.erases, (unsigned)stats.errors, stats.writeUsMax / 1e3);
+
+    static race_t rebooted;
+    static checkpoint_t reboot;
+    race_init(&rebooted, &config, 1000, 100000);
+    double start = bench_seconds();
+    checkpoint_init(&reboot, &port, &rebooted);
+    uint32_t restored = checkpoint_restore(&reboot);
+    double elapsed = bench_seconds() - start;
+    uint32_t engines = 0;
+    for(uint32_t id = 0; id < PI_ALGO_COUNT; id++) {
+        engines += (restored & PI_ALGO_MASK(id)) != 0;
+    }
+    printf("reboot: %u engines restored in %.3f ms\n", (unsigned)engines, elapsed * 1e3);
+    return 0;
+}
+
+// Samples per second over the lanes, with the error next to the interval the estimate claims
+static int bench_montecarlo(int argc, char** argv) {
+    uint32_t samples = (argc > 0) ? (uint32_t)strtoul(argv[0], NULL, 10) : 200000000;
+    uint32_t maxWorkers = (argc > 1) ? (uint32_t)strtoul(argv[1], NULL, 10) : picalc_core_count();
+    if(maxWorkers > MONTECARLO_MAX_LANES) {
+        maxWorkers = MONTECARLO_MAX_LANES;
+    }
+    montecarlo_t* mc = malloc(sizeof(montecarlo_t));
+    if(mc == NULL) {
+        abort();
+    }
+    printf("%u samples per run, %u cores, %.1f sigma interval\n", (unsigned)samples, (unsigned)picalc_core_count(), MONTECARLO_Z);
+    printf("%8s %14s %8s %20s %12s %12s %8s\n", "workers", "samples/s", "speedup", "estimate", "error", "half width", "digits");
+    double baseRate = 0.0;
+    for(uint32_t workers = 1; workers <= maxWorkers; workers *= 2) {
+        montecarlo_init(mc, 12345, workers);
+        double start = bench_seconds();
+        montecarlo_sample_parallel(mc, samples, NULL);
+        double elapsed = bench_seconds() - start;
+        if(workers == 1) {
+            baseRate = samples / elapsed;
+        }
+        double estimate = montecarlo_estimate(mc);
+        double width = montecarlo_half_width(mc);
+        double error = fabs(estimate - M_PI);
+        printf("%8u %14.0f %8.2f %20.15f %12.2e %12.2e %8u\n", (unsigned)workers, samples / elapsed, samples / elapsed / baseRate,
+               estimate, error, width, (unsigned)montecarlo_probable_digits(mc));
+    }
+    free(mc);
+    return 0;
+}
+
+// The headless sweep of the board, engine names select a subset
+static int bench_sweep(int argc, char** argv) {
+    sweepConfig_t sc;
+    sweep_default_config(&sc);
+    if(argc > 0) {
+        sc.maxDigits = (uint32_t)strtoul(argv[0], NULL, 10);
+    }
+    if(argc > 1) {
+        sc.repeats = (uint32_t)strtoul(argv[1], NULL, 10);
+    }
+    if(argc > 2) {
+        sc.timeoutUs = (int64_t)(strtod(argv[2], NULL) * 1e6);
+    }
+    if(argc > 3) {
+        sc.format = (strcmp(argv[3], "json") == 0) ? SWEEP_FORMAT_JSON : SWEEP_FORMAT_CSV;
+    }
+    if(argc > 4) {
+        sc.algos = 0;
+        for(int i = 4; i < argc; i++) {
+            piAlgoId_t id = algo_find(argv[i]);
+            if(id == PI_ALGO_COUNT) {
+                fprintf(stderr, "sweep: no engine %s\n", argv[i]);
+                return 1;
+            }
+            sc.algos |= PI_ALGO_MASK(id);
+        }
+    }
+    return sweep_run(&sc) ? 0 : 1;
+}
+
+typedef struct {
+    const char* name;
+    int (*run)(int argc, char** argv);
+    const char* usage;
+} benchEntry_t;
+
+static const benchEntry_t benchmarks[] = {
+    {"bigint", bench_bigint, "[maxLimbs] | tune [maxLimbs] | ntt [maxLimbs]"},
+    {"chudnovsky", bench_chudnovsky, "[maxDigits]"},
+    {"spigot", bench_spigot, "[maxDigits]"},
+    {"bbp", bench_bbp, "[position] [count]"},
+    {"machin", bench_machin, "[digits]"},
+    {"agm", bench_agm, "[digits]"},
+    {"accel", bench_accel, "[maxTerms]"},
+    {"ff", bench_ff, "[maxTerms]"},
+    {"fixed", bench_fixed, "[maxTerms]"},
+    {"sum", bench_sum, "[maxTerms]"},
+    {"publish", bench_publish, "[seconds] [publishTerms] [publishUs]"},
+    {"parallel", bench_parallel, "[terms] [maxWorkers]"},
+    {"executor", bench_executor, "[maxWorkers]"},
+    {"simd", bench_simd, "[terms]"},
+    {"race", bench_race, "[seconds] [sliceUs]"},
+    {"certify", bench_certify, "[maxCount]"},
+    {"adaptive", bench_adaptive, "[maxDigits] [maxCount]"},
+    {"resume", bench_resume, "[digits] [maxCount]"},
+    {"checkpoint", bench_checkpoint, "[seconds]"},
+    {"montecarlo", bench_montecarlo, "[samples] [maxWorkers]"},
+    {"sweep", bench_sweep, "[maxDigits] [repeats] [timeoutSeconds] [csv|json] [engine...]"},
+};
+
+int main(int argc, char** argv) {
+    size_t count = sizeof(benchmarks) / sizeof(benchmarks[0]);
+    if(argc >= 2) {
+        for(size_t i = 0; i < count; i++) {
+            if(strcmp(argv[1], benchmarks[i].name) == 0) {
+                return benchmarks[i].run(argc - 2, &argv[2]);
+            }
+        }
+    }
+    fprintf(stderr, "Usage: %s <benchmark> [args]\n", argv[0]);
+    for(size_t i = 0; i < count; i++) {
+        fprintf(stderr, "    %s %s\n", benchmarks[i].name, benchmarks[i].usage);
+    }
+    return 1;
+}
@@ -0,0 +1,185 @@
+/********************************************************************************************* */
+//    picalc command line
+//    The board's race and sweep on a Linux host, with the FreeRTOS calls going to the shim in
+//    host/. Meant for perf, the sanitizers and runs that are too long for the board.
+//
+//    Usage: picalc <command> [args]
+/********************************************************************************************* */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#include "picalc_race.h"
+#include "picalc_sweep.h"
+#include "picalc_chudnovsky.h"
+#include "picalc_machin.h"
+#include "picalc_agm.h"
+#include "picalc_ntt.h"
+#include "picalc_executor.h"
+#include "picalc_port.h"
+
+// Same slices as the board, the CLI polls the mailboxes like controlTask does
+#define CLI_SLICE_US        10000
+#define CLI_YIELD_US        50000
+#define CLI_POLL_MS         20
+
+static bool cli_parse_engines(const char* command, int argc, char** argv, uint32_t* mask) {
+    *mask = 0;
+    for(int i = 0; i < argc; i++) {
+        piAlgoId_t id = algo_find(argv[i]);
+        if(id == PI_ALGO_COUNT) {
+            fprintf(stderr, "%s: no engine %s\n", command, argv[i]);
+            return false;
+        }
+        *mask |= PI_ALGO_MASK(id);
+    }
+    if(*mask == 0) {
+        *mask = PI_ALGO_ALL;
+    }
+    return true;
+}
+
+static void cli_print_result(const raceEngine_t* engine) {
+    const piResult_t* r = &engine->result;
+    double rate = (r->elapsedUs > 0) ? (double)r->iterations * 1e6 / (double)r->elapsedUs : 0.0;
+    double cyclesPerCount = (r->iterations > 0) ? (double)r->cycles / (double)r->iterations : 0.0;
+    printf("%-12s %3u%c %.15f %10.3e %14llu %10.3f %10.3f %12.4g %10.1f\n", engine->algo->name, (unsigned)r->digits,
+           r->probable ? '~' : ' ', r->piAccelerated, r->errorBound, (unsigned long long)r->iterations,
+           (double)r->elapsedUs * 1e-6, (double)r->cpuUs * 1e-6, rate, cyclesPerCount);
+}
+
+// The race of the board: the engines of the mask run on the two shim workers until they reach
+// digits or the time is up
+static int cli_race(int argc, char** argv) {
+    uint32_t digits = (argc > 0) ? (uint32_t)strtoul(argv[0], NULL, 10) : 8;
+    double seconds = (argc > 1) ? strtod(argv[1], NULL) : 60.0;
+    uint32_t mask;
+    if(digits == 0 || digits > ALGO_MAX_DIGITS) {
+        fprintf(stderr, "race: digits must be 1..%u\n", (unsigned)ALGO_MAX_DIGITS);
+        return 1;
+    }
+    if(!cli_parse_engines("race", argc - 2, &argv[2], &mask)) {
+        return 1;
+    }
+
+    static race_t race;
+    piAlgoConfig_t config = {SERIES_FORMAT_ADAPTIVE, SERIES_SUM_NEUMAIER, SERIES_ACCEL_NONE, 1, SERIES_SPLIT_BLOCKED, NULL,
+                             picalc_random_seed(), 0};
+    race_init(&race, &config, CLI_SLICE_US, CLI_YIELD_US);
+    race_start_workers(&race, 1, 3 * 2048);
+    race_start(&race, mask, digits);
+
+    printf("%-12s %4s %-17s %10s %14s %10s %10s %12s %10s\n", "engine", "dig", "estimate", "bound", "count",
+           "time[s]", "cpu[s]", "count/s", "cy/count");
+    uint32_t pending = mask;
+    int64_t end = picalc_time_us() + (int64_t)(seconds * 1e6);
+    while(pending != 0 && picalc_time_us() < end) {
+        vTaskDelay(pdMS_TO_TICKS(CLI_POLL_MS));
+        for(uint32_t id = 0; id < PI_ALGO_COUNT; id++) {
+            if((pending & PI_ALGO_MASK(id)) && race_update(&race, (piAlgoId_t)id, digits)) {
+                pending &= ~PI_ALGO_MASK(id);
+                cli_print_result(&race.engines[id]);
+            }
+        }
+    }
+    // whoever did not make it, with the last published result
+    race_reset(&race);
+    for(uint32_t id = 0; id < PI_ALGO_COUNT; id++) {
+        if(pending & PI_ALGO_MASK(id)) {
+            printf("%-12s timed out\n", piAlgos[id].name);
+        }
+    }
+    return (pending == 0) ? 0 : 2;
+}
+
+static int cli_sweep(int argc, char** argv) {
+    sweepConfig_t sc;
+    sweep_default_config(&sc);
+    if(argc > 0) {
+        sc.maxDigits = (uint32_t)strtoul(argv[0], NULL, 10);
+    }
+    if(argc > 1) {
+        sc.repeats = (uint32_t)strtoul(argv[1], NULL, 10);
+    }
+    if(argc > 2) {
+        sc.timeoutUs = (int64_t)(strtod(argv[2], NULL) * 1e6);
+    }
+    if(argc > 3) {
+        sc.format = (strcmp(argv[3], "json") == 0) ? SWEEP_FORMAT_JSON : SWEEP_FORMAT_CSV;
+    }
+    if(argc > 4 && !cli_parse_engines("sweep", argc - 4, &argv[4], &sc.algos)) {
+        return 1;
+    }
+    return sweep_run(&sc) ? 0 : 1;
+}
+
+// The digit engines behind the Chudnovsky and Machin panels, the digits go to stdout. The long
+// products spread their transforms over a worker per core.
+static int cli_digits(int argc, char** argv) {
+    const char* engine = (argc > 0) ? argv[0] : "chudnovsky";
+    uint32_t digits = (argc > 1) ? (uint32_t)strtoul(argv[1], NULL, 10) : 1000;
+    char* out = malloc((size_t)digits + 3);
+    bool done;
+    if(out == NULL) {
+        abort();
+    }
+    executor_t ex;
+    executor_init(&ex, picalc_core_count(), 1);
+    ntt_set_executor(&ex);
+    int64_t start = picalc_time_us();
+    if(strcmp(engine, "chudnovsky") == 0) {
+        done = chudnovsky_compute(digits, out, (size_t)digits + 3, NULL, NULL);
+    } else if(strcmp(engine, "machin") == 0) {
+        done = machin_compute(MACHIN_FORMULA_MACHIN, digits, out, (size_t)digits + 3, 0, NULL, NULL);
+    } else if(strcmp(engine, "agm") == 0) {
+        done = agm_compute(digits, out, (size_t)digits + 3, NULL, NULL);
+    } else {
+        fprintf(stderr, "digits: no engine %s\n", engine);
+        done = false;
+    }
+    int64_t elapsed = picalc_time_us() - start;
+    ntt_set_executor(NULL);
+    executor_shutdown(&ex);
+    if(done) {
+        printf("%s\n", out);
+        fprintf(stderr, "%s: %u digits in %.3f s\n", engine, (unsigned)digits, (double)elapsed * 1e-6);
+    }
+    free(out);
+    return done ? 0 : 1;
+}
+
+typedef struct {
+    const char* name;
+    int (*run)(int argc, char** argv);
+    const char* usage;
+} cliCommand_t;
+
+static const cliCommand_t commands[] = {
+    {"race", cli_race, "[digits] [seconds] [engine...]"},
+    {"sweep", cli_sweep, "[maxDigits] [repeats] [timeoutSeconds] [csv|json] [engine...]"},
+    {"digits", cli_digits, "[chudnovsky|machin|agm] [digits]"},
+};
+
+int main(int argc, char** argv) {
+    size_t count = sizeof(commands) / sizeof(commands[0]);
+    if(argc >= 2) {
+        for(size_t i = 0; i < count; i++) {
+            if(strcmp(argv[1], commands[i].name) == 0) {
+                return commands[i].run(argc - 2, &argv[2]);
+            }
+        }
+    }
+    fprintf(stderr, "Usage: %s <command> [args]\n", argv[0]);
+    for(size_t i = 0; i < count; i++) {
+        fprintf(stderr, "    %s %s\n", commands[i].name, commands[i].usage);
+    }
+    fprintf(stderr, "Engines:");
+    for(uint32_t id = 0; id < PI_ALGO_COUNT; id++) {
+        fprintf(stderr, " %s", piAlgos[id].name);
+    }
+    fprintf(stderr, "\n");
+    return 1;
+}
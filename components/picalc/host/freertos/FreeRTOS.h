@@ -0,0 +1,31 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+// Host shim of the FreeRTOS subset the picalc engines and the app use, on top of pthreads.
+// Only what the code in this tree calls is there, with the same names and types:
+//   tasks           threads, priorities and core affinity are recorded but not enforced
+//   delete/suspend  of another task take effect at its next call into the shim
+//   ticks           1 kHz from CLOCK_MONOTONIC, counted from the first call
+//   notifications, queues, semaphores, event groups
+// It models the dual core board, portNUM_PROCESSORS is 2 whatever the host has.
+
+typedef int32_t BaseType_t;
+typedef uint32_t UBaseType_t;
+typedef uint32_t TickType_t;
+typedef uint32_t configSTACK_DEPTH_TYPE;
+
+#define pdFALSE             ((BaseType_t)0)
+#define pdTRUE              ((BaseType_t)1)
+#define pdFAIL              pdFALSE
+#define pdPASS              pdTRUE
+
+#define configTICK_RATE_HZ  1000
+#define portTICK_PERIOD_MS  ((TickType_t)1000 / configTICK_RATE_HZ)
+#define portMAX_DELAY       ((TickType_t)0xFFFFFFFFu)
+#define pdMS_TO_TICKS(ms)   ((TickType_t)(((uint64_t)(ms) * configTICK_RATE_HZ) / 1000))
+
+#define portNUM_PROCESSORS  2
+#define tskNO_AFFINITY      ((BaseType_t)0x7FFFFFFF)
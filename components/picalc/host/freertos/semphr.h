@@ -0,0 +1,18 @@
+#pragma once
+
+#include "FreeRTOS.h"
+#include "queue.h"
+
+// Semaphores are queues of empty items like in FreeRTOS. The mutexes have no priority
+// inheritance and no owner, which the code in this tree does not rely on.
+typedef QueueHandle_t SemaphoreHandle_t;
+
+QueueHandle_t shim_semaphore_create(UBaseType_t maxCount, UBaseType_t initialCount);
+
+#define xSemaphoreCreateBinary()                    shim_semaphore_create(1, 0)
+#define xSemaphoreCreateMutex()                     shim_semaphore_create(1, 1)
+#define xSemaphoreCreateCounting(maxCount, initial) shim_semaphore_create(maxCount, initial)
+#define xSemaphoreTake(sem, ticks)                  xQueueReceive(sem, NULL, ticks)
+#define xSemaphoreGive(sem)                         xQueueSend(sem, NULL, 0)
+#define vSemaphoreDelete(sem)                       vQueueDelete(sem)
+#define uxSemaphoreGetCount(sem)                    uxQueueMessagesWaiting(sem)
@@ -0,0 +1,404 @@
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <errno.h>
+#include <sched.h>
+#include <pthread.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
+#include "freertos/event_groups.h"
+
+// A task is a detached thread with a record that lives until the process ends, handles stay
+// valid after vTaskDelete. Threads the shim did not create get a record on first use.
+struct shimTask {
+    pthread_mutex_t lock;
+    pthread_cond_t wake;
+    TaskFunction_t fn;
+    void* param;
+    char name[16];
+    UBaseType_t priority;
+    BaseType_t core;
+    uint32_t notify;
+    bool suspended;
+    bool deleted;
+};
+
+struct shimQueue {
+    pthread_mutex_t lock;
+    pthread_cond_t changed;
+    uint8_t* storage;
+    UBaseType_t length;
+    UBaseType_t itemSize;
+    UBaseType_t head;
+    UBaseType_t count;
+};
+
+struct shimEventGroup {
+    pthread_mutex_t lock;
+    pthread_cond_t changed;
+    EventBits_t bits;
+};
+
+static _Thread_local struct shimTask* shimCurrent = NULL;
+static pthread_once_t shimBootOnce = PTHREAD_ONCE_INIT;
+static struct timespec shimBoot;
+
+static void shim_boot(void) {
+    clock_gettime(CLOCK_MONOTONIC, &shimBoot);
+}
+
+static void* shim_alloc(size_t size) {
+    void* p = calloc(1, size);
+    if(p == NULL) {
+        abort();
+    }
+    return p;
+}
+
+static struct shimTask* shim_task_new(const char* name, UBaseType_t priority, BaseType_t core) {
+    struct shimTask* t = shim_alloc(sizeof(struct shimTask));
+    pthread_mutex_init(&t->lock, NULL);
+    pthread_cond_init(&t->wake, NULL);
+    strncpy(t->name, name, sizeof(t->name) - 1);
+    t->priority = priority;
+    t->core = core;
+    return t;
+}
+
+static struct shimTask* shim_self(void) {
+    if(shimCurrent == NULL) {
+        shimCurrent = shim_task_new("main", 1, 0);
+    }
+    return shimCurrent;
+}
+
+// Absolute deadline ticks from now, for the timed waits
+static struct timespec shim_deadline(TickType_t ticks) {
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    uint64_t ns = (uint64_t)ticks * portTICK_PERIOD_MS * 1000000u;
+    ts.tv_sec += (time_t)(ns / 1000000000u);
+    ts.tv_nsec += (long)(ns % 1000000000u);
+    if(ts.tv_nsec >= 1000000000) {
+        ts.tv_sec++;
+        ts.tv_nsec -= 1000000000;
+    }
+    return ts;
+}
+
+// Waits on cond until signalled, false once the deadline has passed
+static bool shim_wait(pthread_cond_t* cond, pthread_mutex_t* lock, TickType_t ticks, const struct timespec* deadline) {
+    if(ticks == portMAX_DELAY) {
+        pthread_cond_wait(cond, lock);
+        return true;
+    }
+    return pthread_cond_timedwait(cond, lock, deadline) != ETIMEDOUT;
+}
+
+// Where a task notices that another one deleted or suspended it
+static void shim_checkpoint(void) {
+    struct shimTask* self = shim_self();
+    pthread_mutex_lock(&self->lock);
+    while(self->suspended && !self->deleted) {
+        pthread_cond_wait(&self->wake, &self->lock);
+    }
+    bool deleted = self->deleted;
+    pthread_mutex_unlock(&self->lock);
+    if(deleted) {
+        pthread_exit(NULL);
+    }
+}
+
+static void* shim_task_main(void* arg) {
+    shimCurrent = (struct shimTask*)arg;
+    shim_checkpoint();
+    shimCurrent->fn(shimCurrent->param);
+    // returning from a task function is an error in FreeRTOS, here it just ends the thread
+    return NULL;
+}
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t fn, const char* name, configSTACK_DEPTH_TYPE stackDepth, void* param,
+                                   UBaseType_t priority, TaskHandle_t* handle, BaseType_t core) {
+    (void)stackDepth;
+    pthread_once(&shimBootOnce, shim_boot);
+    struct shimTask* t = shim_task_new(name, priority, core);
+    t->fn = fn;
+    t->param = param;
+    if(handle != NULL) {
+        *handle = t;
+    }
+    pthread_t thread;
+    if(pthread_create(&thread, NULL, shim_task_main, t) != 0) {
+        abort();
+    }
+    pthread_detach(thread);
+    return pdPASS;
+}
+
+BaseType_t xTaskCreate(TaskFunction_t fn, const char* name, configSTACK_DEPTH_TYPE stackDepth, void* param,
+                       UBaseType_t priority, TaskHandle_t* handle) {
+    return xTaskCreatePinnedToCore(fn, name, stackDepth, param, priority, handle, tskNO_AFFINITY);
+}
+
+void vTaskDelete(TaskHandle_t task) {
+    struct shimTask* t = (task != NULL) ? task : shim_self();
+    pthread_mutex_lock(&t->lock);
+    t->deleted = true;
+    pthread_cond_broadcast(&t->wake);
+    pthread_mutex_unlock(&t->lock);
+    if(t == shim_self()) {
+        pthread_exit(NULL);
+    }
+}
+
+void vTaskSuspend(TaskHandle_t task) {
+    struct shimTask* t = (task != NULL) ? task : shim_self();
+    pthread_mutex_lock(&t->lock);
+    t->suspended = true;
+    pthread_mutex_unlock(&t->lock);
+    if(t == shim_self()) {
+        shim_checkpoint();
+    }
+}
+
+void vTaskResume(TaskHandle_t task) {
+    pthread_mutex_lock(&task->lock);
+    task->suspended = false;
+    pthread_cond_broadcast(&task->wake);
+    pthread_mutex_unlock(&task->lock);
+}
+
+eTaskState eTaskGetState(TaskHandle_t task) {
+    if(task == shim_self()) {
+        return eRunning;
+    }
+    pthread_mutex_lock(&task->lock);
+    eTaskState state = task->deleted ? eDeleted : (task->suspended ? eSuspended : eReady);
+    pthread_mutex_unlock(&task->lock);
+    return state;
+}
+
+void vTaskDelay(TickType_t ticks) {
+    shim_checkpoint();
+    uint64_t ns = (uint64_t)ticks * portTICK_PERIOD_MS * 1000000u;
+    struct timespec ts = {(time_t)(ns / 1000000000u), (long)(ns % 1000000000u)};
+    while(nanosleep(&ts, &ts) != 0 && errno == EINTR) {
+    }
+    shim_checkpoint();
+}
+
+TickType_t xTaskGetTickCount(void) {
+    pthread_once(&shimBootOnce, shim_boot);
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    int64_t ms = (int64_t)(now.tv_sec - shimBoot.tv_sec) * 1000 + (now.tv_nsec - shimBoot.tv_nsec) / 1000000;
+    return (TickType_t)(ms / portTICK_PERIOD_MS);
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle(void) {
+    return shim_self();
+}
+
+UBaseType_t uxTaskPriorityGet(TaskHandle_t task) {
+    return ((task != NULL) ? task : shim_self())->priority;
+}
+
+const char* pcTaskGetName(TaskHandle_t task) {
+    return ((task != NULL) ? task : shim_self())->name;
+}
+
+BaseType_t xPortGetCoreID(void) {
+    BaseType_t core = shim_self()->core;
+    return (core == tskNO_AFFINITY) ? 0 : core % portNUM_PROCESSORS;
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t clearOnExit, TickType_t ticks) {
+    struct shimTask* self = shim_self();
+    struct timespec deadline = shim_deadline(ticks);
+    shim_checkpoint();
+    pthread_mutex_lock(&self->lock);
+    while(self->notify == 0 && !self->deleted && shim_wait(&self->wake, &self->lock, ticks, &deadline)) {
+    }
+    uint32_t value = self->notify;
+    if(value > 0) {
+        self->notify = clearOnExit ? 0 : value - 1;
+    }
+    pthread_mutex_unlock(&self->lock);
+    shim_checkpoint();
+    return value;
+}
+
+BaseType_t xTaskNotifyGive(TaskHandle_t task) {
+    pthread_mutex_lock(&task->lock);
+    task->notify++;
+    pthread_cond_broadcast(&task->wake);
+    pthread_mutex_unlock(&task->lock);
+    return pdPASS;
+}
+
+void shim_task_yield(void) {
+    shim_checkpoint();
+    sched_yield();
+}
+
+QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t itemSize) {
+    struct shimQueue* q = shim_alloc(sizeof(struct shimQueue));
+    pthread_mutex_init(&q->lock, NULL);
+    pthread_cond_init(&q->changed, NULL);
+    q->storage = shim_alloc((size_t)length * itemSize);
+    q->length = length;
+    q->itemSize = itemSize;
+    return q;
+}
+
+void vQueueDelete(QueueHandle_t queue) {
+    pthread_mutex_destroy(&queue->lock);
+    pthread_cond_destroy(&queue->changed);
+    free(queue->storage);
+    free(queue);
+}
+
+static void shim_queue_push(struct shimQueue* q, const void* item) {
+    UBaseType_t tail = (q->head + q->count) % q->length;
+    if(q->itemSize > 0) {
+        memcpy(&q->storage[(size_t)tail * q->itemSize], item, q->itemSize);
+    }
+    q->count++;
+    pthread_cond_broadcast(&q->changed);
+}
+
+BaseType_t xQueueSend(QueueHandle_t queue, const void* item, TickType_t ticks) {
+    struct timespec deadline = shim_deadline(ticks);
+    shim_checkpoint();
+    pthread_mutex_lock(&queue->lock);
+    while(queue->count == queue->length && ticks > 0 && shim_wait(&queue->changed, &queue->lock, ticks, &deadline)) {
+    }
+    BaseType_t sent = queue->count < queue->length;
+    if(sent) {
+        shim_queue_push(queue, item);
+    }
+    pthread_mutex_unlock(&queue->lock);
+    return sent ? pdPASS : pdFAIL;
+}
+
+static BaseType_t shim_queue_take(QueueHandle_t queue, void* item, TickType_t ticks, bool remove) {
+    struct timespec deadline = shim_deadline(ticks);
+    shim_checkpoint();
+    pthread_mutex_lock(&queue->lock);
+    while(queue->count == 0 && ticks > 0 && shim_wait(&queue->changed, &queue->lock, ticks, &deadline)) {
+    }
+    BaseType_t received = queue->count > 0;
+    if(received) {
+        if(queue->itemSize > 0) {
+            memcpy(item, &queue->storage[(size_t)queue->head * queue->itemSize], queue->itemSize);
+        }
+        if(remove) {
+            queue->head = (queue->head + 1) % queue->length;
+            queue->count--;
+            pthread_cond_broadcast(&queue->changed);
+        }
+    }
+    pthread_mutex_unlock(&queue->lock);
+    return received ? pdPASS : pdFAIL;
+}
+
+BaseType_t xQueueReceive(QueueHandle_t queue, void* item, TickType_t ticks) {
+    return shim_queue_take(queue, item, ticks, true);
+}
+
+BaseType_t xQueuePeek(QueueHandle_t queue, void* item, TickType_t ticks) {
+    return shim_queue_take(queue, item, ticks, false);
+}
+
+BaseType_t xQueueOverwrite(QueueHandle_t queue, const void* item) {
+    pthread_mutex_lock(&queue->lock);
+    if(queue->count == queue->length) {
+        queue->count--;
+    }
+    shim_queue_push(queue, item);
+    pthread_mutex_unlock(&queue->lock);
+    return pdPASS;
+}
+
+BaseType_t xQueueReset(QueueHandle_t queue) {
+    pthread_mutex_lock(&queue->lock);
+    queue->head = 0;
+    queue->count = 0;
+    pthread_cond_broadcast(&queue->changed);
+    pthread_mutex_unlock(&queue->lock);
+    return pdPASS;
+}
+
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t queue) {
+    pthread_mutex_lock(&queue->lock);
+    UBaseType_t count = queue->count;
+    pthread_mutex_unlock(&queue->lock);
+    return count;
+}
+
+QueueHandle_t shim_semaphore_create(UBaseType_t maxCount, UBaseType_t initialCount) {
+    QueueHandle_t queue = xQueueCreate(maxCount, 0);
+    queue->count = initialCount;
+    return queue;
+}
+
+EventGroupHandle_t xEventGroupCreate(void) {
+    struct shimEventGroup* g = shim_alloc(sizeof(struct shimEventGroup));
+    pthread_mutex_init(&g->lock, NULL);
+    pthread_cond_init(&g->changed, NULL);
+    return g;
+}
+
+void vEventGroupDelete(EventGroupHandle_t group) {
+    pthread_mutex_destroy(&group->lock);
+    pthread_cond_destroy(&group->changed);
+    free(group);
+}
+
+EventBits_t xEventGroupSetBits(EventGroupHandle_t group, EventBits_t bits) {
+    pthread_mutex_lock(&group->lock);
+    group->bits |= bits;
+    EventBits_t now = group->bits;
+    pthread_cond_broadcast(&group->changed);
+    pthread_mutex_unlock(&group->lock);
+    return now;
+}
+
+EventBits_t xEventGroupClearBits(EventGroupHandle_t group, EventBits_t bits) {
+    pthread_mutex_lock(&group->lock);
+    EventBits_t before = group->bits;
+    group->bits &= ~bits;
+    pthread_mutex_unlock(&group->lock);
+    return before;
+}
+
+EventBits_t xEventGroupGetBits(EventGroupHandle_t group) {
+    pthread_mutex_lock(&group->lock);
+    EventBits_t now = group->bits;
+    pthread_mutex_unlock(&group->lock);
+    return now;
+}
+
+EventBits_t xEventGroupWaitBits(EventGroupHandle_t group, EventBits_t bits, BaseType_t clearOnExit,
+                                BaseType_t waitForAll, TickType_t ticks) {
+    struct timespec deadline = shim_deadline(ticks);
+    shim_checkpoint();
+    pthread_mutex_lock(&group->lock);
+    for(;;) {
+        EventBits_t set = group->bits & bits;
+        bool satisfied = waitForAll ? (set == bits) : (set != 0);
+        if(satisfied || ticks == 0 || !shim_wait(&group->changed, &group->lock, ticks, &deadline)) {
+            break;
+        }
+    }
+    EventBits_t now = group->bits;
+    EventBits_t set = now & bits;
+    if((waitForAll ? (set == bits) : (set != 0)) && clearOnExit) {
+        group->bits &= ~bits;
+    }
+    pthread_mutex_unlock(&group->lock);
+    return now;
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <stdint.h>
+
+// Convergence acceleration on top of the partial sums of the race series.
+//   SERIES_ACCEL_EULER            Euler-van Wijngaarden transform (repeated averaging of
+//                                 consecutive partial sums), alternating series (Leibniz)
+//   SERIES_ACCEL_WYNN             Wynn epsilon algorithm on consecutive partial sums (Leibniz)
+//   SERIES_ACCEL_EULER_MACLAURIN  Euler-Maclaurin tail of sum 1/k^2 (Basel)
+
+#define ACCEL_WINDOW    16      // partial sums kept for the windowed transforms
+
+typedef enum {
+    SERIES_ACCEL_NONE,
+    SERIES_ACCEL_EULER,
+    SERIES_ACCEL_WYNN,
+    SERIES_ACCEL_EULER_MACLAURIN,
+} seriesAccel_t;
+
+typedef struct {
+    seriesAccel_t mode;
+    double sums[ACCEL_WINDOW];  // ring of the most recent partial sums
+    uint32_t count;             // partial sums pushed so far
+} seriesAccelerator_t;
+
+const char* accel_mode_name(seriesAccel_t mode);
+
+void accel_init(seriesAccelerator_t* acc, seriesAccel_t mode);
+
+// Only a store, cheap enough to call for every term of the hot loop
+static inline void accel_push(seriesAccelerator_t* acc, double partialSum) {
+    acc->sums[acc->count % ACCEL_WINDOW] = partialSum;
+    acc->count++;
+}
+
+// Accelerated limit of the pushed partial sums (Euler or Wynn), or the last partial sum
+double accel_estimate(const seriesAccelerator_t* acc);
+
+// Bound on |limit - Euler estimate| for an alternating series with completely monotone terms
+// (Leibniz): every level of the averaging brackets the limit, the estimate is the midpoint of
+// the last two entries. Without rounding, INFINITY below two partial sums.
+double accel_euler_bound(const seriesAccelerator_t* acc);
+
+// sum_{k > n} 1/k^2 from the Euler-Maclaurin formula, the error is below 0.08 / n^11
+double accel_basel_tail(uint64_t n);
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+// Gauss-Legendre (Brent-Salamin) arithmetic-geometric mean on bigfloat_t.
+// Converges quadratically: the correct digits double with every iteration.
+
+#define AGM_MAX_ITERATIONS  40
+
+typedef struct {
+    int64_t timeUs;         // whole iteration
+    int64_t sqrtUs;         // sqrt(a * b), a Newton iteration of its own
+    int64_t mulUs;          // all multiplications of the iteration, including those in sqrt
+    uint32_t mulCount;
+    uint32_t digits;        // estimated correct digits after the iteration
+} agmIterationStats_t;
+
+typedef struct {
+    uint32_t digits;
+    uint32_t precisionBits;
+    uint32_t iterations;
+    agmIterationStats_t iteration[AGM_MAX_ITERATIONS];
+    int64_t finalUs;        // (a + b)^2 / 4t including the reciprocal
+    int64_t timeUs;
+} agmStats_t;
+
+// Computes pi to `digits` decimal places as "3.1415..." into out (at least digits + 3 characters).
+// cancel works like in chudnovsky_compute.
+bool agm_compute(uint32_t digits, char* out, size_t outSize, const volatile bool* cancel, agmStats_t* stats);
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#include "picalc_series.h"
+#include "picalc_accel.h"
+#include "picalc_executor.h"
+#include "picalc_montecarlo.h"
+
+// Registry of the pi engines that advance in batches of terms and always have an estimate,
+// what race mode runs. Every engine is a descriptor with a private state of stateSize bytes:
+//   init         fresh state for the config, the config has to outlive the state
+//   step         adds count terms (factors, samples)
+//   estimate     current value of pi
+//   error_bound  bound on |pi - estimate|, INFINITY while there is none
+//   reset        back to zero terms with the same config
+// The state bytes from runOffset on are what the run has accumulated and hold no pointers, so a
+// run can be snapshotted and restored into another state of the same engine.
+// The digits an engine has reached are the ones its interval around pi proves, estimate +-
+// error_bound or the tighter interval() of the engine.
+// Chudnovsky, Machin and the spigot compute digits, not batches, they keep their own tasks.
+
+typedef enum {
+    PI_ALGO_LEIBNIZ,
+    PI_ALGO_BASEL,
+    PI_ALGO_NILAKANTHA,
+    PI_ALGO_WALLIS,
+    PI_ALGO_VIETE,
+    PI_ALGO_RAMANUJAN,
+    PI_ALGO_MONTE_CARLO,
+    PI_ALGO_COUNT,
+} piAlgoId_t;
+
+#define PI_ALGO_MASK(id)    (1u << (id))
+#define PI_ALGO_ALL         ((1u << PI_ALGO_COUNT) - 1)
+
+// Shared by all engines, each one reads what applies to it. accel is read on every
+// accelerated() call, digitTarget before every step, both may change while the engine runs.
+typedef struct {
+    seriesFormat_t format;          // Leibniz, Basel, SERIES_FORMAT_ADAPTIVE picks by digitTarget
+    seriesSumMode_t sumMode;        // Leibniz, Basel in SERIES_FORMAT_DOUBLE
+    volatile seriesAccel_t accel;   // Leibniz (Euler, Wynn), Basel (Euler-Maclaurin)
+    uint32_t workers;               // > 1 splits Leibniz/Basel batches over the cores, Monte-Carlo lanes
+    seriesSplit_t split;
+    executor_t* executor;           // if set, the split batches go to this executor instead
+    uint32_t seed;                  // Monte-Carlo, 0 seeds from the hardware RNG
+    volatile uint32_t digitTarget;  // SERIES_FORMAT_ADAPTIVE, 0 for ALGO_MAX_DIGITS
+} piAlgoConfig_t;
+
+typedef struct {
+    const char* name;
+    const char* countLabel;         // what step counts, for the display
+    size_t stateSize;
+    size_t runOffset;               // the bytes before are set by init (the config pointer)
+    uint32_t batch;                 // first batch of a run, about a millisecond on the board
+    void (*init)(void* state, const piAlgoConfig_t* config);
+    void (*step)(void* state, uint32_t count);
+    double (*estimate)(const void* state);
+    double (*error_bound)(const void* state);
+    void (*reset)(void* state);
+    uint64_t (*count)(const void* state);
+    // Optional, NULL if the engine has none
+    double (*accelerated)(const void* state);           // accelerated estimate, estimate() if config->accel is NONE
+    void (*interval)(const void* state, uint64_t* lo, uint64_t* hi);    // Q2.62 interval that holds pi
+    uint32_t (*probable_digits)(const void* state);     // digits of a statistical confidence interval
+} piAlgo_t;
+
+extern const piAlgo_t piAlgos[PI_ALGO_COUNT];
+
+// Allocates and initializes the state of an engine, free() releases it
+void* algo_create(const piAlgo_t* algo, const piAlgoConfig_t* config);
+
+// A run of an engine outside of its state: term index, partial sums, compensation, accelerator
+// window. Restoring it continues the run where the snapshot was taken, with the config of the
+// state it goes into. Only the build that wrote a snapshot can read it.
+#define ALGO_SNAPSHOT_BYTES 288
+
+typedef struct {
+    uint32_t id;                    // piAlgoId_t
+    uint32_t size;                  // bytes of data in use
+    uint8_t data[ALGO_SNAPSHOT_BYTES];
+} algoSnapshot_t;
+
+void algo_snapshot(const piAlgo_t* algo, const void* state, algoSnapshot_t* snapshot);
+// false if the snapshot belongs to another engine or build, the state is left alone then
+bool algo_restore(const piAlgo_t* algo, void* state, const algoSnapshot_t* snapshot);
+
+// Index into piAlgos by name, PI_ALGO_COUNT if there is none
+piAlgoId_t algo_find(const char* name);
+
+// Next batch size so that one step takes about sliceUs, from the last batch and its duration.
+// Grows at most 4x per step and stays within [1, ALGO_MAX_BATCH].
+#define ALGO_MAX_BATCH  (1u << 22)
+uint32_t algo_next_batch(uint32_t batch, int64_t elapsedUs, int64_t sliceUs);
+
+// Highest digit target of race and sweep, about what an interval of doubles can prove
+#define ALGO_MAX_DIGITS 15
+
+// Interval [lo, hi] in Q2.62 that holds pi for sure: the engine's interval() if it has one,
+// otherwise estimate +- error_bound rounded outwards. [0, UINT64_MAX] while there is no bound.
+void algo_interval(const piAlgo_t* algo, const void* state, uint64_t* lo, uint64_t* hi);
+
+// Digits an engine has reached: probable digits if it has them, otherwise the decimal places
+// its interval proves. Integer arithmetic only, no reference value of pi.
+uint32_t algo_digits(const piAlgo_t* algo, const void* state);
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Bailey-Borwein-Plouffe digit extraction: hex digits of pi at any position without
+// computing the ones before. Position 0 is the first hex digit after the point
+// (pi = 3.243F6A88...), every position is independent so ranges split across cores.
+// The series is summed as 64 bit fixed point fractions which wrap modulo 1, and
+// 16^e mod m uses Barrett reduction, so no floating point is involved.
+
+#define BBP_HEX_PER_EVAL    8               // hex digits trusted from one evaluation
+#define BBP_MAX_POSITION    (1u << 24)      // keeps the accumulated rounding below 2^-37
+
+// Returns the 8 hex digits starting at position as a 32 bit value (first digit in the top nibble)
+uint32_t bbp_eval(uint32_t position);
+
+// Writes count hex digits starting at position into out (count + 1 characters).
+// The range is cut into blocks of BBP_HEX_PER_EVAL digits which are dealt round robin to
+// `workers` parallel workers, each writes its blocks straight into out.
+bool bbp_hex_digits(uint32_t position, uint32_t count, char* out, uint32_t workers);
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#include "picalc_bigint.h"
+
+// Multiprecision binary floating point: value = mant * 2^exp.
+// Every operation truncates its result to `prec` significant bits. All multiplications,
+// including the ones inside the Newton iterations for reciprocal and square root, go
+// through bigint_mul, so a faster multiply speeds up everything built on bigfloat_t.
+
+typedef struct {
+    bigint_t mant;
+    int64_t exp;
+} bigfloat_t;
+
+// Optional multiplication profile, updated by every bigfloat multiplication while set.
+// Meant for a single computing task, the counters are not protected.
+typedef struct {
+    uint32_t mulCount;
+    int64_t mulUs;
+} bigfloatProfile_t;
+
+void bigfloat_set_profile(bigfloatProfile_t* profile);
+
+void bigfloat_init(bigfloat_t* a);
+void bigfloat_free(bigfloat_t* a);
+void bigfloat_copy(bigfloat_t* r, const bigfloat_t* a);
+void bigfloat_set_u32(bigfloat_t* r, uint32_t value);
+void bigfloat_set_double(bigfloat_t* r, double value);
+double bigfloat_to_double(const bigfloat_t* a);
+static inline bool bigfloat_is_zero(const bigfloat_t* a) { return a->mant.size == 0; }
+// Position of the leading bit: 2^(magnitude-1) <= |a| < 2^magnitude
+int64_t bigfloat_magnitude(const bigfloat_t* a);
+
+void bigfloat_round(bigfloat_t* r, size_t prec);
+void bigfloat_add(bigfloat_t* r, const bigfloat_t* a, const bigfloat_t* b, size_t prec);
+void bigfloat_sub(bigfloat_t* r, const bigfloat_t* a, const bigfloat_t* b, size_t prec);
+void bigfloat_mul(bigfloat_t* r, const bigfloat_t* a, const bigfloat_t* b, size_t prec);
+void bigfloat_mul_u32(bigfloat_t* r, const bigfloat_t* a, uint32_t m, size_t prec);
+// r = a * 2^shift, exact
+void bigfloat_mul_2exp(bigfloat_t* r, const bigfloat_t* a, int64_t shift);
+
+// Newton iterations with precision doubling, seeded from a double
+void bigfloat_recip(bigfloat_t* r, const bigfloat_t* a, size_t prec);
+void bigfloat_div(bigfloat_t* r, const bigfloat_t* a, const bigfloat_t* b, size_t prec);
+void bigfloat_rsqrt(bigfloat_t* r, const bigfloat_t* a, size_t prec);
+void bigfloat_sqrt(bigfloat_t* r, const bigfloat_t* a, size_t prec);
+
+// Writes a >= 0 as "I.DDDD" with `digits` truncated decimal places.
+// Returns the number of characters, 0 if buf is too small.
+size_t bigfloat_to_decimal(const bigfloat_t* a, uint32_t digits, char* buf, size_t bufSize);
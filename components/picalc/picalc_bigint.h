@@ -0,0 +1,116 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdio.h>
+
+// Arbitrary precision signed integers (sign/magnitude, little endian limbs).
+// All functions allow the result to alias any of the operands.
+
+// Limbs are 32 bits on the board, the Xtensa core multiplies 32x32 into 64 bits, and 64 bits on a
+// host with a 128 bit product. -DBIGINT_LIMB_BITS=32 builds the board's limbs on a host.
+#ifndef BIGINT_LIMB_BITS
+#if defined(__SIZEOF_INT128__) && !defined(ESP_PLATFORM)
+#define BIGINT_LIMB_BITS    64
+#else
+#define BIGINT_LIMB_BITS    32
+#endif
+#endif
+
+#if BIGINT_LIMB_BITS == 64
+typedef uint64_t bigint_limb_t;
+__extension__ typedef unsigned __int128 bigint_dlimb_t;
+#define BIGINT_LIMB_DIGITS  20      // decimal digits of the largest limb
+#else
+typedef uint32_t bigint_limb_t;
+typedef uint64_t bigint_dlimb_t;
+#define BIGINT_LIMB_DIGITS  10
+#endif
+
+// Crossovers of the multiplication in limbs of the smaller operand: schoolbook below
+// BIGINT_KARATSUBA_THRESHOLD, Karatsuba below BIGINT_TOOM3_THRESHOLD, Toom-3 below
+// BIGINT_NTT_THRESHOLD and number theoretic transforms (picalc_ntt.h) above.
+// `picalc_bench bigint tune` measures them with bigint_tune() and prints these lines. The 64 bit
+// values are from an x86-64 host, the 32 bit ones from the same host with -DBIGINT_LIMB_BITS=32
+// until the tune runs on the board. The transforms grow in powers of two, so their time steps and
+// the NTT crossover is the median of a few runs. The board's digit targets stay below it.
+#ifndef BIGINT_KARATSUBA_THRESHOLD
+#if BIGINT_LIMB_BITS == 64
+#define BIGINT_KARATSUBA_THRESHOLD  22
+#define BIGINT_TOOM3_THRESHOLD      217
+#define BIGINT_NTT_THRESHOLD        12600
+#else
+#define BIGINT_KARATSUBA_THRESHOLD  26
+#define BIGINT_TOOM3_THRESHOLD      244
+#define BIGINT_NTT_THRESHOLD        2300
+#endif
+#endif
+
+typedef struct {
+    bigint_limb_t* limbs;
+    size_t size;        // used limbs, no leading zero limbs, 0 means the value is zero
+    size_t capacity;
+    bool negative;
+} bigint_t;
+
+void bigint_init(bigint_t* a);
+void bigint_free(bigint_t* a);
+void bigint_reserve(bigint_t* a, size_t limbs);
+void bigint_swap(bigint_t* a, bigint_t* b);
+void bigint_copy(bigint_t* r, const bigint_t* a);
+
+void bigint_set_u64(bigint_t* r, uint64_t value);
+void bigint_set_i64(bigint_t* r, int64_t value);
+static inline bool bigint_is_zero(const bigint_t* a) { return a->size == 0; }
+size_t bigint_bit_length(const bigint_t* a);
+double bigint_to_double(const bigint_t* a);
+
+int bigint_cmp(const bigint_t* a, const bigint_t* b);
+int bigint_cmp_abs(const bigint_t* a, const bigint_t* b);
+
+void bigint_add(bigint_t* r, const bigint_t* a, const bigint_t* b);
+void bigint_sub(bigint_t* r, const bigint_t* a, const bigint_t* b);
+void bigint_mul(bigint_t* r, const bigint_t* a, const bigint_t* b);
+void bigint_mul_u32(bigint_t* r, const bigint_t* a, uint32_t m);
+void bigint_add_u32(bigint_t* r, const bigint_t* a, uint32_t m);
+// Truncating division by a small divisor, returns the remainder of |a| / d.
+uint32_t bigint_div_u32(bigint_t* q, const bigint_t* a, uint32_t d);
+// Truncating division: q = a / b rounded towards zero, rem gets the sign of a.
+// q or rem may be NULL if not needed. b must not be zero.
+void bigint_divmod(bigint_t* q, bigint_t* rem, const bigint_t* a, const bigint_t* b);
+// Shifts operate on the magnitude, the sign is kept.
+void bigint_shl(bigint_t* r, const bigint_t* a, size_t bits);
+void bigint_shr(bigint_t* r, const bigint_t* a, size_t bits);
+void bigint_pow_u32(bigint_t* r, uint32_t base, uint32_t exp);
+// floor(sqrt(a)) for a >= 0
+void bigint_sqrt(bigint_t* r, const bigint_t* a);
+
+// Multiplication of limb arrays with a chosen method at the top, for the tuning and the
+// cross-checks. r[0..an+bn) = a * b for an >= bn > 0, r must not overlap a or b. The products below
+// the top go by thresholds, NULL for the built-in ones. bigint_mul is BIGINT_MUL_AUTO. A product too
+// long for the transforms goes to Toom-3.
+typedef enum {
+    BIGINT_MUL_AUTO,
+    BIGINT_MUL_SCHOOLBOOK,
+    BIGINT_MUL_KARATSUBA,
+    BIGINT_MUL_TOOM3,
+    BIGINT_MUL_NTT,
+} bigintMul_t;
+
+typedef struct {
+    size_t karatsuba;
+    size_t toom3;
+    size_t ntt;
+} bigintMulThresholds_t;
+
+void bigint_mul_limbs(bigint_limb_t* r, const bigint_limb_t* a, size_t an, const bigint_limb_t* b, size_t bn,
+                      bigintMul_t method, const bigintMulThresholds_t* thresholds);
+
+// Measures the crossovers on this machine for square products of up to maxLimbs limbs, a line per
+// size tried to out (NULL for none). Slower methods are timed until they lose for a few sizes in a row.
+void bigint_tune(bigintMulThresholds_t* thresholds, size_t maxLimbs, FILE* out);
+
+// Writes the decimal representation (with leading '-' if negative) into buf.
+// Returns the number of characters (without terminator), or 0 if buf is too small.
+size_t bigint_to_decimal(const bigint_t* a, char* buf, size_t bufSize);
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#include "picalc_race.h"
+
+// Checkpoints of the race engines on a NOR flash, so a long run continues after a reboot.
+// A record is the raceSnapshot_t of an engine (term index, partial sums, compensation, accelerator
+// window, clocks) with a sequence number and a CRC-32. Every engine has two sectors of preallocated
+// slots of whole pages: records go to the next slot, and only when a sector is full the other one
+// is erased, the newest record stays in the full one meanwhile. At boot the valid record with the
+// highest sequence wins, a write that was torn by a reset fails its CRC and the one before counts.
+// A record of the smaller engines fits one page, so a checkpoint costs a single page program.
+//
+// The writer task takes the snapshots between two steps of an engine (race_snapshot), the flash
+// work runs in the writer and never in a race worker.
+
+// The flash the records go to. Reads and programs stay within one page, a program only clears
+// bits and an erase sets one sector to 0xFF. The callbacks return false on an error.
+typedef struct {
+    void* context;
+    bool (*read)(void* context, uint32_t address, void* data, uint32_t size);
+    bool (*prog)(void* context, uint32_t address, const void* data, uint32_t size);
+    bool (*erase)(void* context, uint32_t address);
+    uint32_t pageSize;
+    uint32_t sectorSize;
+    uint32_t base;                  // first byte of the region, at a sector
+    uint32_t size;                  // CHECKPOINT_SECTORS sectors at least
+} checkpointFlash_t;
+
+#define CHECKPOINT_SECTORS  (2 * PI_ALGO_COUNT)
+#define CHECKPOINT_MAGIC    0x4b434950u     // "PICK"
+// Raised whenever the header or the meaning of an engine's run data changes. A record of another
+// version, or one whose engine state changed its size or offset, is passed over at boot.
+#define CHECKPOINT_VERSION  2
+
+// How a record starts in its slot, the engine's run data follows
+typedef struct {
+    uint32_t magic;
+    uint32_t crc;                   // CRC-32 of the record from version on
+    uint32_t version;               // CHECKPOINT_VERSION
+    uint32_t layout;                // CRC-32 of the engine's name, state size and run offset
+    uint32_t sequence;              // counts the records of an engine from 1
+    uint32_t size;                  // of the record with this header
+    uint32_t id;                    // piAlgoId_t
+    uint32_t batch;
+    int64_t elapsedUs;
+    int64_t cpuUs;
+    uint64_t cycles;
+} checkpointHeader_t;
+
+typedef struct {
+    uint32_t slotSize;              // record size rounded up to pages
+    uint32_t slots;                 // per sector
+    uint32_t next;                  // slot of the next record, counted over both sectors
+    uint32_t newest;                // slot of the newest record
+    uint32_t sequence;              // of the newest record, 0 if there is none
+    raceSnapshot_t saved;           // what the newest record holds
+} checkpointEngine_t;
+
+typedef struct {
+    uint32_t records;               // written since checkpoint_init
+    uint32_t pagePrograms;
+    uint32_t erases;
+    uint32_t errors;                // flash errors and records that did not read back
+    int64_t writeUsMax;             // longest record write with its erase
+} checkpointStats_t;
+
+typedef struct {
+    checkpointFlash_t flash;
+    race_t* race;
+    uint32_t periodMs;
+    checkpointEngine_t engines[PI_ALGO_COUNT];
+    checkpointStats_t stats;
+    TaskHandle_t writer;
+} checkpoint_t;
+
+// Finds the newest valid record of every engine of race. False if the region is too small for
+// the records.
+bool checkpoint_init(checkpoint_t* checkpoint, const checkpointFlash_t* flash, race_t* race);
+
+// Puts the records found by checkpoint_init into the stopped engines, race_start continues them.
+// Returns the mask of the engines that got a run with terms.
+uint32_t checkpoint_restore(checkpoint_t* checkpoint);
+
+// Writes a record of the engine if its run changed since its last record (a reset counts too).
+// True if it wrote one. Not while the writer task runs.
+bool checkpoint_save(checkpoint_t* checkpoint, piAlgoId_t id);
+
+// Task that saves every engine every periodMs
+void checkpoint_start_writer(checkpoint_t* checkpoint, uint32_t periodMs, UBaseType_t priority,
+                             configSTACK_DEPTH_TYPE stackDepth, BaseType_t core);
+
+// CRC-32 (IEEE, reflected), crc is 0 for the first block
+uint32_t checkpoint_crc32(uint32_t crc, const void* data, size_t size);
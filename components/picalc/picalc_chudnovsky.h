@@ -0,0 +1,24 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+// Chudnovsky series evaluated with binary splitting on bigint_t.
+// Every term adds about 14.18 decimal digits.
+
+#define CHUDNOVSKY_DIGITS_PER_TERM  14.181647462725477
+
+typedef struct {
+    uint32_t digits;
+    uint32_t terms;
+} chudnovskyStats_t;
+
+// Number of series terms needed for the given number of decimal places.
+uint32_t chudnovsky_terms_for_digits(uint32_t digits);
+
+// Computes pi to `digits` decimal places and writes it as "3.1415..." into out,
+// which must hold at least digits + 3 characters.
+// If cancel is not NULL it is polled during the computation; when it becomes true the
+// computation is cancelled, all memory is released and false is returned.
+bool chudnovsky_compute(uint32_t digits, char* out, size_t outSize, const volatile bool* cancel, chudnovskyStats_t* stats);
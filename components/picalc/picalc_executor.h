@@ -0,0 +1,78 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+
+// Work-stealing executor. Every worker owns a deque: it pushes and pops its own tasks at the
+// bottom, idle workers steal from the top of the others (Chase-Lev). Tasks submitted from
+// outside the executor go through a shared inject queue. Workers are FreeRTOS tasks pinned
+// round-robin to the cores on the board and pthreads on a host.
+//
+// Tasks belong to a group, executor_wait() returns when every task of the group is done and
+// runs tasks itself while it waits, so tasks may submit and wait for subtasks (divide and conquer).
+
+#define EXECUTOR_MAX_WORKERS    8
+#define EXECUTOR_DEQUE_SIZE     256     // power of 2, a full deque runs the task inline
+#define EXECUTOR_INJECT_SIZE    64      // power of 2, a full inject queue runs the task inline
+
+typedef void (*executorFn_t)(void* arg);
+typedef void (*executorRangeFn_t)(void* arg, uint32_t begin, uint32_t end);
+
+typedef struct {
+    atomic_uint pending;
+} executorGroup_t;
+
+typedef struct {
+    executorFn_t fn;
+    void* arg;
+    executorGroup_t* group;
+} executorTask_t;
+
+typedef struct {
+    atomic_long top;
+    atomic_long bottom;
+    executorTask_t tasks[EXECUTOR_DEQUE_SIZE];
+} executorDeque_t;
+
+typedef struct {
+    uint32_t executed;
+    uint32_t stolen;
+} executorWorkerStats_t;
+
+typedef struct executor {
+    uint32_t workers;
+    executorDeque_t deque[EXECUTOR_MAX_WORKERS];
+    executorWorkerStats_t stats[EXECUTOR_MAX_WORKERS];
+    void* worker[EXECUTOR_MAX_WORKERS];     // TaskHandle_t or pthread_t*
+    void* lock;                             // inject queue
+    void* wake;                             // idle workers sleep here
+    void* exited;                           // workers give it on their way out (board only)
+    executorTask_t inject[EXECUTOR_INJECT_SIZE];
+    uint32_t injectHead;
+    uint32_t injectTail;
+    atomic_bool stop;
+} executor_t;
+
+// Starts `workers` workers (at most EXECUTOR_MAX_WORKERS) at the given FreeRTOS priority,
+// the priority is ignored on a host
+void executor_init(executor_t* ex, uint32_t workers, uint32_t priority);
+
+// Stops and joins the workers, no task may be pending
+void executor_shutdown(executor_t* ex);
+
+static inline void executor_group_init(executorGroup_t* group) {
+    atomic_init(&group->pending, 0);
+}
+
+// Callable from any task or thread, including from inside a task
+void executor_submit(executor_t* ex, executorGroup_t* group, executorFn_t fn, void* arg);
+
+// Runs pending tasks until every task of the group is done
+void executor_wait(executor_t* ex, executorGroup_t* group);
+
+// fn(arg, begin, end) over [begin, end) cut into pieces of at least grain indices. The range
+// is halved recursively, so stolen work is always a big piece and uneven costs even out.
+void executor_parallel_for(executor_t* ex, uint32_t begin, uint32_t end, uint32_t grain, executorRangeFn_t fn, void* arg);
+
+void executor_reset_stats(executor_t* ex);
@@ -0,0 +1,161 @@
+#pragma once
+
+#include <stdint.h>
+#include <math.h>
+
+// Float-float ("double-single") arithmetic: a value is the unevaluated sum hi + lo of two floats
+// with |lo| <= ulp(hi) / 2, about 48 mantissa bits. The ESP32-S3 FPU only does single precision,
+// so this runs on hardware where double goes through the soft-float library.
+// The error-free transformations rely on round-to-nearest float arithmetic without excess
+// precision, do not build with -ffast-math.
+
+typedef struct {
+    float hi;
+    float lo;
+} ff_t;
+
+// fmaf is a single madd.s on the ESP32-S3, without a fused multiply-add the product is split
+#if defined(__FP_FAST_FMAF) || defined(ESP_PLATFORM)
+#define FF_HAS_FMA  1
+#else
+#define FF_HAS_FMA  0
+#endif
+
+static inline ff_t ff_from_float(float a) {
+    ff_t r = {a, 0.0f};
+    return r;
+}
+
+static inline ff_t ff_from_double(double a) {
+    ff_t r;
+    r.hi = (float)a;
+    r.lo = (float)(a - (double)r.hi);
+    return r;
+}
+
+static inline double ff_to_double(ff_t a) {
+    return (double)a.hi + (double)a.lo;
+}
+
+static inline long double ff_to_long_double(ff_t a) {
+    return (long double)a.hi + (long double)a.lo;
+}
+
+// s + e == a + b exactly, requires |a| >= |b|
+static inline ff_t ff_fast_two_sum(float a, float b) {
+    ff_t r;
+    r.hi = a + b;
+    r.lo = b - (r.hi - a);
+    return r;
+}
+
+// Exact for every 32-bit value
+static inline ff_t ff_from_u32(uint32_t a) {
+    return ff_fast_two_sum((float)(a & 0xFFFFFF00u), (float)(a & 0xFFu));
+}
+
+// Exact below 2^48, far beyond any denominator the series reach
+static inline ff_t ff_from_u64(uint64_t a) {
+    return ff_fast_two_sum((float)(a & ~(uint64_t)0xFFFFFF), (float)(a & 0xFFFFFFu));
+}
+
+// s + e == a + b exactly
+static inline ff_t ff_two_sum(float a, float b) {
+    ff_t r;
+    r.hi = a + b;
+    float bb = r.hi - a;
+    r.lo = (a - (r.hi - bb)) + (b - bb);
+    return r;
+}
+
+#if !FF_HAS_FMA
+// Dekker split into two halves of 12 bits
+static inline void ff_split(float a, float* hi, float* lo) {
+    float t = 4097.0f * a;
+    *hi = t - (t - a);
+    *lo = a - *hi;
+}
+#endif
+
+// p + e == a * b exactly
+static inline ff_t ff_two_prod(float a, float b) {
+    ff_t r;
+    r.hi = a * b;
+#if FF_HAS_FMA
+    r.lo = fmaf(a, b, -r.hi);
+#else
+    float ah, al, bh, bl;
+    ff_split(a, &ah, &al);
+    ff_split(b, &bh, &bl);
+    r.lo = ((ah * bh - r.hi) + ah * bl + al * bh) + al * bl;
+#endif
+    return r;
+}
+
+static inline ff_t ff_add(ff_t a, ff_t b) {
+    ff_t s = ff_two_sum(a.hi, b.hi);
+    ff_t t = ff_two_sum(a.lo, b.lo);
+    s.lo += t.hi;
+    s = ff_fast_two_sum(s.hi, s.lo);
+    s.lo += t.lo;
+    return ff_fast_two_sum(s.hi, s.lo);
+}
+
+static inline ff_t ff_neg(ff_t a) {
+    ff_t r = {-a.hi, -a.lo};
+    return r;
+}
+
+static inline ff_t ff_sub(ff_t a, ff_t b) {
+    return ff_add(a, ff_neg(b));
+}
+
+static inline ff_t ff_mul(ff_t a, ff_t b) {
+    ff_t p = ff_two_prod(a.hi, b.hi);
+    p.lo += a.hi * b.lo + a.lo * b.hi;
+    return ff_fast_two_sum(p.hi, p.lo);
+}
+
+static inline ff_t ff_mul_float(ff_t a, float b) {
+    ff_t p = ff_two_prod(a.hi, b);
+    p.lo += a.lo * b;
+    return ff_fast_two_sum(p.hi, p.lo);
+}
+
+// Long division with three float quotients, each one removes another ~24 bits of the remainder
+static inline ff_t ff_div(ff_t a, ff_t b) {
+    float q1 = a.hi / b.hi;
+    ff_t r = ff_sub(a, ff_mul_float(b, q1));
+    float q2 = r.hi / b.hi;
+    r = ff_sub(r, ff_mul_float(b, q2));
+    float q3 = r.hi / b.hi;
+    ff_t q = ff_fast_two_sum(q1, q2);
+    return ff_add(q, ff_from_float(q3));
+}
+
+// 1 / b for a b that is exact as float, two quotients are enough here
+static inline ff_t ff_recip_float(float b) {
+    float q1 = 1.0f / b;
+#if FF_HAS_FMA
+    float r = fmaf(-q1, b, 1.0f);
+#else
+    ff_t p = ff_two_prod(q1, b);
+    float r = (1.0f - p.hi) - p.lo;
+#endif
+    return ff_fast_two_sum(q1, r / b);
+}
+
+static inline ff_t ff_recip(ff_t b) {
+    return ff_div(ff_from_float(1.0f), b);
+}
+
+// One Newton step on top of the float square root
+static inline ff_t ff_sqrt(ff_t a) {
+    if(a.hi <= 0.0f) {
+        return ff_from_float(0.0f);
+    }
+    float s = sqrtf(a.hi);
+    ff_t p = ff_two_prod(s, s);
+    float r = ((a.hi - p.hi) - p.lo + a.lo) / (2.0f * s);
+    return ff_fast_two_sum(s, r);
+}
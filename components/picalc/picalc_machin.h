@@ -0,0 +1,43 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+// Machin-like formulas pi = sum c_i * arctan(1/k_i). Every arctan series runs on its own
+// fixed point number (one integer limb, the rest fraction) and only needs divisions by
+// small integers. The series are independent, so each one can run on its own core;
+// the weighted sum is formed in a fixed order at the end.
+
+#define MACHIN_MAX_SERIES   4
+
+typedef enum {
+    MACHIN_FORMULA_MACHIN,      // 16 atan(1/5) - 4 atan(1/239)
+    MACHIN_FORMULA_TAKANO,      // 48 atan(1/49) + 128 atan(1/57) - 20 atan(1/239) + 48 atan(1/110443)
+    MACHIN_FORMULA_STORMER,     // 176 atan(1/57) + 28 atan(1/239) - 48 atan(1/682) + 96 atan(1/12943)
+} machinFormula_t;
+
+typedef struct {
+    uint32_t k;
+    int32_t coefficient;
+    uint32_t worker;            // worker that evaluated the series, core = worker % picalc_core_count()
+    uint32_t terms;
+    uint64_t limbOps;           // limbs touched by divisions and additions
+    int64_t timeUs;
+    int64_t cpuUs;              // CPU time of the worker, without the time it was preempted
+} machinSeriesStats_t;
+
+typedef struct {
+    uint32_t digits;
+    uint32_t limbs;             // limbs per fixed point number
+    uint32_t seriesCount;
+    machinSeriesStats_t series[MACHIN_MAX_SERIES];
+    int64_t timeUs;
+} machinStats_t;
+
+const char* machin_formula_name(machinFormula_t formula);
+
+// Computes pi to `digits` decimal places as "3.1415..." into out (at least digits + 3 characters).
+// workers = 0 runs one worker per series. cancel works like in chudnovsky_compute.
+bool machin_compute(machinFormula_t formula, uint32_t digits, char* out, size_t outSize, uint32_t workers,
+                    const volatile bool* cancel, machinStats_t* stats);
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+
+// Single writer, single reader "latest value" mailbox (seqlock). The writer never waits, a
+// publish overwrites whatever the reader has not picked up yet. The reader copies the value
+// and retries if a publish ran at the same time.
+
+typedef struct {
+    atomic_uint sequence;   // odd while a publish is in progress, +2 per publish
+    void* data;
+    size_t size;
+} mailbox_t;
+
+// storage must hold size bytes and stay valid for the lifetime of the mailbox.
+// Not safe against a running writer, re-init only after the writer is stopped.
+void mailbox_init(mailbox_t* mb, void* storage, size_t size);
+
+void mailbox_publish(mailbox_t* mb, const void* value);
+
+// Copies the latest value into out if there was a publish since *lastSequence and updates it.
+// Returns false if there is nothing new or every retry overlapped with a publish.
+bool mailbox_read(mailbox_t* mb, void* out, uint32_t* lastSequence);
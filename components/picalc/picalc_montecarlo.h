@@ -0,0 +1,89 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "picalc_executor.h"
+
+// Monte-Carlo estimate of pi: random points in the unit square, pi = 4 * hits / samples.
+// Every 32-bit xoshiro128++ output is one point, two 15-bit coordinates taken as the centres of a
+// 2^15 x 2^15 grid. The hit test (2x+1)^2 + (2y+1)^2 < 2^32 needs 32-bit integers only. The grid
+// itself limits the estimate to 3.14159248769 (1.7e-7 low), far below the statistical error of
+// any run that fits in a lifetime.
+//
+// Every lane has its own generator (one 2^64 jump apart) and counters, written only by the
+// worker that samples the lane. The lanes are merged when they are read, after the workers joined.
+
+#define MONTECARLO_MAX_LANES    8
+// Random numbers drawn into a stack buffer before they are tested, kept small on the board where
+// the race and picalc_parallel_run workers have 4-6 KB of stack
+#ifdef ESP_PLATFORM
+#define MONTECARLO_BLOCK        256
+#else
+#define MONTECARLO_BLOCK        1024
+#endif
+#define MONTECARLO_Z            3.0     // confidence interval in standard deviations, 99.7 %
+#define MONTECARLO_MIN_SAMPLES  1000    // no probable digits before this many samples
+
+typedef struct {
+    uint32_t s[4];
+} xoshiro128_t;
+
+static inline uint32_t xoshiro128_rotl(uint32_t x, int k) {
+    return (x << k) | (x >> (32 - k));
+}
+
+static inline uint32_t xoshiro128_next(xoshiro128_t* x) {
+    uint32_t* s = x->s;
+    uint32_t result = xoshiro128_rotl(s[0] + s[3], 7) + s[0];
+    uint32_t t = s[1] << 9;
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = xoshiro128_rotl(s[3], 11);
+    return result;
+}
+
+// State from a 64-bit seed through splitmix64, never all zero
+void xoshiro128_seed(xoshiro128_t* x, uint64_t seed);
+
+// Advances by 2^64 outputs, for non-overlapping streams
+void xoshiro128_jump(xoshiro128_t* x);
+
+typedef struct {
+    xoshiro128_t rng;
+    uint64_t hits;
+    uint64_t samples;
+} montecarloLane_t;
+
+typedef struct {
+    montecarloLane_t lane[MONTECARLO_MAX_LANES];
+    uint32_t lanes;
+    uint32_t seed;              // the seed in use, also when it came from the hardware RNG
+} montecarlo_t;
+
+// seed 0 takes one from picalc_random_seed(), the hardware RNG on the board
+void montecarlo_init(montecarlo_t* mc, uint32_t seed, uint32_t lanes);
+
+// Draws count points on lane 0
+void montecarlo_sample(montecarlo_t* mc, uint32_t count);
+
+// Draws count points split over all lanes, one worker per lane (picalc_parallel_run), or as
+// executor tasks if ex is not NULL
+void montecarlo_sample_parallel(montecarlo_t* mc, uint32_t count, executor_t* ex);
+
+uint64_t montecarlo_hits(const montecarlo_t* mc);
+uint64_t montecarlo_samples(const montecarlo_t* mc);
+
+double montecarlo_estimate(const montecarlo_t* mc);
+
+// MONTECARLO_Z confidence interval [lo, hi] of pi (Wilson score interval), [0, 4] without samples
+void montecarlo_interval(const montecarlo_t* mc, double* lo, double* hi);
+
+// Largest distance from the estimate to an end of the interval, INFINITY without samples
+double montecarlo_half_width(const montecarlo_t* mc);
+
+// Decimal places shared by both ends of the confidence interval, right with 99.7 % probability.
+// 0 below MONTECARLO_MIN_SAMPLES samples and while no sample or every sample hit.
+uint32_t montecarlo_probable_digits(const montecarlo_t* mc);
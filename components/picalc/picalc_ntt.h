@@ -0,0 +1,35 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#include "picalc_bigint.h"
+#include "picalc_executor.h"
+
+// Multiplication of long limb arrays by number theoretic transforms. The operands are cut into
+// 32 bit coefficients and convolved modulo three primes below 2^31 (Montgomery arithmetic, the
+// board multiplies 32x32 into 64 bits), the CRT (Garner) puts the three residues of a coefficient
+// together and the carries go through as the product is written. A coefficient of the product
+// is below 2^88 for up to 2^24 coefficients, the primes multiply to more than 2^89.
+//
+// The transforms are radix 2, forward decimation in frequency and inverse in time, so neither
+// needs a bit reversal. Stages with butterflies further apart than NTT_BLOCK elements pass over
+// the whole array, the rest run block by block, every stage of a block while it is in the cache.
+// The twiddles are tables per stage, built on first use and kept for the following products.
+//
+// bigint_mul goes here from BIGINT_NTT_THRESHOLD limbs on, callers see no difference.
+
+#define NTT_MAX_LOG     24          // longest transform, 2^24 coefficients of 32 bits
+#define NTT_BLOCK       4096        // elements of a block, 16 KB
+
+// r[0..an+bn) = a * b for an >= bn > 0, r must not overlap a or b. False, and r untouched, if the
+// product needs a transform longer than 2^NTT_MAX_LOG.
+bool ntt_mul(bigint_limb_t* r, const bigint_limb_t* a, size_t an, const bigint_limb_t* b, size_t bn);
+
+// Executor the transforms and the butterflies of a stage are spread over, NULL (the default)
+// runs them on the calling task. The executor must outlive the products that use it.
+void ntt_set_executor(executor_t* ex);
+
+// Frees the twiddle tables, not while a product runs
+void ntt_free_tables(void);
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+// Platform layer of the picalc engines: FreeRTOS/ESP-IDF on the board, POSIX on a host.
+
+// Monotonic time in microseconds
+int64_t picalc_time_us(void);
+
+// Free running cycle counter of the calling core. The board counter is 32 bits wide and wraps
+// after about 17 s at 240 MHz, only take differences over shorter intervals.
+uint64_t picalc_cycle_count(void);
+
+// Cycles from start (a picalc_cycle_count() value) to now, across a wrap of the board counter
+uint64_t picalc_cycles_since(uint64_t start);
+
+// Core clock in cycles per microsecond, to turn CPU time into cycles where the 32-bit board
+// counter would wrap. A host calibrates the cycle counter against the clock on the first call.
+uint32_t picalc_cycles_per_us(void);
+
+// CPU time of the calling task in microseconds, the time it was preempted does not count.
+// The board reads the FreeRTOS run time stats (32 bits, wraps after about 71 minutes, only take
+// differences), and falls back to picalc_time_us() if they are not configured. A host reads the
+// CPU clock of the calling thread.
+uint64_t picalc_cpu_time_us(void);
+
+// CPU time from start (a picalc_cpu_time_us() value) to now, across a wrap of the board counter
+uint64_t picalc_cpu_time_since_us(uint64_t start);
+
+// Number of cores available for parallel work (2 on the ESP32-S3)
+uint32_t picalc_core_count(void);
+
+// Where the numbers come from, the IDF target on the board and "host" otherwise
+const char* picalc_platform_name(void);
+
+// Highest heap use so far in bytes. The board takes the low-water mark of free 8-bit heap since
+// boot, a host the peak resident size of the process. Neither can be reset.
+size_t picalc_heap_peak(void);
+
+// Lets lower priority tasks run, long loops call it every few ten milliseconds so the idle
+// tasks can feed the watchdog. A tick of sleep on the board, sched_yield() on a host.
+void picalc_yield(void);
+
+// 32 random bits for seeding. The board reads the hardware RNG, which is only truly random while
+// Wi-Fi/Bluetooth or the bootloader entropy source run, good enough for a seed either way.
+// A host reads /dev/urandom, or mixes the clock if there is none.
+uint32_t picalc_random_seed(void);
+
+typedef void (*picalcWorker_t)(void* arg, uint32_t worker, uint32_t workers);
+
+// Runs fn(arg, w, workers) for w = 0..workers-1 concurrently and returns when all are done.
+// On the board worker w is a task pinned to core w % portNUM_PROCESSORS with the caller's priority.
+// On a host the workers come from a thread pool that grows on demand, calls from several
+// threads are serialized. Workers must not call picalc_parallel_run themselves.
+void picalc_parallel_run(picalcWorker_t fn, void* arg, uint32_t workers);
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#include "picalc_algo.h"
+#include "picalc_mailbox.h"
+
+// Race of the registered engines. One worker task per core steps the running engines in turn,
+// every step is sized to take about sliceUs and publishes a piResult_t to the engine's mailbox.
+// The owner (controlTask on the board, the CLI on a host) starts and stops engines and reads
+// the results with race_update(). On a host the FreeRTOS calls go to the shim in host/.
+
+// What an engine publishes, Chudnovsky and Machin fill in the same fields
+typedef struct {
+    double     piValue;
+    double     piAccelerated;   // estimate of the selected acceleration mode, equals piValue in raw mode
+    double     errorBound;      // bound on |pi - piValue| from the engine
+    int64_t    elapsedUs;       // wall time since the start of the run
+    int64_t    cpuUs;           // CPU time behind iterations, without the time the engine was preempted
+    uint64_t   cycles;          // CPU cycles behind iterations
+    uint64_t   iterations;
+    uint32_t   digits;          // digits the engine has reached, algo_digits() for the race engines
+    bool       probable;        // digits and errorBound come from a confidence interval (Monte-Carlo)
+} piResult_t;
+
+// The workers own state and batch while they hold claimed, result, sequence and digits belong
+// to the owner
+typedef struct {
+    const piAlgo_t* algo;
+    piAlgoConfig_t config;
+    void* state;
+    mailbox_t mailbox;
+    piResult_t mailboxStorage;
+    volatile bool running;      // set and cleared by the owner, the workers only step running engines
+    atomic_bool claimed;
+    uint32_t batch;
+    int64_t startUs;            // moved on by the pauses, so the elapsed time only counts running
+    int64_t elapsedUs;          // up to the last step
+    int64_t cpuUs;              // summed over the steps by the workers
+    uint64_t cycles;
+    piResult_t result;
+    uint32_t sequence;
+    uint32_t digits;
+} raceEngine_t;
+
+typedef struct race race_t;
+
+typedef struct {
+    race_t* race;
+    uint32_t core;
+} raceWorkerArg_t;
+
+struct race {
+    raceEngine_t engines[PI_ALGO_COUNT];
+    int64_t sliceUs;
+    int64_t yieldUs;            // workers sleep for a tick this often so the idle tasks can feed the watchdog
+    volatile bool hold;         // set on reset, the workers park without holding an engine until it is cleared
+    volatile bool parked[portNUM_PROCESSORS];
+    TaskHandle_t workers[portNUM_PROCESSORS];
+    raceWorkerArg_t workerArgs[portNUM_PROCESSORS];
+};
+
+// Every engine gets a copy of config and a fresh state. Config fields that init or reset read
+// (Monte-Carlo lanes, seed) may be changed in race->engines[id].config before race_reset().
+void race_init(race_t* race, const piAlgoConfig_t* config, int64_t sliceUs, int64_t yieldUs);
+
+// One worker task per core, pinned
+void race_start_workers(race_t* race, UBaseType_t priority, configSTACK_DEPTH_TYPE stackDepth);
+
+// Starts the engines of mask that have not reached digitTarget yet, an engine that was stopped
+// at an earlier target continues where it stopped, its clocks too
+void race_start(race_t* race, uint32_t mask, uint32_t digitTarget);
+
+// An engine's run with its clocks and batch size, what the owner keeps or writes out
+typedef struct {
+    algoSnapshot_t state;
+    uint32_t batch;
+    int64_t elapsedUs;
+    int64_t cpuUs;
+    uint64_t cycles;
+} raceSnapshot_t;
+
+// Copy of an engine's run, also while it runs, after the step under way
+void race_snapshot(race_t* race, piAlgoId_t id, raceSnapshot_t* snapshot);
+
+// Puts a run back into a stopped engine and publishes its result, race_start continues it.
+// False if the snapshot does not fit the engine.
+bool race_restore(race_t* race, piAlgoId_t id, const raceSnapshot_t* snapshot);
+
+// Back to zero terms for every engine, waits until the workers have parked
+void race_reset(race_t* race);
+
+// Takes the latest result of an engine and stops it at digitTarget. True when it stopped now,
+// a step that was already under way may still publish.
+bool race_update(race_t* race, piAlgoId_t id, uint32_t digitTarget);
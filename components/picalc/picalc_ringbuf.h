@@ -0,0 +1,30 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+
+// Lock-free single producer / single consumer byte ring buffer.
+// The producer only writes head, the consumer only writes tail, so neither side ever blocks the other.
+
+typedef struct {
+    uint8_t* data;
+    size_t mask;                // size - 1, size is a power of two
+    atomic_size_t head;         // next slot to write
+    atomic_size_t tail;         // next slot to read
+} ringbuf_t;
+
+// size must be a power of two. Not thread safe, call before producer and consumer run.
+void ringbuf_init(ringbuf_t* rb, uint8_t* storage, size_t size);
+
+size_t ringbuf_count(ringbuf_t* rb);
+size_t ringbuf_space(ringbuf_t* rb);
+
+// Producer side
+bool ringbuf_push(ringbuf_t* rb, uint8_t value);
+size_t ringbuf_write(ringbuf_t* rb, const uint8_t* values, size_t count);
+
+// Consumer side
+bool ringbuf_pop(ringbuf_t* rb, uint8_t* value);
+size_t ringbuf_read(ringbuf_t* rb, uint8_t* values, size_t count);
@@ -0,0 +1,158 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "picalc_ff.h"
+#include "picalc_executor.h"
+
+// Hot loops of the two race series, each continues a running partial sum over a range of terms:
+//   Leibniz  pi/4   = sum_{k >= 0} (-1)^k / (2k + 1)
+//   Basel    pi^2/6 = sum_{k >= 1} 1 / k^2
+// The algo_* engines of the race and the sweep call them through seriesDouble_t or the
+// fixed-point state. The double kernels run soft-float on the ESP32-S3.
+// The float and float-float kernels stay on the single precision FPU, the fixed-point kernels
+// on the integer ALU and come with a guaranteed interval around pi.
+// Term indices are 64-bit, Leibniz passes 2^32 terms before 10 digits. A single call adds at
+// most ALGO_MAX_BATCH terms, so count stays 32-bit.
+
+double series_leibniz_double(double sum, uint64_t start, uint32_t count);
+double series_basel_double(double sum, uint64_t start, uint32_t count);
+
+// Summation strategies for the double kernels, all branch-free in the inner loop:
+//   NAIVE     sum += term, the plain loop
+//   NEUMAIER  Kahan-Babuska: TwoSum of every add, the lost low parts go into a compensation
+//   PAIRWISE  blocks of SERIES_PAIRWISE_BLOCK terms summed as a binary tree, then added
+//   REVERSE   smallest term first within each call, so one call per full range for best effect
+typedef enum {
+    SERIES_SUM_NAIVE,
+    SERIES_SUM_NEUMAIER,
+    SERIES_SUM_PAIRWISE,
+    SERIES_SUM_REVERSE,
+} seriesSumMode_t;
+
+#define SERIES_SUM_MODES        4
+#define SERIES_PAIRWISE_BLOCK   128
+
+typedef struct {
+    seriesSumMode_t mode;
+    double sum;
+    double compensation;    // Neumaier only
+    uint64_t terms;         // terms summed so far, the next call continues from here
+} seriesDouble_t;
+
+const char* series_sum_mode_name(seriesSumMode_t mode);
+
+void series_double_init(seriesDouble_t* s, seriesSumMode_t mode);
+
+void series_leibniz_sum(seriesDouble_t* s, uint32_t count);
+void series_basel_sum(seriesDouble_t* s, uint32_t count);
+
+static inline double series_double_value(const seriesDouble_t* s) {
+    return s->sum + s->compensation;
+}
+
+// Plain float in blocks like float-float, the cheapest format and good for a few digits
+float series_leibniz_float(float sum, uint64_t start, uint32_t count);
+float series_basel_float(float sum, uint64_t start, uint32_t count);
+
+// Terms are exact up to k = 2^24 for Basel, beyond that 1/k^2 is below the last bit anyway
+ff_t series_leibniz_ff(ff_t sum, uint64_t start, uint32_t count);
+ff_t series_basel_ff(ff_t sum, uint64_t start, uint32_t count);
+
+// Q2.62 fixed point: value = x / 2^62, pi is about 0xC90FDAA22168C234
+#define SERIES_FIXED_FRACTION_BITS  62
+#define SERIES_FIXED_ONE            ((uint64_t)1 << SERIES_FIXED_FRACTION_BITS)
+
+// Every term is the truncated integer reciprocal floor(2^62 / d), it is low by less than one unit.
+// The units below/above are summed per term, the exact partial sum is always within
+// [sum - errorBelow, sum + errorAbove].
+typedef struct {
+    uint64_t sum;
+    uint64_t errorBelow;
+    uint64_t errorAbove;
+    uint64_t terms;         // terms summed so far, the next call continues from here
+} seriesFixed_t;
+
+void series_fixed_init(seriesFixed_t* s);
+
+void series_leibniz_fixed(seriesFixed_t* s, uint32_t count);
+void series_basel_fixed(seriesFixed_t* s, uint32_t count);
+
+// Interval [lo, hi] in Q2.62 that contains pi for sure: rounding error of the partial sum plus
+// the remainder of the series (alternating bound for Leibniz, 1/(n+1) < R < 1/n for Basel).
+// While an end is still outside the format the interval is [0, UINT64_MAX], no digit certified.
+void series_leibniz_fixed_pi(const seriesFixed_t* s, uint64_t* lo, uint64_t* hi);
+void series_basel_fixed_pi(const seriesFixed_t* s, uint64_t* lo, uint64_t* hi);
+
+// Decimal places shared by every value in [lo, hi], so the digits of pi that are certain
+uint32_t series_fixed_certified_digits(uint64_t lo, uint64_t hi);
+
+// Q2.62 to double, for display
+double series_fixed_to_double(uint64_t x);
+
+// One running series in any of the number formats, what the race tasks drive
+typedef enum {
+    SERIES_LEIBNIZ,
+    SERIES_BASEL,
+} seriesKind_t;
+
+typedef enum {
+    SERIES_FORMAT_DOUBLE,
+    SERIES_FORMAT_FF,
+    SERIES_FORMAT_FIXED,
+    SERIES_FORMAT_FLOAT,
+    SERIES_FORMAT_ADAPTIVE,     // engine config only: float, float-float, Q2.62 as the digits need
+} seriesFormat_t;
+
+// How series_advance_parallel deals out its chunks to the workers
+typedef enum {
+    SERIES_SPLIT_BLOCKED,       // worker w takes one contiguous run of chunks
+    SERIES_SPLIT_INTERLEAVED,   // worker w takes chunks w, w + workers, ...
+} seriesSplit_t;
+
+// Chunks per parallel call. The chunking only depends on count, so the result is the same
+// bits for any number of workers and either split.
+#define SERIES_PARALLEL_CHUNKS  16
+
+typedef struct {
+    seriesKind_t kind;
+    seriesFormat_t format;
+    seriesDouble_t dbl;
+    ff_t ff;
+    float flt;
+    uint32_t roundings;     // adds at the size of the total since the format took over
+    seriesFixed_t fixed;
+    uint64_t terms;
+    double carried;         // rounding bound of the formats before, series_escalate
+} series_t;
+
+const char* series_format_name(seriesFormat_t format);
+
+// sumMode only matters for SERIES_FORMAT_DOUBLE
+void series_init(series_t* s, seriesKind_t kind, seriesFormat_t format, seriesSumMode_t sumMode);
+
+// Adds count terms and returns the partial sum (pi/4 for Leibniz, pi^2/6 for Basel) as double
+double series_advance(series_t* s, uint32_t count);
+
+// Same, with the count terms cut into SERIES_PARALLEL_CHUNKS chunks summed from zero on
+// `workers` cores (picalc_parallel_run) and merged into the running sum in chunk order
+double series_advance_parallel(series_t* s, uint32_t count, uint32_t workers, seriesSplit_t split);
+
+// Same chunks and merge, the chunks run as tasks on a work-stealing executor and the calling
+// task helps. Gives the same bits as series_advance_parallel.
+double series_advance_executor(series_t* s, uint32_t count, executor_t* ex);
+
+// Bound on |partial sum - exact partial sum| in units of the sum. Every add rounds by at most
+// the unit roundoff of the format (SERIES_FF_EPSILON for float-float) times its result. The
+// adds at the size of the total are counted. The adds inside the blocks stay below the first
+// block, 2 * SERIES_FF_BLOCK of them cover the rounding of all blocks and terms. Neumaier stays
+// at a few ulps, Q2.62 returns its exact error.
+#define SERIES_FF_EPSILON       (1.0 / 17592186044416.0)    // 2^-44, what `picalc_bench ff` holds
+double series_rounding_bound(const series_t* s);
+// The bound once count more terms are summed, for choosing a format ahead of a batch
+double series_rounding_bound_after(const series_t* s, uint32_t count);
+
+// Carries the running sum over to a wider format without losing a term: float to float-float,
+// float-float or double to Q2.62. The rounding bound so far goes along, the terms continue.
+void series_escalate(series_t* s, seriesFormat_t format);
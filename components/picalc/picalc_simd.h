@@ -0,0 +1,79 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "picalc_ff.h"
+
+// Vectorized Leibniz and Basel kernels: several terms per step in independent lanes, every lane
+// keeps its own partial sum and the lanes are added in lane order at the end of each block.
+// Same interface as the scalar kernels in picalc_series.h, the bits differ because the terms are
+// added in a different order.
+//
+// Back ends:
+//   SCALAR  4 lanes in plain C, what the board runs (the PIE vector unit has no float lanes)
+//   SSE2    4 float / 2 double lanes
+//   AVX2    8 float / 4 double lanes, with FMA
+// SERIES_SIMD picks the back end of series_t at compile time from the compiler flags
+// (-mavx2 -mfma for AVX2), or -DSERIES_SIMD=... overrides it. Every x86 host build compiles
+// all three back ends so the benchmark can compare them.
+
+typedef enum {
+    SERIES_SIMD_SCALAR,
+    SERIES_SIMD_SSE2,
+    SERIES_SIMD_AVX2,
+} seriesSimd_t;
+
+#define SERIES_SIMD_BACKENDS    3
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define SERIES_SIMD_HAS_X86     1
+#else
+#define SERIES_SIMD_HAS_X86     0
+#endif
+
+#ifndef SERIES_SIMD
+#if SERIES_SIMD_HAS_X86 && defined(__AVX2__) && defined(__FMA__)
+#define SERIES_SIMD     SERIES_SIMD_AVX2
+#elif SERIES_SIMD_HAS_X86 && defined(__SSE2__)
+#define SERIES_SIMD     SERIES_SIMD_SSE2
+#else
+#define SERIES_SIMD     SERIES_SIMD_SCALAR
+#endif
+#endif
+
+// Float-float kernels, only denominators that are exact as float run in the lanes
+// (k < 2^23 for Leibniz, k < 2^24 for Basel), the rest goes through the scalar kernels
+ff_t series_leibniz_ff_scalar4(ff_t sum, uint64_t start, uint32_t count);
+ff_t series_basel_ff_scalar4(ff_t sum, uint64_t start, uint32_t count);
+double series_leibniz_double_scalar4(double sum, uint64_t start, uint32_t count);
+double series_basel_double_scalar4(double sum, uint64_t start, uint32_t count);
+
+#if SERIES_SIMD_HAS_X86
+ff_t series_leibniz_ff_sse2(ff_t sum, uint64_t start, uint32_t count);
+ff_t series_basel_ff_sse2(ff_t sum, uint64_t start, uint32_t count);
+double series_leibniz_double_sse2(double sum, uint64_t start, uint32_t count);
+double series_basel_double_sse2(double sum, uint64_t start, uint32_t count);
+
+ff_t series_leibniz_ff_avx2(ff_t sum, uint64_t start, uint32_t count);
+ff_t series_basel_ff_avx2(ff_t sum, uint64_t start, uint32_t count);
+double series_leibniz_double_avx2(double sum, uint64_t start, uint32_t count);
+double series_basel_double_avx2(double sum, uint64_t start, uint32_t count);
+#endif
+
+// Compile time dispatch: SERIES_SIMD_FN(series_basel_ff) is the kernel of the chosen back end
+#if SERIES_SIMD == SERIES_SIMD_AVX2
+#define SERIES_SIMD_FN(name)    name##_avx2
+#elif SERIES_SIMD == SERIES_SIMD_SSE2
+#define SERIES_SIMD_FN(name)    name##_sse2
+#else
+#define SERIES_SIMD_FN(name)    name##_scalar4
+#endif
+
+const char* series_simd_name(seriesSimd_t backend);
+
+// Float lanes per step of a back end
+uint32_t series_simd_lanes(seriesSimd_t backend);
+
+// Compiled in and supported by the CPU we run on
+bool series_simd_available(seriesSimd_t backend);
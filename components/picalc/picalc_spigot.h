@@ -0,0 +1,45 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#include "picalc_ringbuf.h"
+
+// Rabinowitz-Wagon spigot. Decimal digits of pi (3, 1, 4, 1, ...) are produced one at a time
+// and only released once no later carry can change them. Memory is a single array of
+// SPIGOT_CELLS(digits) words which the caller provides, nothing is allocated.
+// (Gibbons' unbounded variant was not used because its state grows without limit.)
+
+#define SPIGOT_CELLS(digits)    ((((uint32_t)(digits) + 2) * 10) / 3 + 1)
+
+// A pass computes x = 10 * cell + q * i in 32 bits. Cell i holds less than 2i and the carry q
+// into it is at most 20, so x stays below 40 * SPIGOT_CELLS(digits). That fits a uint32_t for
+// up to 32212252 digits, the limit leaves some room.
+#define SPIGOT_DIGIT_LIMIT      32000000
+
+typedef struct {
+    uint32_t* cells;
+    uint32_t length;        // cells in use
+    uint32_t digits;        // digits to produce, including the leading 3
+    uint32_t steps;         // spigot passes done so far
+    uint32_t emitted;       // digits handed out so far
+    uint8_t predigit;       // held back until the next pass proves it
+    uint32_t nines;         // held back nines following the predigit
+    // pending output of the last pass: lead digit followed by fillCount times fillDigit
+    bool leadPending;
+    uint8_t lead;
+    uint8_t fillDigit;
+    uint32_t fillCount;
+} spigot_t;
+
+// cells must hold SPIGOT_CELLS(digits) entries.
+// false if digits is above SPIGOT_DIGIT_LIMIT, s is left alone then.
+bool spigot_init(spigot_t* s, uint32_t digits, uint32_t* cells);
+
+static inline bool spigot_done(const spigot_t* s) { return s->emitted >= s->digits; }
+
+// Runs spigot passes and pushes finished digits (values 0..9) into rb until either maxDigits
+// digits have been pushed, rb is full or all digits are done. Never blocks.
+// Returns the number of digits pushed.
+uint32_t spigot_generate(spigot_t* s, ringbuf_t* rb, uint32_t maxDigits);
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+
+#include "picalc_algo.h"
+
+// Headless benchmark: every engine of a mask to every digit target, repeats times each, one line
+// of CSV or JSON per configuration. The same code runs on the board (the output goes to the UART)
+// and in picalc_bench on a host, so both sets of numbers come from one harness.
+//
+// Every run starts from a fresh engine state and steps it in batches of about sliceUs until
+// algo_digits() reaches the target. Wall time, CPU time and cycles are summed over the steps and
+// their digit checks. A target that is not reached within timeoutUs ends the sweep of that engine,
+// the larger targets would not be reached either.
+
+#define SWEEP_MAX_REPEATS   16
+#define SWEEP_YIELD_US      50000   // picalc_yield() this often, outside of the measured steps
+
+typedef enum {
+    SWEEP_FORMAT_CSV,
+    SWEEP_FORMAT_JSON,
+} sweepFormat_t;
+
+typedef struct {
+    uint32_t algos;                 // PI_ALGO_MASK bits
+    uint32_t minDigits;
+    uint32_t maxDigits;             // at most ALGO_MAX_DIGITS
+    uint32_t repeats;               // at most SWEEP_MAX_REPEATS
+    int64_t timeoutUs;              // per run
+    int64_t sliceUs;                // step size, the times are quantized to about this
+    piAlgoConfig_t config;          // shared by all engines, each one reads what applies to it
+    sweepFormat_t format;
+    FILE* out;
+    const volatile bool* cancel;    // optional, ends the sweep after the current step
+} sweepConfig_t;
+
+// One engine to one target, the medians are over the runs that reached it
+typedef struct {
+    piAlgoId_t id;
+    uint32_t digits;
+    uint32_t runs;
+    uint32_t reached;
+    uint64_t count;                 // terms, factors or samples
+    int64_t usMin;
+    int64_t usMedian;
+    int64_t usMax;
+    int64_t cpuUs;
+    uint64_t cycles;
+    size_t heapPeak;
+} sweepResult_t;
+
+// Defaults: all engines, 1..10 digits, 3 repeats, 10 s timeout, 1 ms slices, CSV to stdout
+void sweep_default_config(sweepConfig_t* sc);
+
+// Runs one configuration, false if the sweep was cancelled
+bool sweep_measure(const sweepConfig_t* sc, piAlgoId_t id, uint32_t digits, sweepResult_t* result);
+
+// The whole sweep with a header (CSV) or array brackets (JSON), false if it was cancelled
+bool sweep_run(const sweepConfig_t* sc);
+
+void sweep_print_header(const sweepConfig_t* sc);
+void sweep_print_result(const sweepConfig_t* sc, const sweepResult_t* result, bool first);
+void sweep_print_footer(const sweepConfig_t* sc);
@@ -0,0 +1,103 @@
+#include <math.h>
+
+#include "../picalc_accel.h"
+
+const char* accel_mode_name(seriesAccel_t mode) {
+    switch(mode) {
+        case SERIES_ACCEL_NONE:
+            return "raw";
+        case SERIES_ACCEL_EULER:
+            return "Euler";
+        case SERIES_ACCEL_WYNN:
+            return "Wynn";
+        case SERIES_ACCEL_EULER_MACLAURIN:
+            return "E-M";
+    }
+    return "?";
+}
+
+void accel_init(seriesAccelerator_t* acc, seriesAccel_t mode) {
+    acc->mode = mode;
+    acc->count = 0;
+    for(int i = 0; i < ACCEL_WINDOW; i++) {
+        acc->sums[i] = 0.0;
+    }
+}
+
+// Repeated averaging of neighbouring partial sums, levels deep
+static double accel_euler(double* s, uint32_t n, uint32_t levels) {
+    for(uint32_t level = 1; level <= levels; level++) {
+        for(uint32_t i = 0; i < n - level; i++) {
+            s[i] = 0.5 * (s[i] + s[i + 1]);
+        }
+    }
+    return s[0];
+}
+
+// Wynn epsilon table built column by column, the even columns are the estimates
+static double accel_wynn(double* s, uint32_t n) {
+    double previous[ACCEL_WINDOW + 1] = {0.0};
+    double best = s[n - 1];
+    for(uint32_t k = 1; k < n; k++) {
+        for(uint32_t i = 0; i < n - k; i++) {
+            double diff = s[i + 1] - s[i];
+            if(diff == 0.0) {
+                // converged to the last bit, nothing more to gain
+                return best;
+            }
+            double next = previous[i + 1] + 1.0 / diff;
+            previous[i] = s[i];
+            s[i] = next;
+        }
+        previous[n - k] = s[n - k];
+        if((k & 1) == 0) {
+            best = s[n - 1 - k];
+        }
+    }
+    return best;
+}
+
+// The partial sums in the ring, oldest first, returns how many
+static uint32_t accel_window(const seriesAccelerator_t* acc, double* s) {
+    uint32_t n = acc->count < ACCEL_WINDOW ? acc->count : ACCEL_WINDOW;
+    for(uint32_t i = 0; i < n; i++) {
+        s[i] = acc->sums[(acc->count - n + i) % ACCEL_WINDOW];
+    }
+    return n;
+}
+
+double accel_estimate(const seriesAccelerator_t* acc) {
+    if(acc->count == 0) {
+        return 0.0;
+    }
+    double s[ACCEL_WINDOW];
+    uint32_t n = accel_window(acc, s);
+    switch(acc->mode) {
+        case SERIES_ACCEL_EULER:
+            return accel_euler(s, n, n - 1);
+        case SERIES_ACCEL_WYNN:
+            return accel_wynn(s, n);
+        default:
+            return s[n - 1];
+    }
+}
+
+double accel_euler_bound(const seriesAccelerator_t* acc) {
+    if(acc->count < 2) {
+        return INFINITY;
+    }
+    double s[ACCEL_WINDOW];
+    uint32_t n = accel_window(acc, s);
+    accel_euler(s, n, n - 2);
+    return 0.5 * fabs(s[1] - s[0]);
+}
+
+double accel_basel_tail(uint64_t n) {
+    if(n == 0) {
+        return 0.0;
+    }
+    // 1/n - 1/(2n^2) + B2/n^3 + B4/n^5 + B6/n^7 + B8/n^9 with B2 = 1/6, B4 = -1/30, B6 = 1/42, B8 = -1/30
+    double x = 1.0 / (double)n;
+    double x2 = x * x;
+    return x - 0.5 * x2 + x2 * x * (1.0 / 6.0 + x2 * (-1.0 / 30.0 + x2 * (1.0 / 42.0 + x2 * (-1.0 / 30.0))));
+}
@@ -0,0 +1,97 @@
+#include <string.h>
+
+#include "../picalc_agm.h"
+#include "../picalc_bigfloat.h"
+#include "../picalc_port.h"
+
+#define AGM_GUARD_BITS  64
+
+bool agm_compute(uint32_t digits, char* out, size_t outSize, const volatile bool* cancel, agmStats_t* stats) {
+    agmStats_t localStats;
+    if(stats == NULL) {
+        stats = &localStats;
+    }
+    if(outSize < (size_t)digits + 3) {
+        return false;
+    }
+    size_t prec = (size_t)((uint64_t)digits * 33220 / 10000) + AGM_GUARD_BITS;
+    int64_t start = picalc_time_us();
+    memset(stats, 0, sizeof(agmStats_t));
+    stats->digits = digits;
+    stats->precisionBits = (uint32_t)prec;
+
+    bigfloat_t a, b, t, an, d;
+    bigfloat_init(&a);
+    bigfloat_init(&b);
+    bigfloat_init(&t);
+    bigfloat_init(&an);
+    bigfloat_init(&d);
+
+    // a = 1, b = 1/sqrt(2), t = 1/4, p = 2^k
+    bigfloat_set_u32(&a, 1);
+    bigfloat_set_u32(&b, 2);
+    bigfloat_rsqrt(&b, &b, prec);
+    bigfloat_set_u32(&t, 1);
+    bigfloat_mul_2exp(&t, &t, -2);
+    int64_t k = 0;
+
+    bool ok = true;
+    bigfloatProfile_t profile;
+    bigfloat_set_profile(&profile);
+    while(stats->iterations < AGM_MAX_ITERATIONS) {
+        if(cancel != NULL && *cancel) {
+            ok = false;
+            break;
+        }
+        agmIterationStats_t* it = &stats->iteration[stats->iterations++];
+        int64_t iterationStart = picalc_time_us();
+        profile.mulCount = 0;
+        profile.mulUs = 0;
+
+        // an = (a + b) / 2, b = sqrt(a * b), t -= p * (a - an)^2, a = an
+        bigfloat_add(&an, &a, &b, prec);
+        bigfloat_mul_2exp(&an, &an, -1);
+        bigfloat_mul(&b, &a, &b, prec);
+        int64_t sqrtStart = picalc_time_us();
+        bigfloat_sqrt(&b, &b, prec);
+        it->sqrtUs = picalc_time_us() - sqrtStart;
+        bigfloat_sub(&d, &a, &an, prec);
+        bigfloat_mul(&d, &d, &d, prec);
+        bigfloat_mul_2exp(&d, &d, k);
+        bigfloat_sub(&t, &t, &d, prec);
+        bigfloat_copy(&a, &an);
+        k++;
+
+        // the error of the estimate is about (a - b)^2
+        bigfloat_sub(&d, &a, &b, prec);
+        int64_t magnitude = bigfloat_is_zero(&d) ? -(int64_t)prec : bigfloat_magnitude(&d);
+        int64_t correct = (-2 * magnitude * 30103) / 100000;
+        it->digits = (uint32_t)(correct < 0 ? 0 : (correct > digits ? digits : correct));
+        it->mulCount = profile.mulCount;
+        it->mulUs = profile.mulUs;
+        it->timeUs = picalc_time_us() - iterationStart;
+        if(2 * magnitude < -(int64_t)prec) {
+            break;
+        }
+    }
+
+    if(ok) {
+        // pi = (a + b)^2 / 4t
+        int64_t finalStart = picalc_time_us();
+        bigfloat_add(&d, &a, &b, prec);
+        bigfloat_mul(&d, &d, &d, prec);
+        bigfloat_mul_2exp(&t, &t, 2);
+        bigfloat_div(&d, &d, &t, prec);
+        stats->finalUs = picalc_time_us() - finalStart;
+        ok = bigfloat_to_decimal(&d, digits, out, outSize) == (size_t)digits + 2;
+    }
+    bigfloat_set_profile(NULL);
+
+    bigfloat_free(&a);
+    bigfloat_free(&b);
+    bigfloat_free(&t);
+    bigfloat_free(&an);
+    bigfloat_free(&d);
+    stats->timeUs = picalc_time_us() - start;
+    return ok;
+}
@@ -0,0 +1,594 @@
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <float.h>
+
+#include "../picalc_algo.h"
+
+// Rounding floor of the engines that converge to the last bit of a double
+#define ALGO_DOUBLE_FLOOR   (8.0 * DBL_EPSILON * M_PI)
+// Rounding of the float, float-float and double series inside their blocks and of the conversion to
+// pi, on top of series_rounding_bound(). 2^-40 relative stays clear of what `picalc_bench ff`
+// and `picalc_bench sum` measure.
+#define ALGO_SERIES_FLOOR   (M_PI / 1099511627776.0)
+// Viete and Ramanujan gain nothing in double beyond these
+#define VIETE_MAX_FACTORS   40
+#define RAMANUJAN_MAX_TERMS 4
+
+// Leibniz and Basel batches on one core, split over the cores or handed to an executor
+static double algo_series_batch(series_t* series, const piAlgoConfig_t* config, uint32_t count) {
+    if(config->workers > 1 && config->executor != NULL) {
+        return series_advance_executor(series, count, config->executor);
+    }
+    if(config->workers > 1) {
+        return series_advance_parallel(series, count, config->workers, config->split);
+    }
+    return series_advance(series, count);
+}
+
+// SERIES_FORMAT_ADAPTIVE starts on float and widens to float-float and Q2.62 once the rounding
+// bound after the next batch, seen in pi, would take more than a hundredth of the last digit of
+// the target. pi can sit close to a digit boundary, the interval needs most of the digit for itself. The running
+// sum goes along, no term is summed twice.
+static seriesFormat_t algo_series_format(const piAlgoConfig_t* config) {
+    return (config->format == SERIES_FORMAT_ADAPTIVE) ? SERIES_FORMAT_FLOAT : config->format;
+}
+
+static void algo_series_adapt(series_t* series, const piAlgoConfig_t* config, uint32_t count, double scale) {
+    if(config->format != SERIES_FORMAT_ADAPTIVE) {
+        return;
+    }
+    uint32_t target = config->digitTarget;
+    double allowed = 0.01 * pow(10.0, -(double)((target == 0) ? ALGO_MAX_DIGITS : target));
+    while(series->format != SERIES_FORMAT_FIXED && scale * series_rounding_bound_after(series, count) + ALGO_SERIES_FLOOR > allowed) {
+        series_escalate(series, (series->format == SERIES_FORMAT_FLOAT) ? SERIES_FORMAT_FF : SERIES_FORMAT_FIXED);
+    }
+}
+
+// Half width of a Q2.62 interval around pi, seen from the estimate
+static double algo_fixed_bound(double estimate, uint64_t lo, uint64_t hi) {
+    double below = estimate - series_fixed_to_double(lo);
+    double above = series_fixed_to_double(hi) - estimate;
+    return (below > above) ? below : above;
+}
+
+// Q2.62 of value rounded down or up, clamped to the format
+static uint64_t algo_to_fixed(double value, bool roundUp) {
+    if(isnan(value)) {
+        return roundUp ? UINT64_MAX : 0;
+    }
+    if(value <= 0.0) {
+        return 0;
+    }
+    if(value >= 4.0) {
+        return UINT64_MAX;
+    }
+    double scaled = ldexp(value, SERIES_FIXED_FRACTION_BITS);
+    return (uint64_t)(roundUp ? ceil(scaled) : floor(scaled));
+}
+
+// estimate +- bound, one ulp further out for the rounding of the sum and the difference
+static void algo_bound_interval(double estimate, double bound, uint64_t* lo, uint64_t* hi) {
+    *lo = algo_to_fixed(nextafter(estimate - bound, -INFINITY), false);
+    *hi = algo_to_fixed(nextafter(estimate + bound, INFINITY), true);
+}
+
+// Both intervals hold pi, so does their intersection
+static void algo_intersect(uint64_t* lo, uint64_t* hi, uint64_t otherLo, uint64_t otherHi) {
+    *lo = (otherLo > *lo) ? otherLo : *lo;
+    *hi = (otherHi < *hi) ? otherHi : *hi;
+}
+
+// Leibniz: pi/4 = 1 - 1/3 + 1/5 - ..., the last ACCEL_WINDOW terms of every step go one by one
+// into the accelerator
+typedef struct {
+    const piAlgoConfig_t* config;
+    series_t series;
+    seriesAccelerator_t accel;
+    double sum;
+} algoLeibniz_t;
+
+static void leibniz_reset(void* state) {
+    algoLeibniz_t* s = (algoLeibniz_t*)state;
+    series_init(&s->series, SERIES_LEIBNIZ, algo_series_format(s->config), s->config->sumMode);
+    accel_init(&s->accel, SERIES_ACCEL_NONE);
+    s->sum = 0.0;
+}
+
+static void leibniz_init(void* state, const piAlgoConfig_t* config) {
+    ((algoLeibniz_t*)state)->config = config;
+    leibniz_reset(state);
+}
+
+static void leibniz_step(void* state, uint32_t count) {
+    algoLeibniz_t* s = (algoLeibniz_t*)state;
+    algo_series_adapt(&s->series, s->config, count, 4.0);
+    if(count > ACCEL_WINDOW) {
+        algo_series_batch(&s->series, s->config, count - ACCEL_WINDOW);
+        count = ACCEL_WINDOW;
+    }
+    for(uint32_t i = 0; i < count; i++) {
+        s->sum = series_advance(&s->series, 1);
+        accel_push(&s->accel, s->sum);
+    }
+}
+
+static double leibniz_estimate(const void* state) {
+    return 4.0 * ((const algoLeibniz_t*)state)->sum;
+}
+
+static double leibniz_accelerated(const void* state) {
+    const algoLeibniz_t* s = (const algoLeibniz_t*)state;
+    if(s->config->accel != SERIES_ACCEL_EULER && s->config->accel != SERIES_ACCEL_WYNN) {
+        return leibniz_estimate(state);
+    }
+    seriesAccelerator_t accel = s->accel;
+    accel.mode = s->config->accel;
+    return 4.0 * accel_estimate(&accel);
+}
+
+static double leibniz_error_bound(const void* state) {
+    const algoLeibniz_t* s = (const algoLeibniz_t*)state;
+    if(s->series.terms == 0) {
+        return INFINITY;
+    }
+    if(s->series.format == SERIES_FORMAT_FIXED) {
+        uint64_t lo, hi;
+        series_leibniz_fixed_pi(&s->series.fixed, &lo, &hi);
+        return algo_fixed_bound(leibniz_estimate(state), lo, hi);
+    }
+    // alternating series, the first term left out bounds the remainder
+    return 4.0 / (2.0 * (double)s->series.terms + 1.0) + 4.0 * series_rounding_bound(&s->series) + ALGO_SERIES_FLOOR;
+}
+
+static uint64_t leibniz_count(const void* state) {
+    return ((const algoLeibniz_t*)state)->series.terms;
+}
+
+// The interval of the partial sum, narrowed by the Euler bracket. Wynn has no remainder bound,
+// it proves nothing beyond the partial sum.
+static void leibniz_interval(const void* state, uint64_t* lo, uint64_t* hi) {
+    const algoLeibniz_t* s = (const algoLeibniz_t*)state;
+    if(s->series.format == SERIES_FORMAT_FIXED) {
+        series_leibniz_fixed_pi(&s->series.fixed, lo, hi);
+    } else {
+        algo_bound_interval(leibniz_estimate(state), leibniz_error_bound(state), lo, hi);
+    }
+    if(s->config->accel == SERIES_ACCEL_EULER) {
+        seriesAccelerator_t accel = s->accel;
+        accel.mode = SERIES_ACCEL_EULER;
+        uint64_t eulerLo, eulerHi;
+        // the partial sums in the window carry the rounding of the sum, Q2.62 only the one of
+        // the conversion and of the averages
+        double rounding = (s->series.format == SERIES_FORMAT_FIXED) ? ALGO_DOUBLE_FLOOR : ALGO_SERIES_FLOOR;
+        double bound = 4.0 * (accel_euler_bound(&accel) + series_rounding_bound(&s->series)) + rounding;
+        algo_bound_interval(4.0 * accel_estimate(&accel), bound, &eulerLo, &eulerHi);
+        algo_intersect(lo, hi, eulerLo, eulerHi);
+    }
+}
+
+// Basel: pi^2/6 = sum 1/k^2
+typedef struct {
+    const piAlgoConfig_t* config;
+    series_t series;
+    double sum;
+} algoBasel_t;
+
+static void basel_reset(void* state) {
+    algoBasel_t* s = (algoBasel_t*)state;
+    series_init(&s->series, SERIES_BASEL, algo_series_format(s->config), s->config->sumMode);
+    s->sum = 0.0;
+}
+
+static void basel_init(void* state, const piAlgoConfig_t* config) {
+    ((algoBasel_t*)state)->config = config;
+    basel_reset(state);
+}
+
+static void basel_step(void* state, uint32_t count) {
+    algoBasel_t* s = (algoBasel_t*)state;
+    // d/dx sqrt(6x) = 3/pi near pi^2/6
+    algo_series_adapt(&s->series, s->config, count, 1.0);
+    s->sum = algo_series_batch(&s->series, s->config, count);
+}
+
+static double basel_estimate(const void* state) {
+    return sqrt(6.0 * ((const algoBasel_t*)state)->sum);
+}
+
+static double basel_accelerated(const void* state) {
+    const algoBasel_t* s = (const algoBasel_t*)state;
+    if(s->config->accel != SERIES_ACCEL_EULER_MACLAURIN || s->series.terms == 0) {
+        return basel_estimate(state);
+    }
+    return sqrt(6.0 * (s->sum + accel_basel_tail(s->series.terms)));
+}
+
+static double basel_error_bound(const void* state) {
+    const algoBasel_t* s = (const algoBasel_t*)state;
+    if(s->series.terms == 0) {
+        return INFINITY;
+    }
+    if(s->series.format == SERIES_FORMAT_FIXED) {
+        uint64_t lo, hi;
+        series_basel_fixed_pi(&s->series.fixed, &lo, &hi);
+        return algo_fixed_bound(basel_estimate(state), lo, hi);
+    }
+    // the remainder is below 1/n, pi moves less than the sum below it
+    return sqrt(6.0 * (s->sum + 1.0 / (double)s->series.terms)) - basel_estimate(state) +
+           series_rounding_bound(&s->series) + ALGO_SERIES_FLOOR;
+}
+
+static uint64_t basel_count(const void* state) {
+    return ((const algoBasel_t*)state)->series.terms;
+}
+
+// The interval of the partial sum with the remainder between 1/(n+1) and 1/n like Q2.62 does,
+// narrowed by the Euler-Maclaurin tail. ALGO_SERIES_FLOOR is far above the rounding of the tail
+// and the root.
+static void basel_interval(const void* state, uint64_t* lo, uint64_t* hi) {
+    const algoBasel_t* s = (const algoBasel_t*)state;
+    if(s->series.format == SERIES_FORMAT_FIXED) {
+        series_basel_fixed_pi(&s->series.fixed, lo, hi);
+    } else if(s->series.terms == 0) {
+        *lo = 0;
+        *hi = UINT64_MAX;
+    } else {
+        double n = (double)s->series.terms;
+        double rounding = series_rounding_bound(&s->series) + ALGO_SERIES_FLOOR;
+        *lo = algo_to_fixed(nextafter(sqrt(6.0 * (s->sum + 1.0 / (n + 1.0) - rounding)), -INFINITY), false);
+        *hi = algo_to_fixed(nextafter(sqrt(6.0 * (s->sum + 1.0 / n + rounding)), INFINITY), true);
+    }
+    if(s->config->accel == SERIES_ACCEL_EULER_MACLAURIN && s->series.terms > 0) {
+        double sum = s->sum + accel_basel_tail(s->series.terms);
+        double error = 0.08 / pow((double)s->series.terms, 11.0) + series_rounding_bound(&s->series) + ALGO_SERIES_FLOOR;
+        algo_intersect(lo, hi, algo_to_fixed(sqrt(6.0 * (sum - error)), false),
+                       algo_to_fixed(sqrt(6.0 * (sum + error)), true));
+    }
+}
+
+// Nilakantha: pi = 3 + 4/(2*3*4) - 4/(4*5*6) + ..., Neumaier-compensated
+typedef struct {
+    double sum;
+    double compensation;
+    uint64_t terms;
+} algoNilakantha_t;
+
+static void nilakantha_reset(void* state) {
+    algoNilakantha_t* s = (algoNilakantha_t*)state;
+    s->sum = 3.0;
+    s->compensation = 0.0;
+    s->terms = 0;
+}
+
+static void nilakantha_init(void* state, const piAlgoConfig_t* config) {
+    (void)config;
+    nilakantha_reset(state);
+}
+
+static inline double nilakantha_term(uint64_t k) {
+    double d = 2.0 * (double)k + 2.0;
+    return 4.0 / (d * (d + 1.0) * (d + 2.0));
+}
+
+static void nilakantha_step(void* state, uint32_t count) {
+    algoNilakantha_t* s = (algoNilakantha_t*)state;
+    double sum = s->sum;
+    double c = s->compensation;
+    for(uint64_t k = s->terms; k < s->terms + count; k++) {
+        double term = (k & 1) ? -nilakantha_term(k) : nilakantha_term(k);
+        double t = sum + term;
+        double bb = t - sum;
+        c += (sum - (t - bb)) + (term - bb);
+        sum = t;
+    }
+    s->sum = sum;
+    s->compensation = c;
+    s->terms += count;
+}
+
+static double nilakantha_estimate(const void* state) {
+    const algoNilakantha_t* s = (const algoNilakantha_t*)state;
+    return s->sum + s->compensation;
+}
+
+static double nilakantha_error_bound(const void* state) {
+    return nilakantha_term(((const algoNilakantha_t*)state)->terms) + ALGO_DOUBLE_FLOOR;
+}
+
+static uint64_t nilakantha_count(const void* state) {
+    return ((const algoNilakantha_t*)state)->terms;
+}
+
+// Wallis: pi/2 = prod 4k^2 / (4k^2 - 1). Past k = 2^24 a factor 1 + 1/(4k^2 - 1) rounds to 1,
+// so the logarithms of the factors are summed instead, Neumaier-compensated.
+typedef struct {
+    double logSum;
+    double compensation;
+    uint64_t factors;
+} algoWallis_t;
+
+static void wallis_reset(void* state) {
+    algoWallis_t* s = (algoWallis_t*)state;
+    s->logSum = 0.0;
+    s->compensation = 0.0;
+    s->factors = 0;
+}
+
+static void wallis_init(void* state, const piAlgoConfig_t* config) {
+    (void)config;
+    wallis_reset(state);
+}
+
+static void wallis_step(void* state, uint32_t count) {
+    algoWallis_t* s = (algoWallis_t*)state;
+    double sum = s->logSum;
+    double c = s->compensation;
+    for(uint64_t k = s->factors + 1; k <= s->factors + count; k++) {
+        double q = 4.0 * (double)k * (double)k;
+        double term = log1p(1.0 / (q - 1.0));
+        double t = sum + term;
+        double bb = t - sum;
+        c += (sum - (t - bb)) + (term - bb);
+        sum = t;
+    }
+    s->logSum = sum;
+    s->compensation = c;
+    s->factors += count;
+}
+
+static double wallis_estimate(const void* state) {
+    const algoWallis_t* s = (const algoWallis_t*)state;
+    return 2.0 * exp(s->logSum + s->compensation);
+}
+
+static double wallis_error_bound(const void* state) {
+    // 2P < pi < 2P (2n + 2) / (2n + 1)
+    const algoWallis_t* s = (const algoWallis_t*)state;
+    return wallis_estimate(state) / (2.0 * (double)s->factors + 1.0) + ALGO_DOUBLE_FLOOR;
+}
+
+static uint64_t wallis_count(const void* state) {
+    return ((const algoWallis_t*)state)->factors;
+}
+
+// Viete: 2/pi = prod cos(pi / 2^k). The estimate 2^k sin(pi / 2^k) is carried by the half-angle
+// recurrence of sine and cosine, the textbook sqrt(2 - a) form cancels.
+typedef struct {
+    double c;
+    double s;
+    uint32_t factors;
+} algoViete_t;
+
+static void viete_reset(void* state) {
+    algoViete_t* s = (algoViete_t*)state;
+    // angle pi/2
+    s->c = 0.0;
+    s->s = 1.0;
+    s->factors = 0;
+}
+
+static void viete_init(void* state, const piAlgoConfig_t* config) {
+    (void)config;
+    viete_reset(state);
+}
+
+static void viete_step(void* state, uint32_t count) {
+    algoViete_t* s = (algoViete_t*)state;
+    for(uint32_t i = 0; i < count && s->factors < VIETE_MAX_FACTORS; i++) {
+        s->c = sqrt(0.5 * (1.0 + s->c));
+        s->s = s->s / (2.0 * s->c);
+        s->factors++;
+    }
+}
+
+static double viete_estimate(const void* state) {
+    const algoViete_t* s = (const algoViete_t*)state;
+    return ldexp(s->s, (int)s->factors + 1);
+}
+
+static double viete_error_bound(const void* state) {
+    // pi - 2^m sin(pi / 2^m) < pi^3 / (6 * 4^m) with m = factors + 1
+    const algoViete_t* s = (const algoViete_t*)state;
+    return ldexp(M_PI * M_PI * M_PI / 6.0, -2 * ((int)s->factors + 1)) + (s->factors + 1) * ALGO_DOUBLE_FLOOR;
+}
+
+static uint64_t viete_count(const void* state) {
+    return ((const algoViete_t*)state)->factors;
+}
+
+// Ramanujan: 1/pi = 2 sqrt(2)/9801 sum (4k)! (1103 + 26390k) / ((k!)^4 396^(4k)), about 8 digits per term
+typedef struct {
+    double a;           // (4k)! / ((k!)^4 396^(4k)) of the next term
+    double sum;
+    uint32_t terms;
+} algoRamanujan_t;
+
+static void ramanujan_reset(void* state) {
+    algoRamanujan_t* s = (algoRamanujan_t*)state;
+    s->a = 1.0;
+    s->sum = 0.0;
+    s->terms = 0;
+}
+
+static void ramanujan_init(void* state, const piAlgoConfig_t* config) {
+    (void)config;
+    ramanujan_reset(state);
+}
+
+static void ramanujan_step(void* state, uint32_t count) {
+    algoRamanujan_t* s = (algoRamanujan_t*)state;
+    for(uint32_t i = 0; i < count && s->terms < RAMANUJAN_MAX_TERMS; i++) {
+        double k = (double)s->terms;
+        s->sum += s->a * (1103.0 + 26390.0 * k);
+        double k1 = k + 1.0;
+        s->a *= (4.0 * k + 1.0) * (4.0 * k + 2.0) * (4.0 * k + 3.0) * (4.0 * k + 4.0) /
+                (k1 * k1 * k1 * k1 * 24591257856.0);   // 396^4
+        s->terms++;
+    }
+}
+
+static double ramanujan_estimate(const void* state) {
+    const algoRamanujan_t* s = (const algoRamanujan_t*)state;
+    if(s->terms == 0) {
+        return 0.0;
+    }
+    return 9801.0 / (2.0 * M_SQRT2 * s->sum);
+}
+
+static double ramanujan_error_bound(const void* state) {
+    const algoRamanujan_t* s = (const algoRamanujan_t*)state;
+    if(s->terms == 0) {
+        return INFINITY;
+    }
+    // the terms shrink by more than 10^7 each, the next one bounds the remainder of 1/pi with
+    // room to spare, d(pi) = pi^2 d(1/pi)
+    double next = s->a * (1103.0 + 26390.0 * (double)s->terms) * 2.0 * M_SQRT2 / 9801.0;
+    return 2.0 * M_PI * M_PI * next + ALGO_DOUBLE_FLOOR;
+}
+
+static uint64_t ramanujan_count(const void* state) {
+    return ((const algoRamanujan_t*)state)->terms;
+}
+
+// Monte-Carlo: one montecarlo_t lane per worker, the bound is the MONTECARLO_Z confidence
+// interval, a statistical bound and not a guaranteed one
+typedef struct {
+    const piAlgoConfig_t* config;
+    montecarlo_t mc;
+} algoMonteCarlo_t;
+
+static void monte_carlo_reset(void* state) {
+    algoMonteCarlo_t* s = (algoMonteCarlo_t*)state;
+    montecarlo_init(&s->mc, s->config->seed, s->config->workers);
+}
+
+static void monte_carlo_init(void* state, const piAlgoConfig_t* config) {
+    ((algoMonteCarlo_t*)state)->config = config;
+    monte_carlo_reset(state);
+}
+
+static void monte_carlo_step(void* state, uint32_t count) {
+    algoMonteCarlo_t* s = (algoMonteCarlo_t*)state;
+    montecarlo_sample_parallel(&s->mc, count, s->config->executor);
+}
+
+static double monte_carlo_estimate(const void* state) {
+    return montecarlo_estimate(&((const algoMonteCarlo_t*)state)->mc);
+}
+
+static double monte_carlo_error_bound(const void* state) {
+    return montecarlo_half_width(&((const algoMonteCarlo_t*)state)->mc);
+}
+
+static uint64_t monte_carlo_count(const void* state) {
+    return montecarlo_samples(&((const algoMonteCarlo_t*)state)->mc);
+}
+
+static uint32_t monte_carlo_probable_digits(const void* state) {
+    return montecarlo_probable_digits(&((const algoMonteCarlo_t*)state)->mc);
+}
+
+const piAlgo_t piAlgos[PI_ALGO_COUNT] = {
+    [PI_ALGO_LEIBNIZ] = {
+        "Leibniz", "Terms", sizeof(algoLeibniz_t), offsetof(algoLeibniz_t, series), 1000,
+        leibniz_init, leibniz_step, leibniz_estimate, leibniz_error_bound, leibniz_reset, leibniz_count,
+        leibniz_accelerated, leibniz_interval, NULL,
+    },
+    [PI_ALGO_BASEL] = {
+        "Euler", "Terms", sizeof(algoBasel_t), offsetof(algoBasel_t, series), 1000,
+        basel_init, basel_step, basel_estimate, basel_error_bound, basel_reset, basel_count,
+        basel_accelerated, basel_interval, NULL,
+    },
+    [PI_ALGO_NILAKANTHA] = {
+        "Nilakantha", "Terms", sizeof(algoNilakantha_t), 0, 1000,
+        nilakantha_init, nilakantha_step, nilakantha_estimate, nilakantha_error_bound, nilakantha_reset, nilakantha_count,
+        NULL, NULL, NULL,
+    },
+    [PI_ALGO_WALLIS] = {
+        "Wallis", "Factors", sizeof(algoWallis_t), 0, 1000,
+        wallis_init, wallis_step, wallis_estimate, wallis_error_bound, wallis_reset, wallis_count,
+        NULL, NULL, NULL,
+    },
+    [PI_ALGO_VIETE] = {
+        "Viete", "Factors", sizeof(algoViete_t), 0, 1,
+        viete_init, viete_step, viete_estimate, viete_error_bound, viete_reset, viete_count,
+        NULL, NULL, NULL,
+    },
+    [PI_ALGO_RAMANUJAN] = {
+        "Ramanujan", "Terms", sizeof(algoRamanujan_t), 0, 1,
+        ramanujan_init, ramanujan_step, ramanujan_estimate, ramanujan_error_bound, ramanujan_reset, ramanujan_count,
+        NULL, NULL, NULL,
+    },
+    [PI_ALGO_MONTE_CARLO] = {
+        "Monte-Carlo", "Samples", sizeof(algoMonteCarlo_t), offsetof(algoMonteCarlo_t, mc), 1000,
+        monte_carlo_init, monte_carlo_step, monte_carlo_estimate, monte_carlo_error_bound, monte_carlo_reset, monte_carlo_count,
+        NULL, NULL, monte_carlo_probable_digits,
+    },
+};
+
+void* algo_create(const piAlgo_t* algo, const piAlgoConfig_t* config) {
+    void* state = malloc(algo->stateSize);
+    if(state == NULL) {
+        abort();
+    }
+    algo->init(state, config);
+    return state;
+}
+
+piAlgoId_t algo_find(const char* name) {
+    for(uint32_t i = 0; i < PI_ALGO_COUNT; i++) {
+        if(strcmp(piAlgos[i].name, name) == 0) {
+            return (piAlgoId_t)i;
+        }
+    }
+    return PI_ALGO_COUNT;
+}
+
+void algo_snapshot(const piAlgo_t* algo, const void* state, algoSnapshot_t* snapshot) {
+    size_t size = algo->stateSize - algo->runOffset;
+    if(size > ALGO_SNAPSHOT_BYTES) {
+        abort();
+    }
+    snapshot->id = (uint32_t)(algo - piAlgos);
+    snapshot->size = (uint32_t)size;
+    memcpy(snapshot->data, (const uint8_t*)state + algo->runOffset, size);
+}
+
+bool algo_restore(const piAlgo_t* algo, void* state, const algoSnapshot_t* snapshot) {
+    if(snapshot->id != (uint32_t)(algo - piAlgos) || snapshot->size != algo->stateSize - algo->runOffset) {
+        return false;
+    }
+    memcpy((uint8_t*)state + algo->runOffset, snapshot->data, snapshot->size);
+    return true;
+}
+
+uint32_t algo_next_batch(uint32_t batch, int64_t elapsedUs, int64_t sliceUs) {
+    uint64_t next;
+    if(elapsedUs <= 0 || elapsedUs * 4 < sliceUs) {
+        next = (uint64_t)batch * 4;
+    } else {
+        next = (uint64_t)batch * sliceUs / elapsedUs;
+    }
+    if(next < 1) {
+        next = 1;
+    }
+    return (next > ALGO_MAX_BATCH) ? ALGO_MAX_BATCH : (uint32_t)next;
+}
+
+void algo_interval(const piAlgo_t* algo, const void* state, uint64_t* lo, uint64_t* hi) {
+    if(algo->interval != NULL) {
+        algo->interval(state, lo, hi);
+        return;
+    }
+    algo_bound_interval(algo->estimate(state), algo->error_bound(state), lo, hi);
+}
+
+uint32_t algo_digits(const piAlgo_t* algo, const void* state) {
+    if(algo->probable_digits != NULL) {
+        return algo->probable_digits(state);
+    }
+    uint64_t lo, hi;
+    algo_interval(algo, state, &lo, &hi);
+    return series_fixed_certified_digits(lo, hi);
+}
@@ -0,0 +1,127 @@
+#include "../picalc_bbp.h"
+#include "../picalc_port.h"
+
+typedef struct {
+    uint32_t m;
+    uint64_t mu;    // floor((2^64 - 1) / m)
+} barrett_t;
+
+static inline uint64_t mulhi64(uint64_t a, uint64_t b) {
+#ifdef __SIZEOF_INT128__
+    return (uint64_t)(((unsigned __int128)a * b) >> 64);
+#else
+    // 32x32 partial products, the Xtensa core multiplies those natively
+    uint64_t aLo = (uint32_t)a, aHi = a >> 32;
+    uint64_t bLo = (uint32_t)b, bHi = b >> 32;
+    uint64_t p0 = aLo * bLo;
+    uint64_t p1 = aLo * bHi;
+    uint64_t p2 = aHi * bLo;
+    uint64_t p3 = aHi * bHi;
+    uint64_t mid = (p0 >> 32) + (uint32_t)p1 + (uint32_t)p2;
+    return p3 + (p1 >> 32) + (p2 >> 32) + (mid >> 32);
+#endif
+}
+
+static inline void barrett_init(barrett_t* b, uint32_t m) {
+    b->m = m;
+    b->mu = UINT64_MAX / m;
+}
+
+// x mod m for any 64 bit x; the quotient estimate is at most two too small
+static inline uint32_t barrett_reduce(const barrett_t* b, uint64_t x) {
+    uint64_t q = mulhi64(x, b->mu);
+    uint64_t r = x - q * b->m;
+    while(r >= b->m) {
+        r -= b->m;
+    }
+    return (uint32_t)r;
+}
+
+// 16^e mod m, left to right so multiplying by the base is a shift
+static uint32_t bbp_pow16_mod(uint32_t e, const barrett_t* b) {
+    if(b->m == 1) {
+        return 0;
+    }
+    uint64_t r = 1;
+    int bit = 31;
+    while(bit >= 0 && !(e & (1u << bit))) {
+        bit--;
+    }
+    for(; bit >= 0; bit--) {
+        r = barrett_reduce(b, r * r);
+        if(e & (1u << bit)) {
+            r = barrett_reduce(b, r << 4);
+        }
+    }
+    return (uint32_t)r;
+}
+
+// (r / m) * 2^64 for r < m, truncated
+static inline uint64_t bbp_fraction(uint32_t r, uint32_t m) {
+    uint64_t num = (uint64_t)r << 32;
+    uint64_t hi = num / m;
+    uint64_t lo = ((num % m) << 32) / m;
+    return (hi << 32) | lo;
+}
+
+// frac(sum_k 16^(n-k) / (8k + j)) as a 64 bit fraction
+static uint64_t bbp_series(uint32_t n, uint32_t j) {
+    uint64_t sum = 0;
+    barrett_t b;
+    for(uint32_t k = 0; k <= n; k++) {
+        uint32_t m = 8 * k + j;
+        barrett_init(&b, m);
+        sum += bbp_fraction(bbp_pow16_mod(n - k, &b), m);
+    }
+    // tail with negative powers of 16, until the terms fall below 2^-64
+    for(uint32_t k = n + 1, shift = 4; shift < 64; k++, shift += 4) {
+        sum += ((uint64_t)1 << (64 - shift)) / (8 * k + j);
+    }
+    return sum;
+}
+
+uint32_t bbp_eval(uint32_t position) {
+    // 16^n * pi = 4 S1 - 2 S4 - S5 - S6, all taken modulo 1
+    uint64_t x = 4 * bbp_series(position, 1)
+               - 2 * bbp_series(position, 4)
+               - bbp_series(position, 5)
+               - bbp_series(position, 6);
+    return (uint32_t)(x >> 32);
+}
+
+typedef struct {
+    uint32_t position;
+    uint32_t count;
+    char* out;
+} bbpJob_t;
+
+static void bbp_worker(void* arg, uint32_t worker, uint32_t workers) {
+    static const char hex[] = "0123456789ABCDEF";
+    bbpJob_t* job = (bbpJob_t*)arg;
+    uint32_t blocks = (job->count + BBP_HEX_PER_EVAL - 1) / BBP_HEX_PER_EVAL;
+    // round robin keeps the load even although later positions cost more
+    for(uint32_t block = worker; block < blocks; block += workers) {
+        uint32_t offset = block * BBP_HEX_PER_EVAL;
+        uint32_t value = bbp_eval(job->position + offset);
+        for(uint32_t i = 0; i < BBP_HEX_PER_EVAL && offset + i < job->count; i++) {
+            job->out[offset + i] = hex[(value >> (28 - 4 * i)) & 0xF];
+        }
+    }
+}
+
+bool bbp_hex_digits(uint32_t position, uint32_t count, char* out, uint32_t workers) {
+    if(position > BBP_MAX_POSITION || count > BBP_MAX_POSITION - position) {
+        return false;
+    }
+    if(workers == 0) {
+        workers = picalc_core_count();
+    }
+    bbpJob_t job = {
+        .position = position,
+        .count = count,
+        .out = out,
+    };
+    picalc_parallel_run(bbp_worker, &job, workers);
+    out[count] = '\0';
+    return true;
+}
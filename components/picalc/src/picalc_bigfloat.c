@@ -0,0 +1,299 @@
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "../picalc_bigfloat.h"
+#include "../picalc_port.h"
+
+// Extra bits carried through Newton steps and kept on multiplication operands
+#define BIGFLOAT_GUARD_BITS     32
+// Precision a double seed is good for
+#define BIGFLOAT_SEED_BITS      48
+
+static bigfloatProfile_t* bigfloatProfile = NULL;
+
+void bigfloat_set_profile(bigfloatProfile_t* profile) {
+    bigfloatProfile = profile;
+}
+
+void bigfloat_init(bigfloat_t* a) {
+    bigint_init(&a->mant);
+    a->exp = 0;
+}
+
+void bigfloat_free(bigfloat_t* a) {
+    bigint_free(&a->mant);
+    a->exp = 0;
+}
+
+void bigfloat_copy(bigfloat_t* r, const bigfloat_t* a) {
+    bigint_copy(&r->mant, &a->mant);
+    r->exp = a->exp;
+}
+
+static void bigfloat_swap(bigfloat_t* a, bigfloat_t* b) {
+    bigfloat_t t = *a;
+    *a = *b;
+    *b = t;
+}
+
+void bigfloat_set_u32(bigfloat_t* r, uint32_t value) {
+    bigint_set_u64(&r->mant, value);
+    r->exp = 0;
+}
+
+void bigfloat_set_double(bigfloat_t* r, double value) {
+    int e;
+    double f = frexp(value, &e);
+    bigint_set_i64(&r->mant, (int64_t)ldexp(f, 53));
+    r->exp = (int64_t)e - 53;
+}
+
+// a = f * 2^e with 0.5 <= |f| < 1, f carries the top 53 bits of the mantissa
+static double bigfloat_split(const bigfloat_t* a, int64_t* e) {
+    if(bigfloat_is_zero(a)) {
+        *e = 0;
+        return 0.0;
+    }
+    size_t bits = bigint_bit_length(&a->mant);
+    size_t shift = bits > 64 ? bits - 64 : 0;
+    bigint_t top;
+    bigint_init(&top);
+    bigint_shr(&top, &a->mant, shift);
+    int e2;
+    double f = frexp(bigint_to_double(&top), &e2);
+    bigint_free(&top);
+    *e = (int64_t)e2 + (int64_t)shift + a->exp;
+    return f;
+}
+
+double bigfloat_to_double(const bigfloat_t* a) {
+    int64_t e;
+    double f = bigfloat_split(a, &e);
+    if(e > 2000) {
+        return f * INFINITY;
+    }
+    return ldexp(f, e < -2000 ? -2000 : (int)e);
+}
+
+int64_t bigfloat_magnitude(const bigfloat_t* a) {
+    return (int64_t)bigint_bit_length(&a->mant) + a->exp;
+}
+
+void bigfloat_round(bigfloat_t* r, size_t prec) {
+    size_t bits = bigint_bit_length(&r->mant);
+    if(bits > prec) {
+        bigint_shr(&r->mant, &r->mant, bits - prec);
+        r->exp += (int64_t)(bits - prec);
+    }
+    if(bigfloat_is_zero(r)) {
+        r->exp = 0;
+    }
+}
+
+static void bigfloat_add_signed(bigfloat_t* r, const bigfloat_t* a, const bigfloat_t* b, bool subtract, size_t prec) {
+    bigfloat_t t;
+    bigfloat_init(&t);
+    if(bigfloat_is_zero(b) || (!bigfloat_is_zero(a) && bigfloat_magnitude(a) - bigfloat_magnitude(b) > (int64_t)prec + 2)) {
+        // b is below the last bit of the result
+        bigfloat_copy(&t, a);
+    } else if(bigfloat_is_zero(a) || bigfloat_magnitude(b) - bigfloat_magnitude(a) > (int64_t)prec + 2) {
+        bigfloat_copy(&t, b);
+        if(subtract) {
+            t.mant.negative = !t.mant.negative && !bigfloat_is_zero(&t);
+        }
+    } else {
+        bigint_t shifted;
+        bigint_init(&shifted);
+        int64_t e = a->exp < b->exp ? a->exp : b->exp;
+        bigint_shl(&t.mant, &a->mant, (size_t)(a->exp - e));
+        bigint_shl(&shifted, &b->mant, (size_t)(b->exp - e));
+        if(subtract) {
+            bigint_sub(&t.mant, &t.mant, &shifted);
+        } else {
+            bigint_add(&t.mant, &t.mant, &shifted);
+        }
+        t.exp = e;
+        bigint_free(&shifted);
+    }
+    bigfloat_round(&t, prec);
+    bigfloat_swap(r, &t);
+    bigfloat_free(&t);
+}
+
+void bigfloat_add(bigfloat_t* r, const bigfloat_t* a, const bigfloat_t* b, size_t prec) {
+    bigfloat_add_signed(r, a, b, false, prec);
+}
+
+void bigfloat_sub(bigfloat_t* r, const bigfloat_t* a, const bigfloat_t* b, size_t prec) {
+    bigfloat_add_signed(r, a, b, true, prec);
+}
+
+// Operands wider than the result only cost time, cut them down before multiplying
+static const bigfloat_t* bigfloat_truncated(const bigfloat_t* a, bigfloat_t* tmp, size_t prec) {
+    if(bigint_bit_length(&a->mant) <= prec + BIGFLOAT_GUARD_BITS) {
+        return a;
+    }
+    bigfloat_copy(tmp, a);
+    bigfloat_round(tmp, prec + BIGFLOAT_GUARD_BITS);
+    return tmp;
+}
+
+void bigfloat_mul(bigfloat_t* r, const bigfloat_t* a, const bigfloat_t* b, size_t prec) {
+    int64_t start = picalc_time_us();
+    bigfloat_t ta, tb;
+    bigfloat_init(&ta);
+    bigfloat_init(&tb);
+    a = bigfloat_truncated(a, &ta, prec);
+    b = bigfloat_truncated(b, &tb, prec);
+    int64_t exp = a->exp + b->exp;
+    bigint_mul(&r->mant, &a->mant, &b->mant);
+    r->exp = exp;
+    bigfloat_round(r, prec);
+    bigfloat_free(&ta);
+    bigfloat_free(&tb);
+    if(bigfloatProfile != NULL) {
+        bigfloatProfile->mulCount++;
+        bigfloatProfile->mulUs += picalc_time_us() - start;
+    }
+}
+
+void bigfloat_mul_u32(bigfloat_t* r, const bigfloat_t* a, uint32_t m, size_t prec) {
+    bigint_mul_u32(&r->mant, &a->mant, m);
+    r->exp = a->exp;
+    bigfloat_round(r, prec);
+}
+
+void bigfloat_mul_2exp(bigfloat_t* r, const bigfloat_t* a, int64_t shift) {
+    bigfloat_copy(r, a);
+    if(!bigfloat_is_zero(r)) {
+        r->exp += shift;
+    }
+}
+
+void bigfloat_recip(bigfloat_t* r, const bigfloat_t* a, size_t prec) {
+    bigfloat_t x, t, one;
+    bigfloat_init(&x);
+    bigfloat_init(&t);
+    bigfloat_init(&one);
+    bigfloat_set_u32(&one, 1);
+
+    int64_t e;
+    double f = bigfloat_split(a, &e);
+    bigfloat_set_double(&x, 1.0 / f);
+    x.exp -= e;
+
+    // x = x + x * (1 - a * x), every step doubles the correct bits
+    size_t p = BIGFLOAT_SEED_BITS;
+    while(p < prec) {
+        p = (2 * p < prec) ? 2 * p : prec;
+        size_t wp = p + BIGFLOAT_GUARD_BITS;
+        bigfloat_mul(&t, a, &x, wp);
+        bigfloat_sub(&t, &one, &t, wp);
+        bigfloat_mul(&t, &x, &t, wp);
+        bigfloat_add(&x, &x, &t, wp);
+    }
+    bigfloat_round(&x, prec);
+    bigfloat_swap(r, &x);
+    bigfloat_free(&x);
+    bigfloat_free(&t);
+    bigfloat_free(&one);
+}
+
+void bigfloat_div(bigfloat_t* r, const bigfloat_t* a, const bigfloat_t* b, size_t prec) {
+    bigfloat_t inv;
+    bigfloat_init(&inv);
+    bigfloat_recip(&inv, b, prec + BIGFLOAT_GUARD_BITS);
+    bigfloat_mul(r, a, &inv, prec);
+    bigfloat_free(&inv);
+}
+
+void bigfloat_rsqrt(bigfloat_t* r, const bigfloat_t* a, size_t prec) {
+    bigfloat_t y, t, one;
+    bigfloat_init(&y);
+    bigfloat_init(&t);
+    bigfloat_init(&one);
+    bigfloat_set_u32(&one, 1);
+
+    int64_t e;
+    double f = bigfloat_split(a, &e);
+    if(e & 1) {
+        f *= 2.0;
+        e--;
+    }
+    bigfloat_set_double(&y, 1.0 / sqrt(f));
+    y.exp -= e / 2;
+
+    // y = y + y * (1 - a * y^2) / 2
+    size_t p = BIGFLOAT_SEED_BITS;
+    while(p < prec) {
+        p = (2 * p < prec) ? 2 * p : prec;
+        size_t wp = p + BIGFLOAT_GUARD_BITS;
+        bigfloat_mul(&t, &y, &y, wp);
+        bigfloat_mul(&t, a, &t, wp);
+        bigfloat_sub(&t, &one, &t, wp);
+        bigfloat_mul(&t, &y, &t, wp);
+        bigfloat_mul_2exp(&t, &t, -1);
+        bigfloat_add(&y, &y, &t, wp);
+    }
+    bigfloat_round(&y, prec);
+    bigfloat_swap(r, &y);
+    bigfloat_free(&y);
+    bigfloat_free(&t);
+    bigfloat_free(&one);
+}
+
+void bigfloat_sqrt(bigfloat_t* r, const bigfloat_t* a, size_t prec) {
+    if(bigfloat_is_zero(a)) {
+        bigfloat_set_u32(r, 0);
+        return;
+    }
+    bigfloat_t y;
+    bigfloat_init(&y);
+    bigfloat_rsqrt(&y, a, prec + BIGFLOAT_GUARD_BITS);
+    bigfloat_mul(r, a, &y, prec);
+    bigfloat_free(&y);
+}
+
+size_t bigfloat_to_decimal(const bigfloat_t* a, uint32_t digits, char* buf, size_t bufSize) {
+    bigint_t n;
+    bigint_init(&n);
+    // n = floor(a * 10^digits)
+    bigint_pow_u32(&n, 10, digits);
+    bigint_mul(&n, &n, &a->mant);
+    if(a->exp >= 0) {
+        bigint_shl(&n, &n, (size_t)a->exp);
+    } else {
+        bigint_shr(&n, &n, (size_t)-a->exp);
+    }
+
+    size_t maxLength = n.size * BIGINT_LIMB_DIGITS + 2;
+    char* decimal = malloc(maxLength);
+    if(decimal == NULL) {
+        abort();
+    }
+    size_t length = bigint_to_decimal(&n, decimal, maxLength);
+    bigint_free(&n);
+
+    // left pad with zeros so there is at least one integer digit
+    size_t integerDigits = length > digits ? length - digits : 1;
+    size_t padding = integerDigits + digits - length;
+    size_t total = integerDigits + 1 + digits;
+    if(total + 1 > bufSize) {
+        free(decimal);
+        return 0;
+    }
+    size_t pos = 0;
+    for(size_t i = 0; i < integerDigits + digits; i++) {
+        if(i == integerDigits) {
+            buf[pos++] = '.';
+        }
+        buf[pos++] = (i < padding) ? '0' : decimal[i - padding];
+    }
+    if(digits == 0) {
+        buf[pos++] = '.';
+    }
+    buf[pos] = '\0';
+    free(decimal);
+    return pos;
+}
@@ -0,0 +1,907 @@
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "../picalc_bigint.h"
+#include "../picalc_ntt.h"
+#include "../picalc_port.h"
+
+#define LIMB_MAX    ((bigint_limb_t)~(bigint_limb_t)0)
+
+// bigint_to_decimal peels off the largest power of ten that fits a limb
+#if BIGINT_LIMB_BITS == 64
+#define DECIMAL_CHUNK           10000000000000000000u
+#define DECIMAL_CHUNK_DIGITS    19
+#else
+#define DECIMAL_CHUNK           1000000000u
+#define DECIMAL_CHUNK_DIGITS    9
+#endif
+
+/********************************************************************************************* */
+// Raw limb array helpers. Lengths are in limbs, arrays are little endian.
+/********************************************************************************************* */
+
+static int limbs_cmp(const bigint_limb_t* a, size_t an, const bigint_limb_t* b, size_t bn) {
+    if(an != bn) {
+        return an > bn ? 1 : -1;
+    }
+    while(an-- > 0) {
+        if(a[an] != b[an]) {
+            return a[an] > b[an] ? 1 : -1;
+        }
+    }
+    return 0;
+}
+
+// r[0..an] = a + b with an >= bn, returns the carry out of r[an-1]
+static bigint_limb_t limbs_add(bigint_limb_t* r, const bigint_limb_t* a, size_t an, const bigint_limb_t* b, size_t bn) {
+    bigint_limb_t carry = 0;
+    size_t i = 0;
+    for(; i < bn; i++) {
+        bigint_limb_t s = a[i] + carry;
+        carry = (s < carry);
+        s += b[i];
+        carry += (s < b[i]);
+        r[i] = s;
+    }
+    for(; i < an; i++) {
+        bigint_limb_t s = a[i] + carry;
+        carry = (s < carry);
+        r[i] = s;
+    }
+    return carry;
+}
+
+// r[0..an] = a - b with a >= b, returns the borrow (0 if a >= b)
+static bigint_limb_t limbs_sub(bigint_limb_t* r, const bigint_limb_t* a, size_t an, const bigint_limb_t* b, size_t bn) {
+    bigint_limb_t borrow = 0;
+    size_t i = 0;
+    for(; i < bn; i++) {
+        bigint_limb_t x = a[i];
+        bigint_limb_t d = x - b[i];
+        bigint_limb_t b1 = (x < b[i]);
+        bigint_limb_t d2 = d - borrow;
+        borrow = b1 | (d < borrow);
+        r[i] = d2;
+    }
+    for(; i < an; i++) {
+        bigint_limb_t x = a[i];
+        r[i] = x - borrow;
+        borrow = (x < borrow);
+    }
+    return borrow;
+}
+
+// r[0..n] = a * m, returns the high limb
+static bigint_limb_t limbs_mul_1(bigint_limb_t* r, const bigint_limb_t* a, size_t n, bigint_limb_t m) {
+    bigint_limb_t carry = 0;
+    for(size_t i = 0; i < n; i++) {
+        bigint_dlimb_t p = (bigint_dlimb_t)a[i] * m + carry;
+        r[i] = (bigint_limb_t)p;
+        carry = (bigint_limb_t)(p >> BIGINT_LIMB_BITS);
+    }
+    return carry;
+}
+
+// r[0..n] += a * m, returns the high limb
+static bigint_limb_t limbs_addmul_1(bigint_limb_t* r, const bigint_limb_t* a, size_t n, bigint_limb_t m) {
+    bigint_limb_t carry = 0;
+    for(size_t i = 0; i < n; i++) {
+        bigint_dlimb_t p = (bigint_dlimb_t)a[i] * m + r[i] + carry;
+        r[i] = (bigint_limb_t)p;
+        carry = (bigint_limb_t)(p >> BIGINT_LIMB_BITS);
+    }
+    return carry;
+}
+
+// r[0..an+bn] = a * b, r must not overlap a or b
+static void limbs_mul(bigint_limb_t* r, const bigint_limb_t* a, size_t an, const bigint_limb_t* b, size_t bn) {
+    r[an] = limbs_mul_1(r, a, an, b[0]);
+    for(size_t i = 1; i < bn; i++) {
+        r[an + i] = limbs_addmul_1(&r[i], a, an, b[i]);
+    }
+}
+
+// r[0..rn] += a with an <= rn, the carry must not leave r
+static void limbs_add_into(bigint_limb_t* r, size_t rn, const bigint_limb_t* a, size_t an) {
+    while(an > 0 && a[an - 1] == 0) {
+        an--;
+    }
+    if(limbs_add(r, r, rn, a, an) != 0) {
+        abort();
+    }
+}
+
+// r[0..n] = |a - b| for a of an limbs and b of bn <= an limbs, n = an. True if b > a.
+static bool limbs_abs_diff(bigint_limb_t* r, const bigint_limb_t* a, size_t an, const bigint_limb_t* b, size_t bn) {
+    size_t top = an;
+    while(top > bn && a[top - 1] == 0) {
+        top--;
+    }
+    if(top == bn && limbs_cmp(a, bn, b, bn) < 0) {
+        limbs_sub(r, b, bn, a, bn);
+        memset(&r[bn], 0, (an - bn) * sizeof(bigint_limb_t));
+        return true;
+    }
+    limbs_sub(r, a, an, b, bn);
+    return false;
+}
+
+// q[0..n] = a / d, returns the remainder. q may equal a.
+static bigint_limb_t limbs_div_1(bigint_limb_t* q, const bigint_limb_t* a, size_t n, bigint_limb_t d) {
+    bigint_dlimb_t rem = 0;
+    while(n-- > 0) {
+        bigint_dlimb_t num = (rem << BIGINT_LIMB_BITS) | a[n];
+        q[n] = (bigint_limb_t)(num / d);
+        rem = num % d;
+    }
+    return (bigint_limb_t)rem;
+}
+
+static int limb_clz(bigint_limb_t x) {
+    int n = 0;
+    bigint_limb_t mask = (bigint_limb_t)1 << (BIGINT_LIMB_BITS - 1);
+    while(!(x & mask)) {
+        x <<= 1;
+        n++;
+    }
+    return n;
+}
+
+// Knuth, TAOCP Vol. 2, 4.3.1 Algorithm D. u has m+n limbs, v has n >= 2 limbs with v[n-1] != 0.
+// q receives m+1 limbs, r receives n limbs (may be NULL).
+static void limbs_divmod(bigint_limb_t* q, bigint_limb_t* r, const bigint_limb_t* u, size_t un, const bigint_limb_t* v, size_t n) {
+    size_t m = un - n;
+    int s = limb_clz(v[n - 1]);
+    bigint_limb_t* vn = malloc(n * sizeof(bigint_limb_t));
+    bigint_limb_t* unorm = malloc((un + 1) * sizeof(bigint_limb_t));
+    if(vn == NULL || unorm == NULL) {
+        abort();
+    }
+
+    if(s > 0) {
+        for(size_t i = n - 1; i > 0; i--) {
+            vn[i] = (v[i] << s) | (v[i - 1] >> (BIGINT_LIMB_BITS - s));
+        }
+        vn[0] = v[0] << s;
+        unorm[un] = u[un - 1] >> (BIGINT_LIMB_BITS - s);
+        for(size_t i = un - 1; i > 0; i--) {
+            unorm[i] = (u[i] << s) | (u[i - 1] >> (BIGINT_LIMB_BITS - s));
+        }
+        unorm[0] = u[0] << s;
+    } else {
+        memcpy(vn, v, n * sizeof(bigint_limb_t));
+        memcpy(unorm, u, un * sizeof(bigint_limb_t));
+        unorm[un] = 0;
+    }
+
+    const bigint_dlimb_t base = (bigint_dlimb_t)1 << BIGINT_LIMB_BITS;
+    for(size_t j = m + 1; j-- > 0;) {
+        bigint_dlimb_t num = ((bigint_dlimb_t)unorm[j + n] << BIGINT_LIMB_BITS) | unorm[j + n - 1];
+        bigint_dlimb_t qhat = num / vn[n - 1];
+        bigint_dlimb_t rhat = num % vn[n - 1];
+        while(qhat >= base || qhat * vn[n - 2] > ((rhat << BIGINT_LIMB_BITS) | unorm[j + n - 2])) {
+            qhat--;
+            rhat += vn[n - 1];
+            if(rhat >= base) {
+                break;
+            }
+        }
+
+        // unorm[j..j+n] -= qhat * vn
+        bigint_limb_t borrow = 0;
+        bigint_limb_t carry = 0;
+        for(size_t i = 0; i < n; i++) {
+            bigint_dlimb_t p = qhat * vn[i] + carry;
+            carry = (bigint_limb_t)(p >> BIGINT_LIMB_BITS);
+            bigint_limb_t plo = (bigint_limb_t)p;
+            bigint_limb_t x = unorm[i + j];
+            bigint_limb_t d = x - plo;
+            bigint_limb_t b1 = (x < plo);
+            unorm[i + j] = d - borrow;
+            borrow = b1 | (d < borrow);
+        }
+        bigint_limb_t x = unorm[j + n];
+        bigint_limb_t d = x - carry;
+        bigint_limb_t b1 = (x < carry);
+        unorm[j + n] = d - borrow;
+        borrow = b1 | (d < borrow);
+
+        q[j] = (bigint_limb_t)qhat;
+        if(borrow) {
+            // qhat was one too large, add v back
+            q[j]--;
+            unorm[j + n] += limbs_add(&unorm[j], &unorm[j], n, vn, n);
+        }
+    }
+
+    if(r != NULL) {
+        if(s > 0) {
+            for(size_t i = 0; i < n - 1; i++) {
+                r[i] = (unorm[i] >> s) | (unorm[i + 1] << (BIGINT_LIMB_BITS - s));
+            }
+            r[n - 1] = unorm[n - 1] >> s;
+        } else {
+            memcpy(r, unorm, n * sizeof(bigint_limb_t));
+        }
+    }
+    free(vn);
+    free(unorm);
+}
+
+/********************************************************************************************* */
+// bigint_t
+/********************************************************************************************* */
+
+static void bigint_normalize(bigint_t* a) {
+    while(a->size > 0 && a->limbs[a->size - 1] == 0) {
+        a->size--;
+    }
+    if(a->size == 0) {
+        a->negative = false;
+    }
+}
+
+void bigint_init(bigint_t* a) {
+    a->limbs = NULL;
+    a->size = 0;
+    a->capacity = 0;
+    a->negative = false;
+}
+
+void bigint_free(bigint_t* a) {
+    free(a->limbs);
+    bigint_init(a);
+}
+
+void bigint_reserve(bigint_t* a, size_t limbs) {
+    if(limbs <= a->capacity) {
+        return;
+    }
+    size_t capacity = a->capacity * 2;
+    if(capacity < limbs) {
+        capacity = limbs;
+    }
+    bigint_limb_t* p = realloc(a->limbs, capacity * sizeof(bigint_limb_t));
+    if(p == NULL) {
+        abort();
+    }
+    a->limbs = p;
+    a->capacity = capacity;
+}
+
+void bigint_swap(bigint_t* a, bigint_t* b) {
+    bigint_t t = *a;
+    *a = *b;
+    *b = t;
+}
+
+void bigint_copy(bigint_t* r, const bigint_t* a) {
+    if(r == a) {
+        return;
+    }
+    bigint_reserve(r, a->size);
+    if(a->size > 0) {
+        memcpy(r->limbs, a->limbs, a->size * sizeof(bigint_limb_t));
+    }
+    r->size = a->size;
+    r->negative = a->negative;
+}
+
+void bigint_set_u64(bigint_t* r, uint64_t value) {
+    size_t n = (64 + BIGINT_LIMB_BITS - 1) / BIGINT_LIMB_BITS;
+    bigint_reserve(r, n);
+    for(size_t i = 0; i < n; i++) {
+        r->limbs[i] = (bigint_limb_t)value;
+        value = (BIGINT_LIMB_BITS < 64) ? (value >> (BIGINT_LIMB_BITS % 64)) : 0;
+    }
+    r->size = n;
+    r->negative = false;
+    bigint_normalize(r);
+}
+
+void bigint_set_i64(bigint_t* r, int64_t value) {
+    uint64_t magnitude = (value < 0) ? (uint64_t)0 - (uint64_t)value : (uint64_t)value;
+    bigint_set_u64(r, magnitude);
+    r->negative = (value < 0);
+}
+
+size_t bigint_bit_length(const bigint_t* a) {
+    if(a->size == 0) {
+        return 0;
+    }
+    return a->size * BIGINT_LIMB_BITS - limb_clz(a->limbs[a->size - 1]);
+}
+
+double bigint_to_double(const bigint_t* a) {
+    double value = 0.0;
+    // three limbs are more than enough for the 53 bit mantissa
+    size_t low = a->size > 3 ? a->size - 3 : 0;
+    for(size_t i = a->size; i-- > low;) {
+        value = value * ldexp(1.0, BIGINT_LIMB_BITS) + (double)a->limbs[i];
+    }
+    value = ldexp(value, (int)(low * BIGINT_LIMB_BITS));
+    return a->negative ? -value : value;
+}
+
+int bigint_cmp_abs(const bigint_t* a, const bigint_t* b) {
+    return limbs_cmp(a->limbs, a->size, b->limbs, b->size);
+}
+
+int bigint_cmp(const bigint_t* a, const bigint_t* b) {
+    if(a->negative != b->negative) {
+        return a->negative ? -1 : 1;
+    }
+    int c = bigint_cmp_abs(a, b);
+    return a->negative ? -c : c;
+}
+
+static void bigint_add_signed(bigint_t* r, const bigint_t* a, const bigint_t* b, bool bNegative) {
+    bool aNegative = a->negative;
+    if(aNegative == bNegative) {
+        if(a->size < b->size) {
+            const bigint_t* t = a;
+            a = b;
+            b = t;
+        }
+        size_t an = a->size;
+        size_t bn = b->size;
+        bigint_reserve(r, an + 1);
+        r->limbs[an] = limbs_add(r->limbs, a->limbs, an, b->limbs, bn);
+        r->size = an + 1;
+        r->negative = aNegative;
+    } else {
+        bool resultNegative;
+        if(bigint_cmp_abs(a, b) < 0) {
+            const bigint_t* t = a;
+            a = b;
+            b = t;
+            resultNegative = bNegative;
+        } else {
+            resultNegative = aNegative;
+        }
+        size_t an = a->size;
+        size_t bn = b->size;
+        bigint_reserve(r, an);
+        limbs_sub(r->limbs, a->limbs, an, b->limbs, bn);
+        r->size = an;
+        r->negative = resultNegative;
+    }
+    bigint_normalize(r);
+}
+
+void bigint_add(bigint_t* r, const bigint_t* a, const bigint_t* b) {
+    bigint_add_signed(r, a, b, b->negative);
+}
+
+void bigint_sub(bigint_t* r, const bigint_t* a, const bigint_t* b) {
+    bigint_add_signed(r, a, b, !b->negative && b->size > 0);
+}
+
+/********************************************************************************************* */
+// Multiplication: schoolbook, Karatsuba and Toom-3 by the size of the smaller operand
+/********************************************************************************************* */
+
+static const bigintMulThresholds_t bigintMulDefaults = {BIGINT_KARATSUBA_THRESHOLD, BIGINT_TOOM3_THRESHOLD,
+                                                           BIGINT_NTT_THRESHOLD};
+
+static void limbs_mul_auto(bigint_limb_t* r, const bigint_limb_t* a, size_t an, const bigint_limb_t* b, size_t bn,
+                           const bigintMulThresholds_t* thresholds);
+static void bigint_mul_tuned(bigint_t* r, const bigint_t* a, const bigint_t* b, const bigintMulThresholds_t* thresholds);
+
+static void* bigint_scratch(size_t limbs) {
+    bigint_limb_t* p = malloc(limbs * sizeof(bigint_limb_t));
+    if(p == NULL) {
+        abort();
+    }
+    return p;
+}
+
+// a = a1 B^m + a0, b = b1 B^m + b0 with m = ceil(an / 2) < bn:
+// a*b = a0 b0 + (a0 b0 + a1 b1 - (a0 - a1)(b0 - b1)) B^m + a1 b1 B^2m
+static void limbs_mul_karatsuba(bigint_limb_t* r, const bigint_limb_t* a, size_t an, const bigint_limb_t* b, size_t bn,
+                                const bigintMulThresholds_t* thresholds) {
+    size_t m = (an + 1) / 2;
+    size_t a1n = an - m;
+    size_t b1n = bn - m;
+    bigint_limb_t* da = bigint_scratch(6 * m + 1);
+    bigint_limb_t* db = &da[m];
+    bigint_limb_t* z1 = &da[2 * m];
+    bigint_limb_t* middle = &da[4 * m];
+
+    // z0 and z2 go straight to their places in r
+    limbs_mul_auto(r, a, m, b, m, thresholds);
+    if(a1n >= b1n) {
+        limbs_mul_auto(&r[2 * m], &a[m], a1n, &b[m], b1n, thresholds);
+    } else {
+        limbs_mul_auto(&r[2 * m], &b[m], b1n, &a[m], a1n, thresholds);
+    }
+    bool negative = limbs_abs_diff(da, a, m, &a[m], a1n) != limbs_abs_diff(db, b, m, &b[m], b1n);
+    limbs_mul_auto(z1, da, m, db, m, thresholds);
+
+    size_t z2n = a1n + b1n;
+    memcpy(middle, r, 2 * m * sizeof(bigint_limb_t));
+    middle[2 * m] = limbs_add(middle, middle, 2 * m, &r[2 * m], z2n);
+    if(negative) {
+        middle[2 * m] += limbs_add(middle, middle, 2 * m, z1, 2 * m);
+    } else {
+        middle[2 * m] -= limbs_sub(middle, middle, 2 * m, z1, 2 * m);
+    }
+    size_t rest = an + bn - m;
+    limbs_add_into(&r[m], rest, middle, (2 * m + 1 < rest) ? 2 * m + 1 : rest);
+    free(da);
+}
+
+// Part i of the k limb parts of a, a view that may be empty
+static bigint_t bigint_part(const bigint_limb_t* a, size_t an, size_t k, size_t i) {
+    bigint_t part;
+    size_t begin = (i * k < an) ? i * k : an;
+    size_t end = ((i + 1) * k < an) ? (i + 1) * k : an;
+    part.limbs = (bigint_limb_t*)&a[begin];
+    part.size = end - begin;
+    part.capacity = part.size;
+    part.negative = false;
+    while(part.size > 0 && part.limbs[part.size - 1] == 0) {
+        part.size--;
+    }
+    return part;
+}
+
+// Toom-3 with the points 0, 1, -1, -2 and infinity and Bodrato's interpolation. The evaluations
+// are signed, they go through bigint_t.
+static void limbs_mul_toom3(bigint_limb_t* r, const bigint_limb_t* a, size_t an, const bigint_limb_t* b, size_t bn,
+                            const bigintMulThresholds_t* thresholds) {
+    size_t k = (an + 2) / 3;
+    bigint_t a0 = bigint_part(a, an, k, 0), a1 = bigint_part(a, an, k, 1), a2 = bigint_part(a, an, k, 2);
+    bigint_t b0 = bigint_part(b, bn, k, 0), b1 = bigint_part(b, bn, k, 1), b2 = bigint_part(b, bn, k, 2);
+    bigint_t p, q, r0, r1, rm1, rm2, rinf;
+    bigint_init(&p);
+    bigint_init(&q);
+    bigint_init(&r0);
+    bigint_init(&r1);
+    bigint_init(&rm1);
+    bigint_init(&rm2);
+    bigint_init(&rinf);
+
+    bigint_mul_tuned(&r0, &a0, &b0, thresholds);
+    bigint_mul_tuned(&rinf, &a2, &b2, thresholds);
+    // p(1) and p(-1) from a0 + a2
+    bigint_t s, t;
+    bigint_init(&s);
+    bigint_init(&t);
+    bigint_add(&s, &a0, &a2);
+    bigint_add(&t, &b0, &b2);
+    bigint_add(&p, &s, &a1);
+    bigint_add(&q, &t, &b1);
+    bigint_mul_tuned(&r1, &p, &q, thresholds);
+    bigint_sub(&p, &s, &a1);
+    bigint_sub(&q, &t, &b1);
+    bigint_mul_tuned(&rm1, &p, &q, thresholds);
+    // p(-2) = 2 (p(-1) + a2) - a0
+    bigint_add(&p, &p, &a2);
+    bigint_shl(&p, &p, 1);
+    bigint_sub(&p, &p, &a0);
+    bigint_add(&q, &q, &b2);
+    bigint_shl(&q, &q, 1);
+    bigint_sub(&q, &q, &b0);
+    bigint_mul_tuned(&rm2, &p, &q, thresholds);
+
+    // r3 = (rm2 - r1) / 3, r1 = (r1 - rm1) / 2, r2 = rm1 - r0, r3 = (r2 - r3) / 2 + 2 rinf,
+    // r2 = r2 + r1 - rinf, r1 = r1 - r3, the divisions are exact
+    bigint_t* r3 = &rm2;
+    bigint_t* r2 = &s;
+    bigint_sub(r3, &rm2, &r1);
+    bigint_div_u32(r3, r3, 3);
+    bigint_sub(&r1, &r1, &rm1);
+    bigint_shr(&r1, &r1, 1);
+    bigint_sub(r2, &rm1, &r0);
+    bigint_sub(r3, r2, r3);
+    bigint_shr(r3, r3, 1);
+    bigint_shl(&t, &rinf, 1);
+    bigint_add(r3, r3, &t);
+    bigint_add(r2, r2, &r1);
+    bigint_sub(r2, r2, &rinf);
+    bigint_sub(&r1, &r1, r3);
+
+    size_t rn = an + bn;
+    memset(r, 0, rn * sizeof(bigint_limb_t));
+    const bigint_t* coefficients[5] = {&r0, &r1, r2, r3, &rinf};
+    for(size_t i = 0; i < 5; i++) {
+        if(coefficients[i]->size > 0) {
+            limbs_add_into(&r[i * k], rn - i * k, coefficients[i]->limbs, coefficients[i]->size);
+        }
+    }
+    bigint_free(&p);
+    bigint_free(&q);
+    bigint_free(&r0);
+    bigint_free(&r1);
+    bigint_free(&rm1);
+    bigint_free(&rm2);
+    bigint_free(&rinf);
+    bigint_free(&s);
+    bigint_free(&t);
+}
+
+// a much longer than b goes in pieces of bn limbs, each one a balanced product
+static void limbs_mul_unbalanced(bigint_limb_t* r, const bigint_limb_t* a, size_t an, const bigint_limb_t* b, size_t bn,
+                                 const bigintMulThresholds_t* thresholds) {
+    bigint_limb_t* piece = bigint_scratch(2 * bn);
+    memset(r, 0, (an + bn) * sizeof(bigint_limb_t));
+    for(size_t offset = 0; offset < an; offset += bn) {
+        size_t n = (an - offset < bn) ? an - offset : bn;
+        if(n == bn) {
+            limbs_mul_auto(piece, &a[offset], n, b, bn, thresholds);
+        } else {
+            limbs_mul_auto(piece, b, bn, &a[offset], n, thresholds);
+        }
+        limbs_add_into(&r[offset], an + bn - offset, piece, n + bn);
+    }
+    free(piece);
+}
+
+static void limbs_mul_method(bigint_limb_t* r, const bigint_limb_t* a, size_t an, const bigint_limb_t* b, size_t bn,
+                             bigintMul_t method, const bigintMulThresholds_t* thresholds) {
+    // a transform takes any shape, its length is an + bn
+    if((method == BIGINT_MUL_NTT || (method == BIGINT_MUL_AUTO && bn >= thresholds->ntt)) && ntt_mul(r, a, an, b, bn)) {
+        return;
+    }
+    // the splits need b to reach into the upper half of a
+    if(method != BIGINT_MUL_SCHOOLBOOK && bn <= (an + 1) / 2 && bn > 1) {
+        limbs_mul_unbalanced(r, a, an, b, bn, thresholds);
+        return;
+    }
+    if(method == BIGINT_MUL_AUTO) {
+        method = (bn < thresholds->karatsuba) ? BIGINT_MUL_SCHOOLBOOK :
+                 (bn < thresholds->toom3) ? BIGINT_MUL_KARATSUBA : BIGINT_MUL_TOOM3;
+    }
+    if(method >= BIGINT_MUL_TOOM3 && bn >= 3) {
+        limbs_mul_toom3(r, a, an, b, bn, thresholds);
+    } else if(method != BIGINT_MUL_SCHOOLBOOK && bn >= 2) {
+        limbs_mul_karatsuba(r, a, an, b, bn, thresholds);
+    } else {
+        limbs_mul(r, a, an, b, bn);
+    }
+}
+
+static void limbs_mul_auto(bigint_limb_t* r, const bigint_limb_t* a, size_t an, const bigint_limb_t* b, size_t bn,
+                           const bigintMulThresholds_t* thresholds) {
+    limbs_mul_method(r, a, an, b, bn, BIGINT_MUL_AUTO, thresholds);
+}
+
+void bigint_mul_limbs(bigint_limb_t* r, const bigint_limb_t* a, size_t an, const bigint_limb_t* b, size_t bn,
+                      bigintMul_t method, const bigintMulThresholds_t* thresholds) {
+    limbs_mul_method(r, a, an, b, bn, method, (thresholds != NULL) ? thresholds : &bigintMulDefaults);
+}
+
+static void bigint_mul_tuned(bigint_t* r, const bigint_t* a, const bigint_t* b, const bigintMulThresholds_t* thresholds) {
+    if(a->size == 0 || b->size == 0) {
+        r->size = 0;
+        r->negative = false;
+        return;
+    }
+    if(a->size < b->size) {
+        const bigint_t* t = a;
+        a = b;
+        b = t;
+    }
+    bigint_t t;
+    bigint_init(&t);
+    bigint_reserve(&t, a->size + b->size);
+    limbs_mul_auto(t.limbs, a->limbs, a->size, b->limbs, b->size, thresholds);
+    t.size = a->size + b->size;
+    t.negative = a->negative != b->negative;
+    bigint_normalize(&t);
+    bigint_swap(r, &t);
+    bigint_free(&t);
+}
+
+void bigint_mul(bigint_t* r, const bigint_t* a, const bigint_t* b) {
+    bigint_mul_tuned(r, a, b, &bigintMulDefaults);
+}
+
+// Best of a few runs of an n x n product, each run repeats it for about a millisecond
+static double bigint_tune_time(const bigint_limb_t* a, bigint_limb_t* r, size_t n, bigintMul_t method,
+                               const bigintMulThresholds_t* thresholds) {
+    double best = 0.0;
+    for(int run = 0; run < 3; run++) {
+        uint32_t count = 0;
+        int64_t start = picalc_time_us();
+        int64_t elapsed;
+        do {
+            limbs_mul_method(r, a, n, &a[n], n, method, thresholds);
+            count++;
+            elapsed = picalc_time_us() - start;
+        } while(elapsed < 1000);
+        double each = (double)elapsed / count;
+        if(run == 0 || each < best) {
+            best = each;
+        }
+    }
+    return best;
+}
+
+// First size from which fast beats slow for BIGINT_TUNE_WINS sizes in a row, maxLimbs + 1 if never
+#define BIGINT_TUNE_WINS    3
+
+static size_t bigint_tune_crossover(const bigint_limb_t* a, bigint_limb_t* r, size_t from, size_t maxLimbs,
+                                    bigintMul_t slow, bigintMul_t fast, const bigintMulThresholds_t* thresholds,
+                                    const char* label, FILE* out) {
+    size_t crossover = maxLimbs + 1;
+    uint32_t wins = 0;
+    for(size_t n = from; n <= maxLimbs; n += (n < 64) ? 2 : n / 16) {
+        double slowUs = bigint_tune_time(a, r, n, slow, thresholds);
+        double fastUs = bigint_tune_time(a, r, n, fast, thresholds);
+        if(out != NULL) {
+            fprintf(out, "%-10s %6u limbs %12.3f %12.3f us\n", label, (unsigned)n, slowUs, fastUs);
+        }
+        if(fastUs < slowUs) {
+            if(wins++ == 0) {
+                crossover = n;
+            }
+            if(wins == BIGINT_TUNE_WINS) {
+                return crossover;
+            }
+        } else {
+            wins = 0;
+            crossover = maxLimbs + 1;
+        }
+    }
+    return crossover;
+}
+
+void bigint_tune(bigintMulThresholds_t* thresholds, size_t maxLimbs, FILE* out) {
+    bigint_limb_t* a = bigint_scratch(4 * maxLimbs);
+    bigint_limb_t* r = &a[2 * maxLimbs];
+    uint64_t x = 0x9E3779B97F4A7C15ull;
+    for(size_t i = 0; i < 2 * maxLimbs; i++) {
+        x ^= x << 13;
+        x ^= x >> 7;
+        x ^= x << 17;
+        a[i] = (bigint_limb_t)x;
+    }
+    // one level of Karatsuba on schoolbook parts against schoolbook, one level of Toom-3 on tuned
+    // parts against Karatsuba all the way down, then the transforms against the tuned recursion
+    bigintMulThresholds_t t = {maxLimbs + 1, maxLimbs + 1, maxLimbs + 1};
+    if(out != NULL) {
+        fprintf(out, "%-10s %6s %18s %12s\n", "crossover", "", "slower", "faster");
+    }
+    thresholds->karatsuba = bigint_tune_crossover(a, r, 4, maxLimbs, BIGINT_MUL_SCHOOLBOOK, BIGINT_MUL_KARATSUBA, &t,
+                                                  "karatsuba", out);
+    t.karatsuba = thresholds->karatsuba;
+    thresholds->toom3 = bigint_tune_crossover(a, r, thresholds->karatsuba + 1, maxLimbs, BIGINT_MUL_KARATSUBA,
+                                              BIGINT_MUL_TOOM3, &t, "toom3", out);
+    t.toom3 = thresholds->toom3;
+    thresholds->ntt = bigint_tune_crossover(a, r, thresholds->toom3, maxLimbs, BIGINT_MUL_TOOM3, BIGINT_MUL_NTT, &t,
+                                            "ntt", out);
+    free(a);
+}
+
+void bigint_mul_u32(bigint_t* r, const bigint_t* a, uint32_t m) {
+    size_t n = a->size;
+    bool negative = a->negative;
+    bigint_reserve(r, n + 1);
+    r->limbs[n] = limbs_mul_1(r->limbs, a->limbs, n, m);
+    r->size = n + 1;
+    r->negative = negative;
+    bigint_normalize(r);
+}
+
+void bigint_add_u32(bigint_t* r, const bigint_t* a, uint32_t m) {
+    bigint_t t;
+    bigint_limb_t limb = m;
+    t.limbs = &limb;
+    t.size = (m != 0);
+    t.capacity = 1;
+    t.negative = false;
+    bigint_add(r, a, &t);
+}
+
+uint32_t bigint_div_u32(bigint_t* q, const bigint_t* a, uint32_t d) {
+    size_t n = a->size;
+    bool negative = a->negative;
+    bigint_reserve(q, n);
+    uint32_t rem = (uint32_t)limbs_div_1(q->limbs, a->limbs, n, d);
+    q->size = n;
+    q->negative = negative;
+    bigint_normalize(q);
+    return rem;
+}
+
+void bigint_divmod(bigint_t* q, bigint_t* rem, const bigint_t* a, const bigint_t* b) {
+    bool qNegative = a->negative != b->negative;
+    bool rNegative = a->negative;
+    if(bigint_cmp_abs(a, b) < 0) {
+        if(rem != NULL) {
+            bigint_copy(rem, a);
+        }
+        if(q != NULL) {
+            q->size = 0;
+            q->negative = false;
+        }
+        return;
+    }
+    if(b->size == 1) {
+        bigint_t t;
+        bigint_init(&t);
+        bigint_reserve(&t, a->size);
+        bigint_limb_t r = limbs_div_1(t.limbs, a->limbs, a->size, b->limbs[0]);
+        t.size = a->size;
+        bigint_normalize(&t);
+        t.negative = qNegative && t.size > 0;
+        if(rem != NULL) {
+            bigint_set_u64(rem, r);
+            rem->negative = rNegative && r != 0;
+        }
+        if(q != NULL) {
+            bigint_swap(q, &t);
+        }
+        bigint_free(&t);
+        return;
+    }
+
+    bigint_t tq, tr;
+    bigint_init(&tq);
+    bigint_init(&tr);
+    bigint_reserve(&tq, a->size - b->size + 1);
+    bigint_reserve(&tr, b->size);
+    limbs_divmod(tq.limbs, tr.limbs, a->limbs, a->size, b->limbs, b->size);
+    tq.size = a->size - b->size + 1;
+    tq.negative = qNegative;
+    bigint_normalize(&tq);
+    tr.size = b->size;
+    tr.negative = rNegative;
+    bigint_normalize(&tr);
+    if(q != NULL) {
+        bigint_swap(q, &tq);
+    }
+    if(rem != NULL) {
+        bigint_swap(rem, &tr);
+    }
+    bigint_free(&tq);
+    bigint_free(&tr);
+}
+
+void bigint_shl(bigint_t* r, const bigint_t* a, size_t bits) {
+    if(a->size == 0) {
+        r->size = 0;
+        r->negative = false;
+        return;
+    }
+    size_t limbShift = bits / BIGINT_LIMB_BITS;
+    int bitShift = bits % BIGINT_LIMB_BITS;
+    size_t n = a->size;
+    bool negative = a->negative;
+    bigint_reserve(r, n + limbShift + 1);
+    // work from the top so r may alias a
+    const bigint_limb_t* src = (r == a) ? r->limbs : a->limbs;
+    if(bitShift == 0) {
+        memmove(&r->limbs[limbShift], src, n * sizeof(bigint_limb_t));
+        r->limbs[n + limbShift] = 0;
+    } else {
+        r->limbs[n + limbShift] = src[n - 1] >> (BIGINT_LIMB_BITS - bitShift);
+        for(size_t i = n - 1; i > 0; i--) {
+            r->limbs[i + limbShift] = (src[i] << bitShift) | (src[i - 1] >> (BIGINT_LIMB_BITS - bitShift));
+        }
+        r->limbs[limbShift] = src[0] << bitShift;
+    }
+    memset(r->limbs, 0, limbShift * sizeof(bigint_limb_t));
+    r->size = n + limbShift + 1;
+    r->negative = negative;
+    bigint_normalize(r);
+}
+
+void bigint_shr(bigint_t* r, const bigint_t* a, size_t bits) {
+    size_t limbShift = bits / BIGINT_LIMB_BITS;
+    int bitShift = bits % BIGINT_LIMB_BITS;
+    if(limbShift >= a->size) {
+        r->size = 0;
+        r->negative = false;
+        return;
+    }
+    size_t n = a->size - limbShift;
+    bool negative = a->negative;
+    bigint_reserve(r, n);
+    const bigint_limb_t* src = ((r == a) ? r->limbs : a->limbs) + limbShift;
+    if(bitShift == 0) {
+        memmove(r->limbs, src, n * sizeof(bigint_limb_t));
+    } else {
+        for(size_t i = 0; i < n - 1; i++) {
+            r->limbs[i] = (src[i] >> bitShift) | (src[i + 1] << (BIGINT_LIMB_BITS - bitShift));
+        }
+        r->limbs[n - 1] = src[n - 1] >> bitShift;
+    }
+    r->size = n;
+    r->negative = negative;
+    bigint_normalize(r);
+}
+
+void bigint_pow_u32(bigint_t* r, uint32_t base, uint32_t exp) {
+    bigint_t b;
+    bigint_init(&b);
+    bigint_set_u64(&b, base);
+    bigint_set_u64(r, 1);
+    while(exp > 0) {
+        if(exp & 1) {
+            bigint_mul(r, r, &b);
+        }
+        exp >>= 1;
+        if(exp > 0) {
+            bigint_mul(&b, &b, &b);
+        }
+    }
+    bigint_free(&b);
+}
+
+void bigint_sqrt(bigint_t* r, const bigint_t* a) {
+    if(a->size == 0) {
+        r->size = 0;
+        r->negative = false;
+        return;
+    }
+    bigint_t x, y;
+    bigint_init(&x);
+    bigint_init(&y);
+
+    // Start from a power of two above the root, then Newton converges monotonically from above
+    bigint_set_u64(&x, 1);
+    bigint_shl(&x, &x, (bigint_bit_length(a) + 1) / 2);
+    for(;;) {
+        bigint_divmod(&y, NULL, a, &x);
+        bigint_add(&y, &y, &x);
+        bigint_shr(&y, &y, 1);
+        if(bigint_cmp(&y, &x) >= 0) {
+            break;
+        }
+        bigint_swap(&x, &y);
+    }
+    bigint_swap(r, &x);
+    bigint_free(&x);
+    bigint_free(&y);
+}
+
+size_t bigint_to_decimal(const bigint_t* a, char* buf, size_t bufSize) {
+    size_t maxDigits = a->size * BIGINT_LIMB_DIGITS + 1;
+    char* digits = malloc(maxDigits);
+    bigint_limb_t* work = malloc((a->size + 1) * sizeof(bigint_limb_t));
+    if(digits == NULL || work == NULL) {
+        abort();
+    }
+    size_t n = a->size;
+    if(n > 0) {
+        memcpy(work, a->limbs, n * sizeof(bigint_limb_t));
+    }
+
+    // least significant chunk first
+    size_t count = 0;
+    while(n > 0) {
+        bigint_limb_t chunk = limbs_div_1(work, work, n, DECIMAL_CHUNK);
+        while(n > 0 && work[n - 1] == 0) {
+            n--;
+        }
+        for(int i = 0; i < DECIMAL_CHUNK_DIGITS && (n > 0 || chunk > 0); i++) {
+            digits[count++] = '0' + (chunk % 10);
+            chunk /= 10;
+        }
+    }
+    if(count == 0) {
+        digits[count++] = '0';
+    }
+
+    size_t length = count + (a->negative ? 1 : 0);
+    if(length + 1 > bufSize) {
+        free(digits);
+        free(work);
+        return 0;
+    }
+    size_t pos = 0;
+    if(a->negative) {
+        buf[pos++] = '-';
+    }
+    while(count > 0) {
+        buf[pos++] = digits[--count];
+    }
+    buf[pos] = '\0';
+    free(digits);
+    free(work);
+    return length;
+}
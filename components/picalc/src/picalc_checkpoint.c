@@ -0,0 +1,259 @@
+#include <string.h>
+
+#include "../picalc_checkpoint.h"
+#include "../picalc_port.h"
+
+#define CHECKPOINT_RECORD_BYTES (sizeof(checkpointHeader_t) + ALGO_SNAPSHOT_BYTES)
+// the CRC starts after magic and crc
+#define CHECKPOINT_CRC_OFFSET   (2 * sizeof(uint32_t))
+
+uint32_t checkpoint_crc32(uint32_t crc, const void* data, size_t size) {
+    const uint8_t* bytes = data;
+    crc = ~crc;
+    for(size_t i = 0; i < size; i++) {
+        crc ^= bytes[i];
+        for(int bit = 0; bit < 8; bit++) {
+            crc = (crc >> 1) ^ (0xEDB88320u & -(crc & 1));
+        }
+    }
+    return ~crc;
+}
+
+// Reads and programs split at the pages like the flash needs them
+static bool checkpoint_read(checkpoint_t* checkpoint, uint32_t address, void* data, uint32_t size) {
+    const checkpointFlash_t* flash = &checkpoint->flash;
+    uint8_t* bytes = data;
+    while(size > 0) {
+        uint32_t chunk = flash->pageSize - address % flash->pageSize;
+        chunk = (chunk < size) ? chunk : size;
+        if(!flash->read(flash->context, address, bytes, chunk)) {
+            return false;
+        }
+        address += chunk;
+        bytes += chunk;
+        size -= chunk;
+    }
+    return true;
+}
+
+static bool checkpoint_prog(checkpoint_t* checkpoint, uint32_t address, const void* data, uint32_t size) {
+    const checkpointFlash_t* flash = &checkpoint->flash;
+    const uint8_t* bytes = data;
+    while(size > 0) {
+        uint32_t chunk = flash->pageSize - address % flash->pageSize;
+        chunk = (chunk < size) ? chunk : size;
+        checkpoint->stats.pagePrograms++;
+        if(!flash->prog(flash->context, address, bytes, chunk)) {
+            return false;
+        }
+        address += chunk;
+        bytes += chunk;
+        size -= chunk;
+    }
+    return true;
+}
+
+static uint32_t checkpoint_slot_address(const checkpoint_t* checkpoint, piAlgoId_t id, uint32_t slot) {
+    const checkpointEngine_t* engine = &checkpoint->engines[id];
+    uint32_t sector = 2 * id + slot / engine->slots;
+    return checkpoint->flash.base + sector * checkpoint->flash.sectorSize + (slot % engine->slots) * engine->slotSize;
+}
+
+// A slot can be programmed when all of it reads 0xFF, a torn write may have left bits anywhere
+static bool checkpoint_slot_erased(checkpoint_t* checkpoint, uint32_t address, uint32_t size) {
+    uint8_t buffer[64];
+    for(uint32_t offset = 0; offset < size; offset += sizeof(buffer)) {
+        uint32_t chunk = (size - offset < sizeof(buffer)) ? size - offset : sizeof(buffer);
+        if(!checkpoint_read(checkpoint, address + offset, buffer, chunk)) {
+            return false;
+        }
+        for(uint32_t i = 0; i < chunk; i++) {
+            if(buffer[i] != 0xFF) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+static uint32_t checkpoint_record_size(const raceEngine_t* engine) {
+    return (uint32_t)(sizeof(checkpointHeader_t) + engine->algo->stateSize - engine->algo->runOffset);
+}
+
+// What the run data of an engine looks like in this build, a record written by a build where the
+// state of the engine moved or changed its size does not fit it
+static uint32_t checkpoint_layout(const piAlgo_t* algo) {
+    uint32_t fields[3] = {(uint32_t)algo->stateSize, (uint32_t)algo->runOffset, (uint32_t)sizeof(checkpointHeader_t)};
+    uint32_t crc = checkpoint_crc32(0, algo->name, strlen(algo->name));
+    return checkpoint_crc32(crc, fields, sizeof(fields));
+}
+
+// The record of an engine in the slot, false if there is none or it fails its checks
+static bool checkpoint_read_record(checkpoint_t* checkpoint, piAlgoId_t id, uint32_t slot, uint8_t* record) {
+    const raceEngine_t* engine = &checkpoint->race->engines[id];
+    uint32_t size = checkpoint_record_size(engine);
+    uint32_t address = checkpoint_slot_address(checkpoint, id, slot);
+    checkpointHeader_t header;
+    if(!checkpoint_read(checkpoint, address, &header, sizeof(header)) || header.magic != CHECKPOINT_MAGIC ||
+       header.version != CHECKPOINT_VERSION || header.layout != checkpoint_layout(engine->algo) ||
+       header.size != size || header.id != (uint32_t)id) {
+        return false;
+    }
+    if(!checkpoint_read(checkpoint, address, record, size)) {
+        return false;
+    }
+    return checkpoint_crc32(0, &record[CHECKPOINT_CRC_OFFSET], size - CHECKPOINT_CRC_OFFSET) == header.crc;
+}
+
+static void checkpoint_decode(const uint8_t* record, raceSnapshot_t* snapshot) {
+    checkpointHeader_t header;
+    memcpy(&header, record, sizeof(header));
+    snapshot->state.id = header.id;
+    snapshot->state.size = header.size - (uint32_t)sizeof(header);
+    memcpy(snapshot->state.data, &record[sizeof(header)], snapshot->state.size);
+    snapshot->batch = header.batch;
+    snapshot->elapsedUs = header.elapsedUs;
+    snapshot->cpuUs = header.cpuUs;
+    snapshot->cycles = header.cycles;
+}
+
+static bool checkpoint_same(const raceSnapshot_t* a, const raceSnapshot_t* b) {
+    return a->state.id == b->state.id && a->state.size == b->state.size &&
+           memcmp(a->state.data, b->state.data, a->state.size) == 0 && a->batch == b->batch &&
+           a->elapsedUs == b->elapsedUs && a->cpuUs == b->cpuUs && a->cycles == b->cycles;
+}
+
+bool checkpoint_init(checkpoint_t* checkpoint, const checkpointFlash_t* flash, race_t* race) {
+    memset(checkpoint, 0, sizeof(checkpoint_t));
+    checkpoint->flash = *flash;
+    checkpoint->race = race;
+    if(flash->base % flash->sectorSize != 0 || flash->size < CHECKPOINT_SECTORS * flash->sectorSize) {
+        return false;
+    }
+    uint8_t record[CHECKPOINT_RECORD_BYTES];
+    for(uint32_t id = 0; id < PI_ALGO_COUNT; id++) {
+        checkpointEngine_t* engine = &checkpoint->engines[id];
+        uint32_t size = checkpoint_record_size(&race->engines[id]);
+        engine->slotSize = (size + flash->pageSize - 1) / flash->pageSize * flash->pageSize;
+        engine->slots = flash->sectorSize / engine->slotSize;
+        if(size > CHECKPOINT_RECORD_BYTES || engine->slots == 0) {
+            return false;
+        }
+        for(uint32_t slot = 0; slot < 2 * engine->slots; slot++) {
+            if(!checkpoint_read_record(checkpoint, (piAlgoId_t)id, slot, record)) {
+                continue;
+            }
+            checkpointHeader_t header;
+            memcpy(&header, record, sizeof(header));
+            if(header.sequence > engine->sequence) {
+                engine->sequence = header.sequence;
+                engine->newest = slot;
+                checkpoint_decode(record, &engine->saved);
+            }
+        }
+        if(engine->sequence > 0) {
+            engine->next = (engine->newest + 1) % (2 * engine->slots);
+        } else {
+            // a run as it is now needs no record
+            race_snapshot(race, (piAlgoId_t)id, &engine->saved);
+        }
+    }
+    return true;
+}
+
+uint32_t checkpoint_restore(checkpoint_t* checkpoint) {
+    uint32_t restored = 0;
+    for(uint32_t id = 0; id < PI_ALGO_COUNT; id++) {
+        checkpointEngine_t* engine = &checkpoint->engines[id];
+        raceEngine_t* raceEngine = &checkpoint->race->engines[id];
+        if(engine->sequence > 0 && race_restore(checkpoint->race, (piAlgoId_t)id, &engine->saved) &&
+           raceEngine->algo->count(raceEngine->state) > 0) {
+            restored |= PI_ALGO_MASK(id);
+        }
+    }
+    return restored;
+}
+
+// Next slot that takes the record. A slot that is not erased is left over from a torn write and
+// skipped, except the first slot of a sector: the sector holds older records than the newest one
+// and is erased. The sector of the newest record is never erased.
+static bool checkpoint_write(checkpoint_t* checkpoint, piAlgoId_t id, const uint8_t* record, uint32_t size) {
+    checkpointEngine_t* engine = &checkpoint->engines[id];
+    for(uint32_t tries = 0; tries < 2 * engine->slots; tries++) {
+        uint32_t slot = engine->next;
+        uint32_t address = checkpoint_slot_address(checkpoint, id, slot);
+        bool first = slot % engine->slots == 0;
+        if(first && engine->sequence > 0 && slot / engine->slots == engine->newest / engine->slots) {
+            break;
+        }
+        engine->next = (slot + 1) % (2 * engine->slots);
+        if(!checkpoint_slot_erased(checkpoint, address, engine->slotSize)) {
+            if(!first) {
+                continue;
+            }
+            checkpoint->stats.erases++;
+            if(!checkpoint->flash.erase(checkpoint->flash.context, address)) {
+                checkpoint->stats.errors++;
+                continue;
+            }
+        }
+        uint8_t check[CHECKPOINT_RECORD_BYTES];
+        if(!checkpoint_prog(checkpoint, address, record, size) || !checkpoint_read(checkpoint, address, check, size) ||
+           memcmp(check, record, size) != 0) {
+            checkpoint->stats.errors++;
+            continue;
+        }
+        engine->newest = slot;
+        return true;
+    }
+    return false;
+}
+
+bool checkpoint_save(checkpoint_t* checkpoint, piAlgoId_t id) {
+    checkpointEngine_t* engine = &checkpoint->engines[id];
+    raceSnapshot_t snapshot;
+    race_snapshot(checkpoint->race, id, &snapshot);
+    if(checkpoint_same(&snapshot, &engine->saved)) {
+        return false;
+    }
+
+    uint8_t record[CHECKPOINT_RECORD_BYTES];
+    uint32_t size = (uint32_t)sizeof(checkpointHeader_t) + snapshot.state.size;
+    checkpointHeader_t header = {CHECKPOINT_MAGIC, 0, CHECKPOINT_VERSION, checkpoint_layout(checkpoint->race->engines[id].algo),
+                                 engine->sequence + 1, size, (uint32_t)id, snapshot.batch, snapshot.elapsedUs,
+                                 snapshot.cpuUs, snapshot.cycles};
+    memcpy(record, &header, sizeof(header));
+    memcpy(&record[sizeof(header)], snapshot.state.data, snapshot.state.size);
+    header.crc = checkpoint_crc32(0, &record[CHECKPOINT_CRC_OFFSET], size - CHECKPOINT_CRC_OFFSET);
+    memcpy(&record[offsetof(checkpointHeader_t, crc)], &header.crc, sizeof(header.crc));
+
+    int64_t startUs = picalc_time_us();
+    if(!checkpoint_write(checkpoint, id, record, size)) {
+        return false;
+    }
+    int64_t writeUs = picalc_time_us() - startUs;
+    if(writeUs > checkpoint->stats.writeUsMax) {
+        checkpoint->stats.writeUsMax = writeUs;
+    }
+    checkpoint->stats.records++;
+    engine->sequence = header.sequence;
+    engine->saved = snapshot;
+    return true;
+}
+
+static void checkpoint_writer_task(void* param) {
+    checkpoint_t* checkpoint = param;
+    for(;;) {
+        vTaskDelay(pdMS_TO_TICKS(checkpoint->periodMs));
+        for(uint32_t id = 0; id < PI_ALGO_COUNT; id++) {
+            checkpoint_save(checkpoint, (piAlgoId_t)id);
+        }
+    }
+}
+
+void checkpoint_start_writer(checkpoint_t* checkpoint, uint32_t periodMs, UBaseType_t priority,
+                             configSTACK_DEPTH_TYPE stackDepth, BaseType_t core) {
+    checkpoint->periodMs = periodMs;
+    xTaskCreatePinnedToCore(checkpoint_writer_task, "checkpointTask", stackDepth, checkpoint, priority,
+                            &checkpoint->writer, core);
+}
@@ -0,0 +1,136 @@
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "../picalc_bigint.h"
+#include "../picalc_chudnovsky.h"
+
+// Extra decimal places carried through the computation and cut off at the end
+#define CHUDNOVSKY_GUARD_DIGITS     10
+
+#define CHUDNOVSKY_A                13591409u
+#define CHUDNOVSKY_B                545140134u
+#define CHUDNOVSKY_C3_OVER_24       10939058860032000ull
+
+typedef struct {
+    const volatile bool* cancel;
+    uint32_t terms;
+} chudnovskyContext_t;
+
+/*
+ * Binary splitting of the range [a, b):
+ *   P(a,b) = prod p(k), Q(a,b) = prod q(k), T(a,b) = sum a(k) * P(a,k+1) * Q(k+1,b)
+ * P is skipped for the rightmost branch because the final result never needs it.
+ */
+static bool chudnovsky_split(chudnovskyContext_t* ctx, uint32_t a, uint32_t b, bigint_t* P, bigint_t* Q, bigint_t* T, bool needP) {
+    if(ctx->cancel != NULL && *ctx->cancel) {
+        return false;
+    }
+    if(b - a == 1) {
+        if(a == 0) {
+            bigint_set_u64(P, 1);
+            bigint_set_u64(Q, 1);
+        } else {
+            bigint_set_u64(P, 6 * (uint64_t)a - 5);
+            bigint_mul_u32(P, P, 2 * a - 1);
+            bigint_mul_u32(P, P, 6 * a - 1);
+            bigint_set_u64(Q, CHUDNOVSKY_C3_OVER_24);
+            bigint_mul_u32(Q, Q, a);
+            bigint_mul_u32(Q, Q, a);
+            bigint_mul_u32(Q, Q, a);
+        }
+        bigint_t linear;
+        bigint_init(&linear);
+        bigint_set_u64(&linear, CHUDNOVSKY_A + (uint64_t)CHUDNOVSKY_B * a);
+        bigint_mul(T, P, &linear);
+        bigint_free(&linear);
+        if(a & 1) {
+            T->negative = !bigint_is_zero(T);
+        }
+        return true;
+    }
+
+    uint32_t m = a + (b - a) / 2;
+    bigint_t P2, Q2, T2;
+    bigint_init(&P2);
+    bigint_init(&Q2);
+    bigint_init(&T2);
+    bool ok = chudnovsky_split(ctx, a, m, P, Q, T, true) &&
+              chudnovsky_split(ctx, m, b, &P2, &Q2, &T2, needP);
+    if(ok) {
+        // T = T1 * Q2 + P1 * T2
+        bigint_mul(T, T, &Q2);
+        bigint_mul(&T2, P, &T2);
+        bigint_add(T, T, &T2);
+        bigint_mul(Q, Q, &Q2);
+        if(needP) {
+            bigint_mul(P, P, &P2);
+        }
+    }
+    bigint_free(&P2);
+    bigint_free(&Q2);
+    bigint_free(&T2);
+    return ok;
+}
+
+uint32_t chudnovsky_terms_for_digits(uint32_t digits) {
+    return (uint32_t)((digits + CHUDNOVSKY_GUARD_DIGITS) / CHUDNOVSKY_DIGITS_PER_TERM) + 1;
+}
+
+bool chudnovsky_compute(uint32_t digits, char* out, size_t outSize, const volatile bool* cancel, chudnovskyStats_t* stats) {
+    if(outSize < (size_t)digits + 3) {
+        return false;
+    }
+    chudnovskyContext_t ctx = {
+        .cancel = cancel,
+        .terms = chudnovsky_terms_for_digits(digits),
+    };
+
+    bigint_t P, Q, T, scale, root;
+    bigint_init(&P);
+    bigint_init(&Q);
+    bigint_init(&T);
+    bigint_init(&scale);
+    bigint_init(&root);
+
+    bool ok = chudnovsky_split(&ctx, 0, ctx.terms, &P, &Q, &T, false);
+    if(ok) {
+        // pi * 10^n = Q * 426880 * sqrt(10005 * 10^2n) / T
+        uint32_t precision = digits + CHUDNOVSKY_GUARD_DIGITS;
+        bigint_pow_u32(&scale, 10, precision);
+        bigint_mul(&root, &scale, &scale);
+        bigint_mul_u32(&root, &root, 10005);
+        bigint_sqrt(&root, &root);
+        bigint_mul_u32(&Q, &Q, 426880);
+        bigint_mul(&Q, &Q, &root);
+        bigint_divmod(&P, NULL, &Q, &T);
+        ok = !(cancel != NULL && *cancel);
+    }
+    if(ok) {
+        // P now holds floor(pi * 10^precision), digits + guard + 1 decimal characters
+        size_t length = digits + CHUDNOVSKY_GUARD_DIGITS + 2;
+        char* decimal = malloc(length);
+        if(decimal == NULL) {
+            abort();
+        }
+        ok = bigint_to_decimal(&P, decimal, length) == digits + CHUDNOVSKY_GUARD_DIGITS + 1;
+        if(ok) {
+            out[0] = decimal[0];
+            out[1] = '.';
+            memcpy(&out[2], &decimal[1], digits);
+            out[digits + 2] = '\0';
+        }
+        free(decimal);
+    }
+    if(ok && stats != NULL) {
+        stats->digits = digits;
+        stats->terms = ctx.terms;
+    }
+
+    bigint_free(&P);
+    bigint_free(&Q);
+    bigint_free(&T);
+    bigint_free(&scale);
+    bigint_free(&root);
+    return ok;
+}
@@ -0,0 +1,427 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "../picalc_executor.h"
+
+// Empty searches of executor_wait before it blocks for a tick at a time instead of yielding
+#define EXECUTOR_WAIT_SPINS     64
+
+// Worker index of the calling thread in currentExecutor, -1 outside of the executor
+static _Thread_local executor_t* currentExecutor = NULL;
+static _Thread_local int currentWorker = -1;
+
+typedef struct {
+    executor_t* ex;
+    uint32_t index;
+} executorWorkerArg_t;
+
+static void executor_worker_loop(executor_t* ex, uint32_t index);
+
+#ifdef ESP_PLATFORM
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+
+#define EXECUTOR_WORKER_STACK   4096
+
+static void executor_lock(executor_t* ex) {
+    xSemaphoreTake((SemaphoreHandle_t)ex->lock, portMAX_DELAY);
+}
+
+static void executor_unlock(executor_t* ex) {
+    xSemaphoreGive((SemaphoreHandle_t)ex->lock);
+}
+
+static void executor_wake(executor_t* ex) {
+    xSemaphoreGive((SemaphoreHandle_t)ex->wake);
+}
+
+static void executor_sleep(executor_t* ex) {
+    xSemaphoreTake((SemaphoreHandle_t)ex->wake, pdMS_TO_TICKS(10));
+}
+
+static void executor_yield(void) {
+    taskYIELD();
+}
+
+// taskYIELD only gives way to tasks of the same priority, a tick lets the idle task of the core
+// run and feed the task watchdog
+static void executor_idle(void) {
+    vTaskDelay(1);
+}
+
+static void executor_worker_task(void* param) {
+    executorWorkerArg_t arg = *(executorWorkerArg_t*)param;
+    free(param);
+    executor_worker_loop(arg.ex, arg.index);
+    xSemaphoreGive((SemaphoreHandle_t)arg.ex->exited);
+    vTaskDelete(NULL);
+}
+
+static void executor_platform_init(executor_t* ex) {
+    ex->lock = xSemaphoreCreateMutex();
+    ex->wake = xSemaphoreCreateCounting(EXECUTOR_DEQUE_SIZE, 0);
+    ex->exited = xSemaphoreCreateCounting(EXECUTOR_MAX_WORKERS, 0);
+    if(ex->lock == NULL || ex->wake == NULL || ex->exited == NULL) {
+        abort();
+    }
+}
+
+static void executor_start_worker(executor_t* ex, uint32_t index, uint32_t priority) {
+    executorWorkerArg_t* arg = malloc(sizeof(executorWorkerArg_t));
+    if(arg == NULL) {
+        abort();
+    }
+    arg->ex = ex;
+    arg->index = index;
+    TaskHandle_t handle;
+    if(xTaskCreatePinnedToCore(executor_worker_task, "executor", EXECUTOR_WORKER_STACK, arg, priority, &handle, index % portNUM_PROCESSORS) != pdPASS) {
+        abort();
+    }
+    ex->worker[index] = handle;
+}
+
+static void executor_join_worker(executor_t* ex, uint32_t index) {
+    // the worker deletes itself once it sees stop, any worker's exit counts
+    (void)index;
+    executor_wake(ex);
+    xSemaphoreTake((SemaphoreHandle_t)ex->exited, portMAX_DELAY);
+}
+
+static void executor_platform_free(executor_t* ex) {
+    vSemaphoreDelete((SemaphoreHandle_t)ex->lock);
+    vSemaphoreDelete((SemaphoreHandle_t)ex->wake);
+    vSemaphoreDelete((SemaphoreHandle_t)ex->exited);
+}
+
+#else
+
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+
+typedef struct {
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+    uint32_t count;
+} executorWake_t;
+
+static void executor_lock(executor_t* ex) {
+    pthread_mutex_lock((pthread_mutex_t*)ex->lock);
+}
+
+static void executor_unlock(executor_t* ex) {
+    pthread_mutex_unlock((pthread_mutex_t*)ex->lock);
+}
+
+static void executor_wake(executor_t* ex) {
+    executorWake_t* w = (executorWake_t*)ex->wake;
+    pthread_mutex_lock(&w->mutex);
+    if(w->count < EXECUTOR_DEQUE_SIZE) {
+        w->count++;
+    }
+    pthread_cond_signal(&w->cond);
+    pthread_mutex_unlock(&w->mutex);
+}
+
+static void executor_sleep(executor_t* ex) {
+    executorWake_t* w = (executorWake_t*)ex->wake;
+    struct timespec until;
+    clock_gettime(CLOCK_REALTIME, &until);
+    until.tv_nsec += 10000000;
+    if(until.tv_nsec >= 1000000000) {
+        until.tv_sec++;
+        until.tv_nsec -= 1000000000;
+    }
+    pthread_mutex_lock(&w->mutex);
+    if(w->count == 0) {
+        pthread_cond_timedwait(&w->cond, &w->mutex, &until);
+    }
+    if(w->count > 0) {
+        w->count--;
+    }
+    pthread_mutex_unlock(&w->mutex);
+}
+
+static void executor_yield(void) {
+    sched_yield();
+}
+
+// the host scheduler shares the cores by itself
+static void executor_idle(void) {
+    sched_yield();
+}
+
+static void* executor_worker_thread(void* param) {
+    executorWorkerArg_t arg = *(executorWorkerArg_t*)param;
+    free(param);
+    executor_worker_loop(arg.ex, arg.index);
+    return NULL;
+}
+
+static void executor_platform_init(executor_t* ex) {
+    pthread_mutex_t* lock = malloc(sizeof(pthread_mutex_t));
+    executorWake_t* wake = malloc(sizeof(executorWake_t));
+    if(lock == NULL || wake == NULL) {
+        abort();
+    }
+    pthread_mutex_init(lock, NULL);
+    pthread_mutex_init(&wake->mutex, NULL);
+    pthread_cond_init(&wake->cond, NULL);
+    wake->count = 0;
+    ex->lock = lock;
+    ex->wake = wake;
+}
+
+static void executor_start_worker(executor_t* ex, uint32_t index, uint32_t priority) {
+    (void)priority;
+    executorWorkerArg_t* arg = malloc(sizeof(executorWorkerArg_t));
+    pthread_t* thread = malloc(sizeof(pthread_t));
+    if(arg == NULL || thread == NULL) {
+        abort();
+    }
+    arg->ex = ex;
+    arg->index = index;
+    if(pthread_create(thread, NULL, executor_worker_thread, arg) != 0) {
+        abort();
+    }
+    ex->worker[index] = thread;
+}
+
+static void executor_join_worker(executor_t* ex, uint32_t index) {
+    pthread_t* thread = (pthread_t*)ex->worker[index];
+    for(uint32_t i = 0; i < ex->workers; i++) {
+        executor_wake(ex);
+    }
+    pthread_join(*thread, NULL);
+    free(thread);
+}
+
+static void executor_platform_free(executor_t* ex) {
+    executorWake_t* wake = (executorWake_t*)ex->wake;
+    pthread_mutex_destroy((pthread_mutex_t*)ex->lock);
+    pthread_mutex_destroy(&wake->mutex);
+    pthread_cond_destroy(&wake->cond);
+    free(ex->lock);
+    free(wake);
+}
+
+#endif
+
+// Owner side of the deque: push and pop at the bottom
+static bool executor_push(executorDeque_t* d, const executorTask_t* task) {
+    long b = atomic_load_explicit(&d->bottom, memory_order_relaxed);
+    long t = atomic_load_explicit(&d->top, memory_order_acquire);
+    if(b - t >= EXECUTOR_DEQUE_SIZE) {
+        return false;
+    }
+    d->tasks[b & (EXECUTOR_DEQUE_SIZE - 1)] = *task;
+    atomic_thread_fence(memory_order_release);
+    atomic_store_explicit(&d->bottom, b + 1, memory_order_relaxed);
+    return true;
+}
+
+static bool executor_pop(executorDeque_t* d, executorTask_t* task) {
+    long b = atomic_load_explicit(&d->bottom, memory_order_relaxed) - 1;
+    atomic_store_explicit(&d->bottom, b, memory_order_relaxed);
+    atomic_thread_fence(memory_order_seq_cst);
+    long t = atomic_load_explicit(&d->top, memory_order_relaxed);
+    if(t > b) {
+        // empty
+        atomic_store_explicit(&d->bottom, b + 1, memory_order_relaxed);
+        return false;
+    }
+    *task = d->tasks[b & (EXECUTOR_DEQUE_SIZE - 1)];
+    if(t == b) {
+        // last task, race the thieves for it
+        bool won = atomic_compare_exchange_strong_explicit(&d->top, &t, t + 1, memory_order_seq_cst, memory_order_relaxed);
+        atomic_store_explicit(&d->bottom, b + 1, memory_order_relaxed);
+        return won;
+    }
+    return true;
+}
+
+// Thief side: take from the top, any thread
+static bool executor_steal(executorDeque_t* d, executorTask_t* task) {
+    long t = atomic_load_explicit(&d->top, memory_order_acquire);
+    atomic_thread_fence(memory_order_seq_cst);
+    long b = atomic_load_explicit(&d->bottom, memory_order_acquire);
+    if(t >= b) {
+        return false;
+    }
+    *task = d->tasks[t & (EXECUTOR_DEQUE_SIZE - 1)];
+    return atomic_compare_exchange_strong_explicit(&d->top, &t, t + 1, memory_order_seq_cst, memory_order_relaxed);
+}
+
+static bool executor_take_injected(executor_t* ex, executorTask_t* task) {
+    bool found = false;
+    executor_lock(ex);
+    if(ex->injectHead != ex->injectTail) {
+        *task = ex->inject[ex->injectTail & (EXECUTOR_INJECT_SIZE - 1)];
+        ex->injectTail++;
+        found = true;
+    }
+    executor_unlock(ex);
+    return found;
+}
+
+// Own deque first, then the inject queue, then the other workers. self is -1 outside the executor.
+static bool executor_find(executor_t* ex, int self, executorTask_t* task) {
+    if(self >= 0 && executor_pop(&ex->deque[self], task)) {
+        return true;
+    }
+    if(executor_take_injected(ex, task)) {
+        return true;
+    }
+    uint32_t first = (self >= 0) ? (uint32_t)self + 1 : 0;
+    for(uint32_t i = 0; i < ex->workers; i++) {
+        uint32_t victim = (first + i) % ex->workers;
+        if((int)victim != self && executor_steal(&ex->deque[victim], task)) {
+            if(self >= 0) {
+                ex->stats[self].stolen++;
+            }
+            return true;
+        }
+    }
+    return false;
+}
+
+static void executor_run(executor_t* ex, int self, const executorTask_t* task) {
+    task->fn(task->arg);
+    if(self >= 0) {
+        ex->stats[self].executed++;
+    }
+    atomic_fetch_sub_explicit(&task->group->pending, 1, memory_order_release);
+}
+
+static void executor_worker_loop(executor_t* ex, uint32_t index) {
+    currentExecutor = ex;
+    currentWorker = (int)index;
+    executorTask_t task;
+    while(!atomic_load_explicit(&ex->stop, memory_order_acquire)) {
+        if(executor_find(ex, (int)index, &task)) {
+            executor_run(ex, (int)index, &task);
+        } else {
+            executor_sleep(ex);
+        }
+    }
+}
+
+static int executor_self(executor_t* ex) {
+    return (currentExecutor == ex) ? currentWorker : -1;
+}
+
+void executor_init(executor_t* ex, uint32_t workers, uint32_t priority) {
+    memset(ex, 0, sizeof(executor_t));
+    ex->workers = (workers > EXECUTOR_MAX_WORKERS) ? EXECUTOR_MAX_WORKERS : (workers < 1 ? 1 : workers);
+    for(uint32_t w = 0; w < EXECUTOR_MAX_WORKERS; w++) {
+        atomic_init(&ex->deque[w].top, 0);
+        atomic_init(&ex->deque[w].bottom, 0);
+    }
+    atomic_init(&ex->stop, false);
+    executor_platform_init(ex);
+    for(uint32_t w = 0; w < ex->workers; w++) {
+        executor_start_worker(ex, w, priority);
+    }
+}
+
+void executor_shutdown(executor_t* ex) {
+    atomic_store_explicit(&ex->stop, true, memory_order_release);
+    for(uint32_t w = 0; w < ex->workers; w++) {
+        executor_join_worker(ex, w);
+    }
+    executor_platform_free(ex);
+}
+
+void executor_submit(executor_t* ex, executorGroup_t* group, executorFn_t fn, void* arg) {
+    executorTask_t task = {fn, arg, group};
+    atomic_fetch_add_explicit(&group->pending, 1, memory_order_relaxed);
+    int self = executor_self(ex);
+    bool queued = false;
+    if(self >= 0) {
+        queued = executor_push(&ex->deque[self], &task);
+    } else {
+        executor_lock(ex);
+        if(ex->injectHead - ex->injectTail < EXECUTOR_INJECT_SIZE) {
+            ex->inject[ex->injectHead & (EXECUTOR_INJECT_SIZE - 1)] = task;
+            ex->injectHead++;
+            queued = true;
+        }
+        executor_unlock(ex);
+    }
+    if(queued) {
+        executor_wake(ex);
+    } else {
+        // no room, do it right here
+        executor_run(ex, self, &task);
+    }
+}
+
+void executor_wait(executor_t* ex, executorGroup_t* group) {
+    int self = executor_self(ex);
+    executorTask_t task;
+    uint32_t misses = 0;
+    while(atomic_load_explicit(&group->pending, memory_order_acquire) > 0) {
+        if(executor_find(ex, self, &task)) {
+            executor_run(ex, self, &task);
+            misses = 0;
+        } else if(++misses < EXECUTOR_WAIT_SPINS) {
+            executor_yield();
+        } else {
+            // the rest of the group runs elsewhere and may take long, a long NTT or series batch
+            executor_idle();
+        }
+    }
+}
+
+typedef struct {
+    executor_t* ex;
+    uint32_t begin;
+    uint32_t end;
+    uint32_t grain;
+    executorRangeFn_t fn;
+    void* arg;
+} executorRange_t;
+
+static void executor_range(executor_t* ex, uint32_t begin, uint32_t end, uint32_t grain, executorRangeFn_t fn, void* arg);
+
+static void executor_range_task(void* param) {
+    executorRange_t range = *(executorRange_t*)param;
+    free(param);
+    executor_range(range.ex, range.begin, range.end, range.grain, range.fn, range.arg);
+}
+
+// Hands off the upper half until the piece is small enough, runs the rest and waits for the halves
+static void executor_range(executor_t* ex, uint32_t begin, uint32_t end, uint32_t grain, executorRangeFn_t fn, void* arg) {
+    executorGroup_t group;
+    executor_group_init(&group);
+    while(end - begin > grain) {
+        uint32_t mid = begin + (end - begin) / 2;
+        executorRange_t* upper = malloc(sizeof(executorRange_t));
+        if(upper == NULL) {
+            abort();
+        }
+        upper->ex = ex;
+        upper->begin = mid;
+        upper->end = end;
+        upper->grain = grain;
+        upper->fn = fn;
+        upper->arg = arg;
+        executor_submit(ex, &group, executor_range_task, upper);
+        end = mid;
+    }
+    fn(arg, begin, end);
+    executor_wait(ex, &group);
+}
+
+void executor_parallel_for(executor_t* ex, uint32_t begin, uint32_t end, uint32_t grain, executorRangeFn_t fn, void* arg) {
+    if(end <= begin) {
+        return;
+    }
+    executor_range(ex, begin, end, grain < 1 ? 1 : grain, fn, arg);
+}
+
+void executor_reset_stats(executor_t* ex) {
+    memset(ex->stats, 0, sizeof(ex->stats));
+}
@@ -0,0 +1,242 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "../picalc_machin.h"
+#include "../picalc_port.h"
+
+// Fraction limbs beyond the requested digits, absorbs the truncation of every term
+#define MACHIN_GUARD_LIMBS  2
+
+typedef struct {
+    uint32_t count;
+    struct {
+        int32_t coefficient;
+        uint32_t k;
+    } series[MACHIN_MAX_SERIES];
+} machinFormulaDef_t;
+
+static const machinFormulaDef_t machinFormulas[] = {
+    [MACHIN_FORMULA_MACHIN]  = {2, {{16, 5}, {-4, 239}}},
+    [MACHIN_FORMULA_TAKANO]  = {4, {{48, 49}, {128, 57}, {-20, 239}, {48, 110443}}},
+    [MACHIN_FORMULA_STORMER] = {4, {{176, 57}, {28, 239}, {-48, 682}, {96, 12943}}},
+};
+
+typedef struct {
+    const machinFormulaDef_t* formula;
+    uint32_t limbs;
+    uint32_t** sums;
+    machinStats_t* stats;
+    const volatile bool* cancel;
+    volatile bool failed;
+} machinJob_t;
+
+// a[0..top] /= d, most significant limb first
+static inline void fixed_div_small(uint32_t* a, uint32_t top, uint32_t d) {
+    uint64_t rem = 0;
+    for(uint32_t i = top + 1; i-- > 0;) {
+        uint64_t cur = (rem << 32) | a[i];
+        a[i] = (uint32_t)(cur / d);
+        rem = cur % d;
+    }
+}
+
+// dst[0..top] = src[0..top] / d
+static inline void fixed_div_small_to(uint32_t* dst, const uint32_t* src, uint32_t top, uint32_t d) {
+    uint64_t rem = 0;
+    for(uint32_t i = top + 1; i-- > 0;) {
+        uint64_t cur = (rem << 32) | src[i];
+        dst[i] = (uint32_t)(cur / d);
+        rem = cur % d;
+    }
+}
+
+// sum += term or sum -= term, term is zero above top, the carry runs up to limbs
+static inline void fixed_accumulate(uint32_t* sum, const uint32_t* term, uint32_t top, uint32_t limbs, bool subtract) {
+    uint32_t i = 0;
+    if(subtract) {
+        uint32_t borrow = 0;
+        for(; i <= top; i++) {
+            uint64_t d = (uint64_t)sum[i] - term[i] - borrow;
+            sum[i] = (uint32_t)d;
+            borrow = (uint32_t)(d >> 63);
+        }
+        for(; borrow && i < limbs; i++) {
+            borrow = (sum[i] == 0);
+            sum[i]--;
+        }
+    } else {
+        uint32_t carry = 0;
+        for(; i <= top; i++) {
+            uint64_t s = (uint64_t)sum[i] + term[i] + carry;
+            sum[i] = (uint32_t)s;
+            carry = (uint32_t)(s >> 32);
+        }
+        for(; carry && i < limbs; i++) {
+            sum[i]++;
+            carry = (sum[i] == 0);
+        }
+    }
+}
+
+// sum = arctan(1/k) = 1/k - 1/(3k^3) + 1/(5k^5) - ...
+static bool machin_arctan(machinJob_t* job, uint32_t k, uint32_t* sum, machinSeriesStats_t* stats) {
+    uint32_t limbs = job->limbs;
+    uint32_t* power = calloc(limbs, sizeof(uint32_t));
+    uint32_t* term = malloc(limbs * sizeof(uint32_t));
+    if(power == NULL || term == NULL) {
+        free(power);
+        free(term);
+        return false;
+    }
+    bool squareFits = ((uint64_t)k * k) <= UINT32_MAX;
+    uint32_t top = limbs - 1;
+    uint64_t limbOps = 0;
+    uint32_t n = 0;
+    bool ok = true;
+
+    memset(sum, 0, limbs * sizeof(uint32_t));
+    power[limbs - 1] = 1;
+    fixed_div_small(power, top, k);
+    for(;; n++) {
+        // the powers only shrink, skip the limbs that became zero
+        while(top > 0 && power[top] == 0) {
+            top--;
+        }
+        if(top == 0 && power[0] == 0) {
+            break;
+        }
+        if((n & 63) == 0 && job->cancel != NULL && *job->cancel) {
+            ok = false;
+            break;
+        }
+        fixed_div_small_to(term, power, top, 2 * n + 1);
+        fixed_accumulate(sum, term, top, limbs, n & 1);
+        if(squareFits) {
+            fixed_div_small(power, top, k * k);
+            limbOps += 3 * (uint64_t)(top + 1);
+        } else {
+            fixed_div_small(power, top, k);
+            fixed_div_small(power, top, k);
+            limbOps += 4 * (uint64_t)(top + 1);
+        }
+    }
+
+    stats->terms = n;
+    stats->limbOps = limbOps;
+    free(power);
+    free(term);
+    return ok;
+}
+
+static void machin_worker(void* arg, uint32_t worker, uint32_t workers) {
+    machinJob_t* job = (machinJob_t*)arg;
+    for(uint32_t s = worker; s < job->formula->count; s += workers) {
+        machinSeriesStats_t* stats = &job->stats->series[s];
+        int64_t start = picalc_time_us();
+        uint64_t cpuStart = picalc_cpu_time_us();
+        stats->worker = worker;
+        if(!machin_arctan(job, job->formula->series[s].k, job->sums[s], stats)) {
+            job->failed = true;
+        }
+        stats->timeUs = picalc_time_us() - start;
+        stats->cpuUs = (int64_t)picalc_cpu_time_since_us(cpuStart);
+    }
+}
+
+const char* machin_formula_name(machinFormula_t formula) {
+    switch(formula) {
+        case MACHIN_FORMULA_MACHIN:
+            return "Machin";
+        case MACHIN_FORMULA_TAKANO:
+            return "Takano";
+        case MACHIN_FORMULA_STORMER:
+            return "Stormer";
+    }
+    return "?";
+}
+
+bool machin_compute(machinFormula_t formula, uint32_t digits, char* out, size_t outSize, uint32_t workers,
+                    const volatile bool* cancel, machinStats_t* stats) {
+    machinStats_t localStats;
+    if(stats == NULL) {
+        stats = &localStats;
+    }
+    if(outSize < (size_t)digits + 3 || formula > MACHIN_FORMULA_STORMER) {
+        return false;
+    }
+    const machinFormulaDef_t* def = &machinFormulas[formula];
+    // log2(10) = 3.3219..., one integer limb on top
+    uint32_t limbs = (uint32_t)(((uint64_t)digits * 33220 / 10000 + 31) / 32) + MACHIN_GUARD_LIMBS + 1;
+    int64_t start = picalc_time_us();
+
+    memset(stats, 0, sizeof(machinStats_t));
+    stats->digits = digits;
+    stats->limbs = limbs;
+    stats->seriesCount = def->count;
+    uint32_t* sums[MACHIN_MAX_SERIES] = {NULL};
+    uint32_t* pi = calloc(limbs, sizeof(uint32_t));
+    bool ok = (pi != NULL);
+    for(uint32_t s = 0; s < def->count; s++) {
+        stats->series[s].k = def->series[s].k;
+        stats->series[s].coefficient = def->series[s].coefficient;
+        sums[s] = malloc(limbs * sizeof(uint32_t));
+        ok = ok && (sums[s] != NULL);
+    }
+
+    if(ok) {
+        machinJob_t job = {
+            .formula = def,
+            .limbs = limbs,
+            .sums = sums,
+            .stats = stats,
+            .cancel = cancel,
+            .failed = false,
+        };
+        picalc_parallel_run(machin_worker, &job, workers == 0 ? def->count : workers);
+        ok = !job.failed;
+    }
+
+    if(ok) {
+        // pi = sum c_i * atan(1/k_i), always in series order so the result is reproducible
+        for(uint32_t s = 0; s < def->count; s++) {
+            int32_t c = def->series[s].coefficient;
+            uint32_t m = (uint32_t)(c < 0 ? -c : c);
+            uint32_t carry = 0;
+            for(uint32_t i = 0; i < limbs; i++) {
+                uint64_t p = (uint64_t)sums[s][i] * m + carry;
+                sums[s][i] = (uint32_t)p;
+                carry = (uint32_t)(p >> 32);
+            }
+            fixed_accumulate(pi, sums[s], limbs - 1, limbs, c < 0);
+        }
+
+        // integer limb first, then 9 decimals at a time out of the fraction limbs
+        out[0] = '0' + (char)pi[limbs - 1];
+        out[1] = '.';
+        uint32_t written = 0;
+        while(written < digits) {
+            uint32_t carry = 0;
+            for(uint32_t i = 0; i < limbs - 1; i++) {
+                uint64_t p = (uint64_t)pi[i] * 1000000000u + carry;
+                pi[i] = (uint32_t)p;
+                carry = (uint32_t)(p >> 32);
+            }
+            char chunk[10];
+            for(int i = 8; i >= 0; i--) {
+                chunk[i] = '0' + (char)(carry % 10);
+                carry /= 10;
+            }
+            for(int i = 0; i < 9 && written < digits; i++) {
+                out[2 + written++] = chunk[i];
+            }
+        }
+        out[2 + digits] = '\0';
+    }
+
+    for(uint32_t s = 0; s < def->count; s++) {
+        free(sums[s]);
+    }
+    free(pi);
+    stats->timeUs = picalc_time_us() - start;
+    return ok;
+}
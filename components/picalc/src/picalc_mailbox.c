@@ -0,0 +1,41 @@
+#include <string.h>
+
+#include "../picalc_mailbox.h"
+
+// A torn read means the writer published during the copy, the next attempt almost always succeeds
+#define MAILBOX_READ_RETRIES    4
+
+void mailbox_init(mailbox_t* mb, void* storage, size_t size) {
+    atomic_init(&mb->sequence, 0);
+    mb->data = storage;
+    mb->size = size;
+    memset(storage, 0, size);
+}
+
+void mailbox_publish(mailbox_t* mb, const void* value) {
+    unsigned sequence = atomic_load_explicit(&mb->sequence, memory_order_relaxed);
+    atomic_store_explicit(&mb->sequence, sequence + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    memcpy(mb->data, value, mb->size);
+    atomic_store_explicit(&mb->sequence, sequence + 2, memory_order_release);
+}
+
+bool mailbox_read(mailbox_t* mb, void* out, uint32_t* lastSequence) {
+    for(int retry = 0; retry < MAILBOX_READ_RETRIES; retry++) {
+        unsigned before = atomic_load_explicit(&mb->sequence, memory_order_acquire);
+        if(before == *lastSequence) {
+            return false;
+        }
+        if(before & 1) {
+            continue;
+        }
+        memcpy(out, mb->data, mb->size);
+        atomic_thread_fence(memory_order_acquire);
+        unsigned after = atomic_load_explicit(&mb->sequence, memory_order_relaxed);
+        if(before == after) {
+            *lastSequence = before;
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,202 @@
+#include <stddef.h>
+#include <math.h>
+
+#include "../picalc_montecarlo.h"
+#include "../picalc_port.h"
+
+static uint64_t montecarlo_splitmix64(uint64_t* x) {
+    uint64_t z = (*x += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+void xoshiro128_seed(xoshiro128_t* x, uint64_t seed) {
+    uint64_t a = montecarlo_splitmix64(&seed);
+    uint64_t b = montecarlo_splitmix64(&seed);
+    x->s[0] = (uint32_t)a;
+    x->s[1] = (uint32_t)(a >> 32);
+    x->s[2] = (uint32_t)b;
+    x->s[3] = (uint32_t)(b >> 32);
+    if((x->s[0] | x->s[1] | x->s[2] | x->s[3]) == 0) {
+        x->s[0] = 1;
+    }
+}
+
+void xoshiro128_jump(xoshiro128_t* x) {
+    static const uint32_t jump[4] = {0x8764000b, 0xf542d2d3, 0x6fa035c3, 0x77f2db5b};
+    uint32_t s[4] = {0, 0, 0, 0};
+    for(uint32_t i = 0; i < 4; i++) {
+        for(uint32_t b = 0; b < 32; b++) {
+            if(jump[i] & (1u << b)) {
+                for(uint32_t j = 0; j < 4; j++) {
+                    s[j] ^= x->s[j];
+                }
+            }
+            xoshiro128_next(x);
+        }
+    }
+    for(uint32_t j = 0; j < 4; j++) {
+        x->s[j] = s[j];
+    }
+}
+
+void montecarlo_init(montecarlo_t* mc, uint32_t seed, uint32_t lanes) {
+    if(lanes < 1) {
+        lanes = 1;
+    }
+    if(lanes > MONTECARLO_MAX_LANES) {
+        lanes = MONTECARLO_MAX_LANES;
+    }
+    if(seed == 0) {
+        seed = picalc_random_seed();
+    }
+    mc->seed = seed;
+    mc->lanes = lanes;
+    xoshiro128_t rng;
+    xoshiro128_seed(&rng, seed);
+    for(uint32_t w = 0; w < MONTECARLO_MAX_LANES; w++) {
+        mc->lane[w].rng = rng;
+        mc->lane[w].hits = 0;
+        mc->lane[w].samples = 0;
+        xoshiro128_jump(&rng);
+    }
+}
+
+// Random numbers first, then the hit tests over the block. The test loop has no dependency
+// between iterations and vectorizes where the target can.
+static void montecarlo_lane_sample(montecarloLane_t* lane, uint32_t count) {
+    uint32_t block[MONTECARLO_BLOCK];
+    xoshiro128_t rng = lane->rng;
+    uint64_t hits = 0;
+    while(count > 0) {
+        uint32_t n = (count < MONTECARLO_BLOCK) ? count : MONTECARLO_BLOCK;
+        for(uint32_t i = 0; i < n; i++) {
+            block[i] = xoshiro128_next(&rng);
+        }
+        uint32_t blockHits = 0;
+        for(uint32_t i = 0; i < n; i++) {
+            uint32_t x = ((block[i] & 0x7FFFu) << 1) | 1u;
+            uint32_t y = (((block[i] >> 15) & 0x7FFFu) << 1) | 1u;
+            // x^2 + y^2 < 2^32 without leaving 32 bits, y^2 is odd and never 0
+            blockHits += (x * x < 0u - y * y);
+        }
+        hits += blockHits;
+        count -= n;
+    }
+    lane->rng = rng;
+    lane->hits += hits;
+}
+
+void montecarlo_sample(montecarlo_t* mc, uint32_t count) {
+    montecarlo_lane_sample(&mc->lane[0], count);
+    mc->lane[0].samples += count;
+}
+
+typedef struct {
+    montecarlo_t* mc;
+    uint32_t count;
+} montecarloJob_t;
+
+static uint32_t montecarlo_lane_share(uint32_t count, uint32_t lane, uint32_t lanes) {
+    return count / lanes + ((lane < count % lanes) ? 1 : 0);
+}
+
+static void montecarlo_worker(void* arg, uint32_t worker, uint32_t workers) {
+    montecarloJob_t* job = (montecarloJob_t*)arg;
+    uint32_t share = montecarlo_lane_share(job->count, worker, workers);
+    montecarlo_lane_sample(&job->mc->lane[worker], share);
+    job->mc->lane[worker].samples += share;
+}
+
+static void montecarlo_range(void* arg, uint32_t begin, uint32_t end) {
+    montecarloJob_t* job = (montecarloJob_t*)arg;
+    for(uint32_t w = begin; w < end; w++) {
+        montecarlo_worker(arg, w, job->mc->lanes);
+    }
+}
+
+void montecarlo_sample_parallel(montecarlo_t* mc, uint32_t count, executor_t* ex) {
+    montecarloJob_t job = {mc, count};
+    if(mc->lanes <= 1) {
+        montecarlo_sample(mc, count);
+    } else if(ex != NULL) {
+        executor_parallel_for(ex, 0, mc->lanes, 1, montecarlo_range, &job);
+    } else {
+        picalc_parallel_run(montecarlo_worker, &job, mc->lanes);
+    }
+}
+
+uint64_t montecarlo_hits(const montecarlo_t* mc) {
+    uint64_t hits = 0;
+    for(uint32_t w = 0; w < MONTECARLO_MAX_LANES; w++) {
+        hits += mc->lane[w].hits;
+    }
+    return hits;
+}
+
+uint64_t montecarlo_samples(const montecarlo_t* mc) {
+    uint64_t samples = 0;
+    for(uint32_t w = 0; w < MONTECARLO_MAX_LANES; w++) {
+        samples += mc->lane[w].samples;
+    }
+    return samples;
+}
+
+double montecarlo_estimate(const montecarlo_t* mc) {
+    uint64_t samples = montecarlo_samples(mc);
+    return (samples == 0) ? 0.0 : 4.0 * (double)montecarlo_hits(mc) / (double)samples;
+}
+
+// Wilson score interval of the hit rate, scaled by 4. Unlike estimate +- z * sigma it does not
+// collapse to a point when no sample or every sample hit.
+void montecarlo_interval(const montecarlo_t* mc, double* lo, double* hi) {
+    uint64_t samples = montecarlo_samples(mc);
+    if(samples == 0) {
+        *lo = 0.0;
+        *hi = 4.0;
+        return;
+    }
+    double n = (double)samples;
+    double p = (double)montecarlo_hits(mc) / n;
+    double z2 = MONTECARLO_Z * MONTECARLO_Z;
+    double centre = (p + z2 / (2.0 * n)) / (1.0 + z2 / n);
+    double half = MONTECARLO_Z / (1.0 + z2 / n) * sqrt(p * (1.0 - p) / n + z2 / (4.0 * n * n));
+    *lo = 4.0 * fmax(centre - half, 0.0);
+    *hi = 4.0 * fmin(centre + half, 1.0);
+}
+
+double montecarlo_half_width(const montecarlo_t* mc) {
+    if(montecarlo_samples(mc) == 0) {
+        return INFINITY;
+    }
+    double estimate = montecarlo_estimate(mc);
+    double lo, hi;
+    montecarlo_interval(mc, &lo, &hi);
+    return fmax(estimate - lo, hi - estimate);
+}
+
+uint32_t montecarlo_probable_digits(const montecarlo_t* mc) {
+    uint64_t samples = montecarlo_samples(mc);
+    uint64_t hits = montecarlo_hits(mc);
+    // no interval says much about a handful of samples or a run that never (or always) hit
+    if(samples < MONTECARLO_MIN_SAMPLES || hits == 0 || hits == samples) {
+        return 0;
+    }
+    double lo, hi;
+    montecarlo_interval(mc, &lo, &hi);
+    if(floor(lo) != floor(hi)) {
+        return 0;
+    }
+    // decimal places where the ends of the interval still agree
+    double scale = 1.0;
+    uint32_t digits = 0;
+    while(digits < 15) {
+        scale *= 10.0;
+        if(floor(lo * scale) != floor(hi * scale)) {
+            break;
+        }
+        digits++;
+    }
+    return digits;
+}
@@ -0,0 +1,383 @@
+#include <stdlib.h>
+#include <string.h>
+#include <stdatomic.h>
+
+#include "../picalc_ntt.h"
+
+#define NTT_PRIMES      3
+#define NTT_LIMB_WORDS  (BIGINT_LIMB_BITS / 32)
+
+typedef struct {
+    uint32_t p;
+    uint32_t pinv;          // -p^-1 mod 2^32
+    uint32_t r1;            // 2^32 mod p, reduces any 32 bit value
+    uint32_t r2;            // 2^64 mod p, takes a value into Montgomery form
+} nttPrime_t;
+
+// p = c * 2^k + 1 with a primitive root, the smallest first so Garner needs no reductions.
+// 754974721 = 45 * 2^24 + 1 limits the transforms to 2^24.
+static const struct {
+    uint32_t p;
+    uint32_t root;
+} nttModuli[NTT_PRIMES] = {
+    {469762049u, 3},        // 7 * 2^26 + 1
+    {754974721u, 11},       // 45 * 2^24 + 1
+    {2013265921u, 31},      // 15 * 2^27 + 1
+};
+
+// Stage k (butterflies 2^(k-1) apart) of prime i: w^j R mod p for j < 2^(k-1), w of order 2^k
+static _Atomic(uint32_t*) nttTwiddles[NTT_PRIMES][NTT_MAX_LOG + 1];
+static executor_t* nttExecutor;
+
+/********************************************************************************************* */
+// Arithmetic modulo p < 2^31, values in [0, p)
+/********************************************************************************************* */
+
+static inline uint32_t ntt_redc(uint64_t t, const nttPrime_t* p) {
+    uint32_t m = (uint32_t)t * p->pinv;
+    uint32_t r = (uint32_t)((t + (uint64_t)m * p->p) >> 32);
+    return (r >= p->p) ? r - p->p : r;
+}
+
+// a * b / 2^32, with b in Montgomery form this is a plain a * b
+static inline uint32_t ntt_mul_mod(uint32_t a, uint32_t b, const nttPrime_t* p) {
+    return ntt_redc((uint64_t)a * b, p);
+}
+
+static inline uint32_t ntt_add(uint32_t a, uint32_t b, const nttPrime_t* p) {
+    uint32_t s = a + b;
+    return (s >= p->p) ? s - p->p : s;
+}
+
+static inline uint32_t ntt_sub(uint32_t a, uint32_t b, const nttPrime_t* p) {
+    return (a >= b) ? a - b : a + p->p - b;
+}
+
+static inline uint32_t ntt_to_mont(uint32_t a, const nttPrime_t* p) {
+    return ntt_mul_mod(a, p->r2, p);
+}
+
+static uint32_t ntt_pow(uint32_t base, uint32_t e, const nttPrime_t* p) {
+    uint32_t x = ntt_to_mont(base, p);
+    uint32_t r = ntt_to_mont(1, p);
+    for(; e > 0; e >>= 1) {
+        if(e & 1) {
+            r = ntt_mul_mod(r, x, p);
+        }
+        x = ntt_mul_mod(x, x, p);
+    }
+    return ntt_redc(r, p);
+}
+
+static void ntt_prime_init(nttPrime_t* p, uint32_t modulus) {
+    // Newton doubles the correct low bits, an odd p is its own inverse to 3 bits
+    uint32_t inv = modulus;
+    for(int i = 0; i < 4; i++) {
+        inv *= 2 - modulus * inv;
+    }
+    p->p = modulus;
+    p->pinv = -inv;
+    uint64_t r = ((uint64_t)1 << 32) % modulus;
+    p->r1 = (uint32_t)r;
+    p->r2 = (uint32_t)(r * r % modulus);
+}
+
+/********************************************************************************************* */
+// Twiddles
+/********************************************************************************************* */
+
+static const uint32_t* ntt_twiddles(uint32_t prime, const nttPrime_t* p, uint32_t k) {
+    uint32_t* table = atomic_load_explicit(&nttTwiddles[prime][k], memory_order_acquire);
+    if(table != NULL) {
+        return table;
+    }
+    uint32_t h = (uint32_t)1 << (k - 1);
+    table = malloc(h * sizeof(uint32_t));
+    if(table == NULL) {
+        abort();
+    }
+    uint32_t w = ntt_to_mont(ntt_pow(nttModuli[prime].root, (p->p - 1) >> k, p), p);
+    table[0] = ntt_to_mont(1, p);
+    for(uint32_t j = 1; j < h; j++) {
+        table[j] = ntt_mul_mod(table[j - 1], w, p);
+    }
+    // two builders of the same stage: the first one's table stays
+    uint32_t* expected = NULL;
+    if(!atomic_compare_exchange_strong_explicit(&nttTwiddles[prime][k], &expected, table, memory_order_acq_rel,
+                                                memory_order_acquire)) {
+        free(table);
+        table = expected;
+    }
+    return table;
+}
+
+void ntt_free_tables(void) {
+    for(uint32_t i = 0; i < NTT_PRIMES; i++) {
+        for(uint32_t k = 0; k <= NTT_MAX_LOG; k++) {
+            free(atomic_exchange(&nttTwiddles[i][k], NULL));
+        }
+    }
+}
+
+void ntt_set_executor(executor_t* ex) {
+    nttExecutor = ex;
+}
+
+// fn over [begin, end) on the executor, or here if there is none or the range is one piece
+static void ntt_for(uint32_t begin, uint32_t end, uint32_t grain, executorRangeFn_t fn, void* arg) {
+    if(nttExecutor == NULL || end - begin <= grain) {
+        fn(arg, begin, end);
+    } else {
+        executor_parallel_for(nttExecutor, begin, end, grain, fn, arg);
+    }
+}
+
+/********************************************************************************************* */
+// Transforms
+/********************************************************************************************* */
+
+typedef struct {
+    const nttPrime_t* prime;
+    uint32_t* data;
+    uint32_t log;
+    const uint32_t* twiddles[NTT_MAX_LOG + 1];
+    const bigint_limb_t* limbs;     // operand that goes in
+    size_t words;
+    uint32_t scale;                 // n^-1 R^2, the pointwise product leaves the scaled convolution
+    const uint32_t* other;          // transform of the second operand, the pointwise factor
+} nttTransform_t;
+
+typedef struct {
+    nttTransform_t* t;
+    uint32_t logh;
+    bool inverse;
+} nttStage_t;
+
+// Butterflies [begin, end) of a stage 2^logh apart, the DIF ones or the DIT ones with w^-j = -w^(h-j)
+static void ntt_stage_range(void* arg, uint32_t begin, uint32_t end) {
+    const nttStage_t* stage = arg;
+    // local copies, the stores to the data could alias them for all the compiler knows
+    const nttPrime_t prime = *stage->t->prime;
+    const nttPrime_t* p = &prime;
+    uint32_t* a = stage->t->data;
+    uint32_t logh = stage->logh;
+    uint32_t h = (uint32_t)1 << logh;
+    bool inverse = stage->inverse;
+    const uint32_t* w = stage->t->twiddles[logh + 1];
+    for(uint32_t k = begin; k < end;) {
+        uint32_t j = k & (h - 1);
+        uint32_t count = (h - j < end - k) ? h - j : end - k;
+        uint32_t* x = &a[((k >> logh) << (logh + 1)) + j];
+        uint32_t* y = &x[h];
+        if(inverse) {
+            uint32_t i = 0;
+            if(j == 0) {
+                uint32_t u = x[0];
+                x[0] = ntt_add(u, y[0], p);
+                y[0] = ntt_sub(u, y[0], p);
+                i = 1;
+            }
+            for(; i < count; i++) {
+                uint32_t u = x[i];
+                uint32_t v = ntt_mul_mod(y[i], w[h - j - i], p);
+                x[i] = ntt_sub(u, v, p);
+                y[i] = ntt_add(u, v, p);
+            }
+        } else {
+            for(uint32_t i = 0; i < count; i++) {
+                uint32_t u = x[i];
+                uint32_t v = y[i];
+                x[i] = ntt_add(u, v, p);
+                y[i] = ntt_mul_mod(ntt_sub(u, v, p), w[j + i], p);
+            }
+        }
+        k += count;
+    }
+}
+
+static uint32_t ntt_block_size(const nttTransform_t* t) {
+    uint32_t n = (uint32_t)1 << t->log;
+    return (n < NTT_BLOCK) ? n : NTT_BLOCK;
+}
+
+// Every stage of the blocks [begin, end) that stays within a block
+static void ntt_block_range(void* arg, uint32_t begin, uint32_t end, bool inverse) {
+    nttTransform_t* t = arg;
+    uint32_t size = ntt_block_size(t);
+    uint32_t half = size / 2;
+    for(uint32_t block = begin; block < end; block++) {
+        nttStage_t stage = {t, 0, inverse};
+        uint32_t first = block * half;
+        for(uint32_t s = 1; s < size; s <<= 1) {
+            stage.logh = (uint32_t)__builtin_ctz(inverse ? s : half / s);
+            ntt_stage_range(&stage, first, first + half);
+        }
+    }
+}
+
+static void ntt_forward_blocks(void* arg, uint32_t begin, uint32_t end) {
+    ntt_block_range(arg, begin, end, false);
+}
+
+static void ntt_inverse_blocks(void* arg, uint32_t begin, uint32_t end) {
+    ntt_block_range(arg, begin, end, true);
+}
+
+static void ntt_forward(nttTransform_t* t) {
+    uint32_t half = (uint32_t)1 << (t->log - 1);
+    uint32_t size = ntt_block_size(t);
+    nttStage_t stage = {t, 0, false};
+    for(uint32_t logh = t->log - 1; ((uint32_t)2 << logh) > size; logh--) {
+        stage.logh = logh;
+        ntt_for(0, half, NTT_BLOCK / 2, ntt_stage_range, &stage);
+    }
+    ntt_for(0, ((uint32_t)1 << t->log) / size, 1, ntt_forward_blocks, t);
+}
+
+static void ntt_inverse(nttTransform_t* t) {
+    uint32_t half = (uint32_t)1 << (t->log - 1);
+    uint32_t size = ntt_block_size(t);
+    ntt_for(0, ((uint32_t)1 << t->log) / size, 1, ntt_inverse_blocks, t);
+    nttStage_t stage = {t, 0, true};
+    for(uint32_t logh = (uint32_t)__builtin_ctz(size); logh < t->log; logh++) {
+        stage.logh = logh;
+        ntt_for(0, half, NTT_BLOCK / 2, ntt_stage_range, &stage);
+    }
+}
+
+// 32 bit coefficients of the operand modulo p, zero up to the transform length
+static void ntt_load_range(void* arg, uint32_t begin, uint32_t end) {
+    nttTransform_t* t = arg;
+    const nttPrime_t prime = *t->prime;
+    uint32_t* data = t->data;
+    uint32_t last = (end < t->words) ? end : (uint32_t)t->words;
+    uint32_t i = begin;
+    for(; i < last; i++) {
+        uint32_t word = (uint32_t)(t->limbs[i / NTT_LIMB_WORDS] >> (32 * (i % NTT_LIMB_WORDS)));
+        data[i] = ntt_mul_mod(word, prime.r1, &prime);
+    }
+    for(; i < end; i++) {
+        data[i] = 0;
+    }
+}
+
+static void ntt_pointwise_range(void* arg, uint32_t begin, uint32_t end) {
+    nttTransform_t* t = arg;
+    const nttPrime_t prime = *t->prime;
+    uint32_t* data = t->data;
+    const uint32_t* other = t->other;
+    uint32_t scale = t->scale;
+    for(uint32_t i = begin; i < end; i++) {
+        data[i] = ntt_mul_mod(ntt_mul_mod(data[i], other[i], &prime), scale, &prime);
+    }
+}
+
+static void ntt_forward_task(void* arg, uint32_t begin, uint32_t end) {
+    nttTransform_t* transforms = arg;
+    for(uint32_t i = begin; i < end; i++) {
+        ntt_for(0, (uint32_t)1 << transforms[i].log, NTT_BLOCK, ntt_load_range, &transforms[i]);
+        ntt_forward(&transforms[i]);
+    }
+}
+
+static void ntt_inverse_task(void* arg, uint32_t begin, uint32_t end) {
+    nttTransform_t* transforms = arg;
+    for(uint32_t i = begin; i < end; i++) {
+        ntt_for(0, (uint32_t)1 << transforms[i].log, NTT_BLOCK, ntt_pointwise_range, &transforms[i]);
+        ntt_inverse(&transforms[i]);
+    }
+}
+
+/********************************************************************************************* */
+// Product
+/********************************************************************************************* */
+
+bool ntt_mul(bigint_limb_t* r, const bigint_limb_t* a, size_t an, const bigint_limb_t* b, size_t bn) {
+    size_t words = (an + bn) * NTT_LIMB_WORDS;
+    uint32_t log = 1;
+    while(((size_t)1 << log) < words - 1) {
+        log++;
+    }
+    if(log > NTT_MAX_LOG) {
+        return false;
+    }
+    uint32_t n = (uint32_t)1 << log;
+    bool square = a == b && an == bn;
+
+    nttPrime_t primes[NTT_PRIMES];
+    // the transforms of a for every prime, then those of b unless it is a square
+    nttTransform_t transforms[2 * NTT_PRIMES];
+    uint32_t* buffer = malloc((size_t)(square ? 1 : 2) * NTT_PRIMES * n * sizeof(uint32_t));
+    if(buffer == NULL) {
+        abort();
+    }
+    for(uint32_t i = 0; i < 2 * NTT_PRIMES; i++) {
+        uint32_t prime = i % NTT_PRIMES;
+        bool second = i >= NTT_PRIMES;
+        nttTransform_t* t = &transforms[i];
+        if(!second) {
+            ntt_prime_init(&primes[prime], nttModuli[prime].p);
+        }
+        memset(t, 0, sizeof(nttTransform_t));
+        t->prime = &primes[prime];
+        t->log = log;
+        t->data = &buffer[(size_t)((square && second) ? prime : i) * n];
+        t->limbs = second ? b : a;
+        t->words = (second ? bn : an) * NTT_LIMB_WORDS;
+        for(uint32_t k = 1; k <= log; k++) {
+            t->twiddles[k] = ntt_twiddles(prime, &primes[prime], k);
+        }
+    }
+    uint32_t count = square ? NTT_PRIMES : 2 * NTT_PRIMES;
+    ntt_for(0, count, 1, ntt_forward_task, transforms);
+    for(uint32_t i = 0; i < NTT_PRIMES; i++) {
+        const nttPrime_t* p = &primes[i];
+        transforms[i].other = transforms[i + NTT_PRIMES].data;
+        transforms[i].scale = ntt_to_mont(ntt_to_mont(ntt_pow(n, p->p - 2, p), p), p);
+    }
+    ntt_for(0, NTT_PRIMES, 1, ntt_inverse_task, transforms);
+
+    // Garner: x = x1 + p1 x2 + p1 p2 x3 with x2 and x3 in the residues of p2 and p3, the Montgomery
+    // inverses make the plain products
+    const nttPrime_t* p1 = &primes[0];
+    const nttPrime_t* p2 = &primes[1];
+    const nttPrime_t* p3 = &primes[2];
+    uint32_t inv12 = ntt_to_mont(ntt_pow(p1->p, p2->p - 2, p2), p2);
+    uint32_t inv13 = ntt_to_mont(ntt_pow(p1->p, p3->p - 2, p3), p3);
+    uint32_t inv23 = ntt_to_mont(ntt_pow(p2->p, p3->p - 2, p3), p3);
+    uint64_t p12 = (uint64_t)p1->p * p2->p;
+    const uint32_t* c1 = transforms[0].data;
+    const uint32_t* c2 = transforms[1].data;
+    const uint32_t* c3 = transforms[2].data;
+    // carryLo + carryHi 2^64 goes to the next word
+    uint64_t carryLo = 0;
+    uint64_t carryHi = 0;
+    for(size_t i = 0; i < words; i++) {
+        uint64_t low = 0;
+        uint64_t t0 = 0;
+        uint64_t t1 = 0;
+        if(i < n) {
+            uint32_t x1 = c1[i];
+            uint32_t x2 = ntt_mul_mod(ntt_sub(c2[i], x1, p2), inv12, p2);
+            uint32_t x3 = ntt_mul_mod(ntt_sub(ntt_mul_mod(ntt_sub(c3[i], x1, p3), inv13, p3), x2, p3), inv23, p3);
+            low = x1 + (uint64_t)p1->p * x2;
+            t0 = (uint64_t)x3 * (uint32_t)p12;
+            t1 = (uint64_t)x3 * (uint32_t)(p12 >> 32);
+        }
+        uint64_t s = (low & 0xFFFFFFFFu) + (t0 & 0xFFFFFFFFu) + (carryLo & 0xFFFFFFFFu);
+        uint32_t word = (uint32_t)s;
+        s = (s >> 32) + (low >> 32) + (t0 >> 32) + (t1 & 0xFFFFFFFFu) + (carryLo >> 32);
+        uint64_t middle = s & 0xFFFFFFFFu;
+        s = (s >> 32) + (t1 >> 32) + carryHi;
+        carryLo = middle | (s << 32);
+        carryHi = s >> 32;
+        bigint_limb_t shifted = (bigint_limb_t)word << (32 * (i % NTT_LIMB_WORDS));
+        r[i / NTT_LIMB_WORDS] = (i % NTT_LIMB_WORDS == 0) ? shifted : (r[i / NTT_LIMB_WORDS] | shifted);
+    }
+    free(buffer);
+    // the product fits its an + bn limbs, anything left means a wrong coefficient
+    if(carryLo != 0 || carryHi != 0) {
+        abort();
+    }
+    return true;
+}
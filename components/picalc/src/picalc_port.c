@@ -0,0 +1,286 @@
+#include <stdlib.h>
+#include <assert.h>
+
+#include "../picalc_port.h"
+
+#ifdef ESP_PLATFORM
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "esp_timer.h"
+#include "esp_cpu.h"
+#include "esp_random.h"
+#include "esp_rom_sys.h"
+#include "esp_heap_caps.h"
+#include "sdkconfig.h"
+
+#define PICALC_WORKER_STACK     4096
+
+typedef struct {
+    picalcWorker_t fn;
+    void* arg;
+    uint32_t worker;
+    uint32_t workers;
+    SemaphoreHandle_t done;
+} picalcJob_t;
+
+int64_t picalc_time_us(void) {
+    return esp_timer_get_time();
+}
+
+uint64_t picalc_cycle_count(void) {
+    return (uint64_t)esp_cpu_get_cycle_count();
+}
+
+uint64_t picalc_cycles_since(uint64_t start) {
+    return (uint32_t)(esp_cpu_get_cycle_count() - (uint32_t)start);
+}
+
+uint32_t picalc_cycles_per_us(void) {
+    return esp_rom_get_cpu_ticks_per_us();
+}
+
+uint64_t picalc_cpu_time_us(void) {
+#if CONFIG_FREERTOS_GENERATE_RUN_TIME_STATS && CONFIG_FREERTOS_RUN_TIME_STATS_USING_ESP_TIMER
+    // The counter of the running task only moves on a context switch. A yield goes through
+    // vTaskSwitchContext, which brings it up to date even if the task keeps running.
+    taskYIELD();
+    return ulTaskGetRunTimeCounter(NULL);
+#else
+    return (uint64_t)esp_timer_get_time();
+#endif
+}
+
+uint64_t picalc_cpu_time_since_us(uint64_t start) {
+#if CONFIG_FREERTOS_GENERATE_RUN_TIME_STATS && CONFIG_FREERTOS_RUN_TIME_STATS_USING_ESP_TIMER
+    return (configRUN_TIME_COUNTER_TYPE)(picalc_cpu_time_us() - start);
+#else
+    return picalc_cpu_time_us() - start;
+#endif
+}
+
+uint32_t picalc_core_count(void) {
+    return portNUM_PROCESSORS;
+}
+
+const char* picalc_platform_name(void) {
+    return CONFIG_IDF_TARGET;
+}
+
+size_t picalc_heap_peak(void) {
+    return heap_caps_get_total_size(MALLOC_CAP_8BIT) - heap_caps_get_minimum_free_size(MALLOC_CAP_8BIT);
+}
+
+void picalc_yield(void) {
+    vTaskDelay(1);
+}
+
+uint32_t picalc_random_seed(void) {
+    return esp_random();
+}
+
+static void picalc_worker_task(void* param) {
+    picalcJob_t* job = (picalcJob_t*)param;
+    job->fn(job->arg, job->worker, job->workers);
+    xSemaphoreGive(job->done);
+    vTaskDelete(NULL);
+}
+
+void picalc_parallel_run(picalcWorker_t fn, void* arg, uint32_t workers) {
+    if(workers <= 1) {
+        fn(arg, 0, 1);
+        return;
+    }
+    picalcJob_t* jobs = malloc(workers * sizeof(picalcJob_t));
+    SemaphoreHandle_t done = xSemaphoreCreateCounting(workers, 0);
+    assert(jobs != NULL && done != NULL);
+    UBaseType_t priority = uxTaskPriorityGet(NULL);
+    for(uint32_t w = 0; w < workers; w++) {
+        jobs[w].fn = fn;
+        jobs[w].arg = arg;
+        jobs[w].worker = w;
+        jobs[w].workers = workers;
+        jobs[w].done = done;
+        xTaskCreatePinnedToCore(picalc_worker_task, "picalcWorker", PICALC_WORKER_STACK, &jobs[w], priority, NULL, w % portNUM_PROCESSORS);
+    }
+    for(uint32_t w = 0; w < workers; w++) {
+        xSemaphoreTake(done, portMAX_DELAY);
+    }
+    vSemaphoreDelete(done);
+    free(jobs);
+}
+
+#else
+
+#include <stdio.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/resource.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+int64_t picalc_time_us(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+uint64_t picalc_cycle_count(void) {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    // no portable cycle counter, nanoseconds are the closest stand-in
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+#endif
+}
+
+uint64_t picalc_cycles_since(uint64_t start) {
+    return picalc_cycle_count() - start;
+}
+
+uint32_t picalc_cycles_per_us(void) {
+    static uint32_t cyclesPerUs = 0;
+    if(cyclesPerUs == 0) {
+        int64_t start = picalc_time_us();
+        uint64_t cycles = picalc_cycle_count();
+        while(picalc_time_us() - start < 10000) {
+        }
+        uint64_t perUs = (picalc_cycle_count() - cycles) / (uint64_t)(picalc_time_us() - start);
+        cyclesPerUs = (perUs > 0) ? (uint32_t)perUs : 1;
+    }
+    return cyclesPerUs;
+}
+
+uint64_t picalc_cpu_time_us(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return (uint64_t)ts.tv_sec * 1000000 + (uint64_t)ts.tv_nsec / 1000;
+}
+
+uint64_t picalc_cpu_time_since_us(uint64_t start) {
+    return picalc_cpu_time_us() - start;
+}
+
+uint32_t picalc_core_count(void) {
+    long cores = sysconf(_SC_NPROCESSORS_ONLN);
+    return cores > 0 ? (uint32_t)cores : 1;
+}
+
+const char* picalc_platform_name(void) {
+    return "host";
+}
+
+size_t picalc_heap_peak(void) {
+    struct rusage usage;
+    if(getrusage(RUSAGE_SELF, &usage) != 0) {
+        return 0;
+    }
+    // kilobytes on Linux
+    return (size_t)usage.ru_maxrss * 1024;
+}
+
+void picalc_yield(void) {
+    sched_yield();
+}
+
+uint32_t picalc_random_seed(void) {
+    uint32_t seed = 0;
+    FILE* f = fopen("/dev/urandom", "rb");
+    if(f != NULL) {
+        if(fread(&seed, sizeof(seed), 1, f) != 1) {
+            seed = 0;
+        }
+        fclose(f);
+    }
+    if(seed == 0) {
+        uint64_t t = (uint64_t)picalc_time_us() ^ ((uint64_t)getpid() << 32);
+        seed = (uint32_t)(t ^ (t >> 29)) * 0x9E3779B9u;
+    }
+    return seed;
+}
+
+// Host workers are a pool of threads that stay around between calls. Worker 0 runs on the
+// calling thread, pool thread i runs worker i + 1. Calls from different threads take turns.
+static struct {
+    pthread_mutex_t call;
+    pthread_mutex_t lock;
+    pthread_cond_t start;
+    pthread_cond_t done;
+    uint32_t threads;
+    uint64_t generation;
+    picalcWorker_t fn;
+    void* arg;
+    uint32_t workers;
+    uint32_t pending;
+} picalcPool = {
+    .call = PTHREAD_MUTEX_INITIALIZER,
+    .lock = PTHREAD_MUTEX_INITIALIZER,
+    .start = PTHREAD_COND_INITIALIZER,
+    .done = PTHREAD_COND_INITIALIZER,
+};
+
+static void* picalc_pool_thread(void* param) {
+    uint32_t worker = (uint32_t)(uintptr_t)param;
+    uint64_t seen = 0;
+    pthread_mutex_lock(&picalcPool.lock);
+    for(;;) {
+        while(picalcPool.generation == seen) {
+            pthread_cond_wait(&picalcPool.start, &picalcPool.lock);
+        }
+        seen = picalcPool.generation;
+        if(worker >= picalcPool.workers) {
+            continue;
+        }
+        picalcWorker_t fn = picalcPool.fn;
+        void* arg = picalcPool.arg;
+        uint32_t workers = picalcPool.workers;
+        pthread_mutex_unlock(&picalcPool.lock);
+        fn(arg, worker, workers);
+        pthread_mutex_lock(&picalcPool.lock);
+        if(--picalcPool.pending == 0) {
+            pthread_cond_signal(&picalcPool.done);
+        }
+    }
+    return NULL;
+}
+
+void picalc_parallel_run(picalcWorker_t fn, void* arg, uint32_t workers) {
+    if(workers <= 1) {
+        fn(arg, 0, 1);
+        return;
+    }
+    pthread_mutex_lock(&picalcPool.call);
+    pthread_mutex_lock(&picalcPool.lock);
+    while(picalcPool.threads < workers - 1) {
+        pthread_t thread;
+        if(pthread_create(&thread, NULL, picalc_pool_thread, (void*)(uintptr_t)(picalcPool.threads + 1)) != 0) {
+            abort();
+        }
+        pthread_detach(thread);
+        picalcPool.threads++;
+    }
+    picalcPool.fn = fn;
+    picalcPool.arg = arg;
+    picalcPool.workers = workers;
+    picalcPool.pending = workers - 1;
+    picalcPool.generation++;
+    pthread_cond_broadcast(&picalcPool.start);
+    pthread_mutex_unlock(&picalcPool.lock);
+
+    fn(arg, 0, workers);
+
+    pthread_mutex_lock(&picalcPool.lock);
+    while(picalcPool.pending > 0) {
+        pthread_cond_wait(&picalcPool.done, &picalcPool.lock);
+    }
+    pthread_mutex_unlock(&picalcPool.lock);
+    pthread_mutex_unlock(&picalcPool.call);
+}
+
+#endif
@@ -0,0 +1,196 @@
+#include <string.h>
+
+#include "../picalc_race.h"
+#include "../picalc_port.h"
+
+static void race_reset_engine(raceEngine_t* engine) {
+    engine->running = false;
+    engine->algo->reset(engine->state);
+    engine->batch = engine->algo->batch;
+    engine->elapsedUs = 0;
+    engine->cpuUs = 0;
+    engine->cycles = 0;
+    mailbox_init(&engine->mailbox, &engine->mailboxStorage, sizeof(piResult_t));
+    memset(&engine->result, 0, sizeof(piResult_t));
+    engine->sequence = 0;
+    engine->digits = 0;
+}
+
+void race_init(race_t* race, const piAlgoConfig_t* config, int64_t sliceUs, int64_t yieldUs) {
+    race->sliceUs = sliceUs;
+    race->yieldUs = yieldUs;
+    race->hold = false;
+    for(uint32_t core = 0; core < portNUM_PROCESSORS; core++) {
+        race->parked[core] = false;
+        race->workers[core] = NULL;
+    }
+    for(uint32_t id = 0; id < PI_ALGO_COUNT; id++) {
+        raceEngine_t* engine = &race->engines[id];
+        engine->algo = &piAlgos[id];
+        engine->config = *config;
+        engine->state = algo_create(engine->algo, &engine->config);
+        atomic_init(&engine->claimed, false);
+        race_reset_engine(engine);
+    }
+}
+
+// Next running engine nobody else is stepping, round robin from *cursor
+static raceEngine_t* race_claim(race_t* race, uint32_t* cursor) {
+    for(uint32_t i = 0; i < PI_ALGO_COUNT; i++) {
+        raceEngine_t* engine = &race->engines[(*cursor + i) % PI_ALGO_COUNT];
+        if(engine->running && !atomic_exchange(&engine->claimed, true)) {
+            *cursor = (*cursor + i + 1) % PI_ALGO_COUNT;
+            return engine;
+        }
+    }
+    return NULL;
+}
+
+static void race_publish(raceEngine_t* engine) {
+    piResult_t piResult;
+    const piAlgo_t* algo = engine->algo;
+    piResult.elapsedUs = engine->elapsedUs;
+    piResult.cpuUs = engine->cpuUs;
+    piResult.cycles = engine->cycles;
+    piResult.piValue = algo->estimate(engine->state);
+    piResult.piAccelerated = (algo->accelerated != NULL) ? algo->accelerated(engine->state) : piResult.piValue;
+    piResult.errorBound = algo->error_bound(engine->state);
+    piResult.iterations = algo->count(engine->state);
+    piResult.digits = algo_digits(algo, engine->state);
+    piResult.probable = (algo->probable_digits != NULL);
+    mailbox_publish(&engine->mailbox, &piResult);
+}
+
+static void race_step(race_t* race, raceEngine_t* engine) {
+    const piAlgo_t* algo = engine->algo;
+
+    // a step stays far below the 17 s wrap of the 32-bit cycle counter, the worker is pinned
+    uint64_t cpuStart = picalc_cpu_time_us();
+    uint64_t cycleStart = picalc_cycle_count();
+    int64_t start = picalc_time_us();
+    algo->step(engine->state, engine->batch);
+    int64_t end = picalc_time_us();
+    engine->cycles += picalc_cycles_since(cycleStart);
+    engine->cpuUs += (int64_t)picalc_cpu_time_since_us(cpuStart);
+    engine->batch = algo_next_batch(engine->batch, end - start, race->sliceUs);
+    engine->elapsedUs = end - engine->startUs;
+    race_publish(engine);
+}
+
+// An engine is stepped by one worker at a time but may move between the cores from one step
+// to the next
+static void race_worker_task(void* param) {
+    raceWorkerArg_t* arg = (raceWorkerArg_t*)param;
+    race_t* race = arg->race;
+    uint32_t core = arg->core;
+    uint32_t cursor = core;
+    int64_t yieldTime = picalc_time_us();
+    for(;;) {
+        raceEngine_t* engine = race->hold ? NULL : race_claim(race, &cursor);
+        if(engine == NULL) {
+            // nothing to step, race_start notifies
+            race->parked[core] = true;
+            ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+            race->parked[core] = false;
+            continue;
+        }
+        race_step(race, engine);
+        atomic_store(&engine->claimed, false);
+        int64_t now = picalc_time_us();
+        if(now - yieldTime >= race->yieldUs) {
+            vTaskDelay(1);
+            yieldTime = now;
+        }
+    }
+}
+
+void race_start_workers(race_t* race, UBaseType_t priority, configSTACK_DEPTH_TYPE stackDepth) {
+    for(uint32_t core = 0; core < portNUM_PROCESSORS; core++) {
+        race->workerArgs[core] = (raceWorkerArg_t){race, core};
+        xTaskCreatePinnedToCore(race_worker_task, "raceWorkerTask", stackDepth, &race->workerArgs[core], priority,
+                                &race->workers[core], core);
+    }
+}
+
+void race_start(race_t* race, uint32_t mask, uint32_t digitTarget) {
+    for(uint32_t id = 0; id < PI_ALGO_COUNT; id++) {
+        raceEngine_t* engine = &race->engines[id];
+        if(!(mask & PI_ALGO_MASK(id)) || engine->running || engine->digits >= digitTarget) {
+            continue;
+        }
+        engine->config.digitTarget = digitTarget;
+        engine->startUs = picalc_time_us() - engine->elapsedUs;
+        engine->running = true;
+    }
+    for(uint32_t core = 0; core < portNUM_PROCESSORS; core++) {
+        if(race->workers[core] != NULL) {
+            xTaskNotifyGive(race->workers[core]);
+        }
+    }
+}
+
+// The owner holds the engine like a worker does, so no step runs in between
+static void race_hold_engine(raceEngine_t* engine) {
+    while(atomic_exchange(&engine->claimed, true)) {
+        vTaskDelay(1);
+    }
+}
+
+void race_snapshot(race_t* race, piAlgoId_t id, raceSnapshot_t* snapshot) {
+    raceEngine_t* engine = &race->engines[id];
+    race_hold_engine(engine);
+    algo_snapshot(engine->algo, engine->state, &snapshot->state);
+    snapshot->batch = engine->batch;
+    snapshot->elapsedUs = engine->elapsedUs;
+    snapshot->cpuUs = engine->cpuUs;
+    snapshot->cycles = engine->cycles;
+    atomic_store(&engine->claimed, false);
+}
+
+bool race_restore(race_t* race, piAlgoId_t id, const raceSnapshot_t* snapshot) {
+    raceEngine_t* engine = &race->engines[id];
+    if(engine->running) {
+        return false;
+    }
+    race_hold_engine(engine);
+    bool restored = algo_restore(engine->algo, engine->state, &snapshot->state);
+    if(restored) {
+        engine->batch = snapshot->batch;
+        engine->elapsedUs = snapshot->elapsedUs;
+        engine->cpuUs = snapshot->cpuUs;
+        engine->cycles = snapshot->cycles;
+        race_publish(engine);
+    }
+    atomic_store(&engine->claimed, false);
+    return restored;
+}
+
+void race_reset(race_t* race) {
+    // the workers finish their current step and park, then every engine starts over
+    race->hold = true;
+    for(uint32_t core = 0; core < portNUM_PROCESSORS; core++) {
+        while(race->workers[core] != NULL && !race->parked[core]) {
+            vTaskDelay(1);
+        }
+    }
+    // held like race_snapshot holds it, a checkpoint writer may take a snapshot meanwhile
+    for(uint32_t id = 0; id < PI_ALGO_COUNT; id++) {
+        raceEngine_t* engine = &race->engines[id];
+        race_hold_engine(engine);
+        race_reset_engine(engine);
+        atomic_store(&engine->claimed, false);
+    }
+    race->hold = false;
+}
+
+bool race_update(race_t* race, piAlgoId_t id, uint32_t digitTarget) {
+    raceEngine_t* engine = &race->engines[id];
+    if(mailbox_read(&engine->mailbox, &engine->result, &engine->sequence)) {
+        engine->digits = engine->result.digits;
+    }
+    if(engine->running && engine->digits >= digitTarget) {
+        engine->running = false;
+        return true;
+    }
+    return false;
+}
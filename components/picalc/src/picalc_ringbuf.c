@@ -0,0 +1,59 @@
+#include <assert.h>
+
+#include "../picalc_ringbuf.h"
+
+void ringbuf_init(ringbuf_t* rb, uint8_t* storage, size_t size) {
+    assert(size > 0 && (size & (size - 1)) == 0);
+    rb->data = storage;
+    rb->mask = size - 1;
+    atomic_init(&rb->head, 0);
+    atomic_init(&rb->tail, 0);
+}
+
+size_t ringbuf_count(ringbuf_t* rb) {
+    size_t head = atomic_load_explicit(&rb->head, memory_order_acquire);
+    size_t tail = atomic_load_explicit(&rb->tail, memory_order_acquire);
+    return head - tail;
+}
+
+size_t ringbuf_space(ringbuf_t* rb) {
+    return rb->mask + 1 - ringbuf_count(rb);
+}
+
+bool ringbuf_push(ringbuf_t* rb, uint8_t value) {
+    return ringbuf_write(rb, &value, 1) == 1;
+}
+
+size_t ringbuf_write(ringbuf_t* rb, const uint8_t* values, size_t count) {
+    size_t head = atomic_load_explicit(&rb->head, memory_order_relaxed);
+    size_t tail = atomic_load_explicit(&rb->tail, memory_order_acquire);
+    size_t space = rb->mask + 1 - (head - tail);
+    if(count > space) {
+        count = space;
+    }
+    for(size_t i = 0; i < count; i++) {
+        rb->data[(head + i) & rb->mask] = values[i];
+    }
+    // publish the data before the new head becomes visible
+    atomic_store_explicit(&rb->head, head + count, memory_order_release);
+    return count;
+}
+
+bool ringbuf_pop(ringbuf_t* rb, uint8_t* value) {
+    return ringbuf_read(rb, value, 1) == 1;
+}
+
+size_t ringbuf_read(ringbuf_t* rb, uint8_t* values, size_t count) {
+    size_t tail = atomic_load_explicit(&rb->tail, memory_order_relaxed);
+    size_t head = atomic_load_explicit(&rb->head, memory_order_acquire);
+    size_t available = head - tail;
+    if(count > available) {
+        count = available;
+    }
+    for(size_t i = 0; i < count; i++) {
+        values[i] = rb->data[(tail + i) & rb->mask];
+    }
+    // hand the slots back to the producer only after they have been read
+    atomic_store_explicit(&rb->tail, tail + count, memory_order_release);
+    return count;
+}
@@ -0,0 +1,654 @@
+#include <stdlib.h>
+#include <math.h>
+#include <float.h>
+
+#include "../picalc_series.h"
+#include "../picalc_port.h"
+#include "../picalc_simd.h"
+
+// Denominators up to here are exact as float
+#define SERIES_FLOAT_EXACT  (1u << 24)
+// Terms summed into a small block sum before it goes into the running sum. Rounding errors of
+// the block are relative to the block sum, only one add per block rounds at the size of the total.
+#define SERIES_FF_BLOCK     256
+// Last Basel index whose square fits into 64 bits
+#define SERIES_FIXED_SQUARE_END (((uint64_t)1 << 32) - 1)
+
+double series_leibniz_double(double sum, uint64_t start, uint32_t count) {
+    for(uint64_t k = start; k < start + count; k++) {
+        double term = 1.0 / (2.0 * (double)k + 1.0);
+        sum += (k & 1) ? -term : term;
+    }
+    return sum;
+}
+
+double series_basel_double(double sum, uint64_t start, uint32_t count) {
+    for(uint64_t k = start; k < start + count; k++) {
+        double d = (double)k;
+        sum += 1.0 / (d * d);
+    }
+    return sum;
+}
+
+const char* series_sum_mode_name(seriesSumMode_t mode) {
+    switch(mode) {
+        case SERIES_SUM_NAIVE:
+            return "naive";
+        case SERIES_SUM_NEUMAIER:
+            return "Neumaier";
+        case SERIES_SUM_PAIRWISE:
+            return "pairwise";
+        case SERIES_SUM_REVERSE:
+            return "reverse";
+    }
+    return "?";
+}
+
+void series_double_init(seriesDouble_t* s, seriesSumMode_t mode) {
+    s->mode = mode;
+    s->sum = 0.0;
+    s->compensation = 0.0;
+    s->terms = 0;
+}
+
+// k-th term of either series, k counted from 0 for both
+static inline double series_term_double(bool leibniz, uint64_t k) {
+    if(leibniz) {
+        double term = 1.0 / (2.0 * (double)k + 1.0);
+        return (k & 1) ? -term : term;
+    }
+    double d = (double)k + 1.0;
+    return 1.0 / (d * d);
+}
+
+// Inlined with a constant leibniz, so each public kernel gets its own loops
+static inline void series_sum_run(seriesDouble_t* s, uint32_t count, bool leibniz) {
+    uint64_t start = s->terms;
+    uint64_t end = start + count;
+    switch(s->mode) {
+        case SERIES_SUM_NEUMAIER: {
+            // TwoSum needs no |sum| >= |term| test, unlike the textbook Neumaier update
+            double sum = s->sum;
+            double c = s->compensation;
+            for(uint64_t k = start; k < end; k++) {
+                double term = series_term_double(leibniz, k);
+                double t = sum + term;
+                double bb = t - sum;
+                c += (sum - (t - bb)) + (term - bb);
+                sum = t;
+            }
+            s->sum = sum;
+            s->compensation = c;
+            break;
+        }
+        case SERIES_SUM_PAIRWISE: {
+            double block[SERIES_PAIRWISE_BLOCK];
+            for(uint64_t k = start; k < end; ) {
+                uint32_t n = (end - k > SERIES_PAIRWISE_BLOCK) ? SERIES_PAIRWISE_BLOCK : (uint32_t)(end - k);
+                uint32_t width = 1;
+                while(width < n) {
+                    width <<= 1;
+                }
+                for(uint32_t i = 0; i < n; i++) {
+                    block[i] = series_term_double(leibniz, k + i);
+                }
+                for(uint32_t i = n; i < width; i++) {
+                    block[i] = 0.0;
+                }
+                for(width >>= 1; width > 0; width >>= 1) {
+                    for(uint32_t i = 0; i < width; i++) {
+                        block[i] += block[i + width];
+                    }
+                }
+                s->sum += block[0];
+                k += n;
+            }
+            break;
+        }
+        case SERIES_SUM_REVERSE: {
+            double sum = 0.0;
+            for(uint64_t k = end; k > start; k--) {
+                sum += series_term_double(leibniz, k - 1);
+            }
+            s->sum += sum;
+            break;
+        }
+        default: {
+            double sum = s->sum;
+            for(uint64_t k = start; k < end; k++) {
+                sum += series_term_double(leibniz, k);
+            }
+            s->sum = sum;
+            break;
+        }
+    }
+    s->terms = end;
+}
+
+void series_leibniz_sum(seriesDouble_t* s, uint32_t count) {
+    series_sum_run(s, count, true);
+}
+
+void series_basel_sum(seriesDouble_t* s, uint32_t count) {
+    series_sum_run(s, count, false);
+}
+
+float series_leibniz_float(float sum, uint64_t start, uint32_t count) {
+    uint64_t end = start + count;
+    for(uint64_t k = start; k < end; ) {
+        uint64_t blockEnd = (end - k > SERIES_FF_BLOCK) ? k + SERIES_FF_BLOCK : end;
+        float block = 0.0f;
+        for(; k < blockEnd; k++) {
+            float term = 1.0f / (float)(2 * k + 1);
+            block += (k & 1) ? -term : term;
+        }
+        sum += block;
+    }
+    return sum;
+}
+
+float series_basel_float(float sum, uint64_t start, uint32_t count) {
+    uint64_t end = start + count;
+    for(uint64_t k = start; k < end; ) {
+        uint64_t blockEnd = (end - k > SERIES_FF_BLOCK) ? k + SERIES_FF_BLOCK : end;
+        float block = 0.0f;
+        for(; k < blockEnd; k++) {
+            float r = 1.0f / (float)k;
+            block += r * r;
+        }
+        sum += block;
+    }
+    return sum;
+}
+
+static inline ff_t series_leibniz_term(uint64_t k) {
+    uint64_t d = 2 * k + 1;
+    ff_t term = (d < SERIES_FLOAT_EXACT) ? ff_recip_float((float)d) : ff_recip(ff_from_u64(d));
+    return (k & 1) ? ff_neg(term) : term;
+}
+
+ff_t series_leibniz_ff(ff_t sum, uint64_t start, uint32_t count) {
+    uint64_t end = start + count;
+    for(uint64_t k = start; k < end; ) {
+        uint64_t blockEnd = (end - k > SERIES_FF_BLOCK) ? k + SERIES_FF_BLOCK : end;
+        ff_t block = series_leibniz_term(k++);
+        for(; k < blockEnd; k++) {
+            block = ff_add(block, series_leibniz_term(k));
+        }
+        sum = ff_add(sum, block);
+    }
+    return sum;
+}
+
+ff_t series_basel_ff(ff_t sum, uint64_t start, uint32_t count) {
+    uint64_t end = start + count;
+    for(uint64_t k = start; k < end; ) {
+        uint64_t blockEnd = (end - k > SERIES_FF_BLOCK) ? k + SERIES_FF_BLOCK : end;
+        ff_t block = ff_from_float(0.0f);
+        for(; k < blockEnd; k++) {
+            // 1/k^2 = (1/k)^2 keeps it to one reciprocal of an exact float
+            ff_t r = ff_recip_float((float)k);
+            block = ff_add(block, ff_mul(r, r));
+        }
+        sum = ff_add(sum, block);
+    }
+    return sum;
+}
+
+void series_fixed_init(seriesFixed_t* s) {
+    s->sum = 0;
+    s->errorBelow = 0;
+    s->errorAbove = 0;
+    s->terms = 0;
+}
+
+void series_leibniz_fixed(seriesFixed_t* s, uint32_t count) {
+    // every partial sum lies in (2/3, 1], the unsigned sum never wraps
+    uint64_t sum = s->sum;
+    uint64_t k = s->terms;
+    uint64_t end = k + count;
+    uint32_t negative = 0;
+    if(k & 1) {
+        sum -= SERIES_FIXED_ONE / (2 * k + 1);
+        negative++;
+        k++;
+    }
+    // pairs of a positive and a negative term
+    for(; k + 1 < end; k += 2) {
+        uint64_t d = 2 * k + 1;
+        sum += SERIES_FIXED_ONE / d;
+        sum -= SERIES_FIXED_ONE / (d + 2);
+        negative++;
+    }
+    if(k < end) {
+        sum += SERIES_FIXED_ONE / (2 * k + 1);
+    }
+    // a truncated positive term leaves the sum low, a truncated negative term leaves it high
+    s->errorAbove += count - negative;
+    s->errorBelow += negative;
+    s->sum = sum;
+    s->terms = end;
+}
+
+void series_basel_fixed(seriesFixed_t* s, uint32_t count) {
+    uint64_t sum = s->sum;
+    // past k = 2^31 the square leaves 64 bits and every term truncates to 0 anyway
+    uint64_t end = s->terms + count;
+    uint64_t squareEnd = (end < SERIES_FIXED_SQUARE_END) ? end : SERIES_FIXED_SQUARE_END;
+    for(uint64_t k = s->terms + 1; k <= squareEnd; k++) {
+        sum += SERIES_FIXED_ONE / (k * k);
+    }
+    s->errorAbove += count;
+    s->sum = sum;
+    s->terms += count;
+}
+
+static inline uint64_t series_saturating_add(uint64_t a, uint64_t b) {
+    return (a + b < a) ? UINT64_MAX : a + b;
+}
+
+static inline uint64_t series_saturating_sub(uint64_t a, uint64_t b) {
+    return (a < b) ? 0 : a - b;
+}
+
+static inline uint64_t series_fixed_recip_ceil(uint64_t d) {
+    return (SERIES_FIXED_ONE + d - 1) / d;
+}
+
+void series_leibniz_fixed_pi(const seriesFixed_t* s, uint64_t* lo, uint64_t* hi) {
+    uint64_t low = series_saturating_sub(s->sum, s->errorBelow);
+    uint64_t high = series_saturating_add(s->sum, s->errorAbove);
+    // the remainder after n terms has the sign of (-1)^n and is smaller than 1/(2n+1)
+    uint64_t remainder = series_fixed_recip_ceil(2 * s->terms + 1);
+    if(s->terms & 1) {
+        low = series_saturating_sub(low, remainder);
+    } else {
+        high = series_saturating_add(high, remainder);
+    }
+    // pi = 4 * (pi/4). An end outside the format proves nothing, the whole format certifies no digit.
+    if(low >= SERIES_FIXED_ONE || high >= SERIES_FIXED_ONE) {
+        *lo = 0;
+        *hi = UINT64_MAX;
+        return;
+    }
+    *lo = low << 2;
+    *hi = high << 2;
+}
+
+// 128-bit helpers for the square root, the board has no native 128-bit type
+typedef struct {
+    uint64_t hi;
+    uint64_t lo;
+} seriesU128_t;
+
+static seriesU128_t series_mul_64(uint64_t a, uint64_t b) {
+    uint64_t a0 = (uint32_t)a, a1 = a >> 32;
+    uint64_t b0 = (uint32_t)b, b1 = b >> 32;
+    uint64_t p00 = a0 * b0, p01 = a0 * b1, p10 = a1 * b0, p11 = a1 * b1;
+    uint64_t middle = (p00 >> 32) + (uint32_t)p01 + (uint32_t)p10;
+    seriesU128_t r;
+    r.lo = (middle << 32) | (uint32_t)p00;
+    r.hi = p11 + (p01 >> 32) + (p10 >> 32) + (middle >> 32);
+    return r;
+}
+
+static int series_cmp_128(seriesU128_t a, seriesU128_t b) {
+    if(a.hi != b.hi) {
+        return a.hi < b.hi ? -1 : 1;
+    }
+    if(a.lo != b.lo) {
+        return a.lo < b.lo ? -1 : 1;
+    }
+    return 0;
+}
+
+// floor(sqrt(x)), or the ceiling when roundUp is set
+static uint64_t series_sqrt_128(seriesU128_t x, bool roundUp) {
+    // binary search on the root, 64 squarings
+    uint64_t root = 0;
+    for(int bit = 63; bit >= 0; bit--) {
+        uint64_t candidate = root | ((uint64_t)1 << bit);
+        if(series_cmp_128(series_mul_64(candidate, candidate), x) <= 0) {
+            root = candidate;
+        }
+    }
+    if(roundUp && root != UINT64_MAX) {
+        seriesU128_t square = series_mul_64(root, root);
+        if(series_cmp_128(square, x) < 0) {
+            root++;
+        }
+    }
+    return root;
+}
+
+// sqrt(6 * x) in Q2.62 for x in Q2.62, i.e. sqrt(6 * x * 2^62)
+static uint64_t series_fixed_basel_to_pi(uint64_t x, bool roundUp) {
+    if(x >= (uint64_t)1 << 63) {
+        // 6x would not fit and pi is far outside anyway
+        return roundUp ? UINT64_MAX : 0;
+    }
+    // 6 * x * 2^62 = (x * 3 * 2^61) << 2
+    seriesU128_t r = series_mul_64(x, (uint64_t)3 << 61);
+    r.hi = (r.hi << 2) | (r.lo >> 62);
+    r.lo <<= 2;
+    return series_sqrt_128(r, roundUp);
+}
+
+void series_basel_fixed_pi(const seriesFixed_t* s, uint64_t* lo, uint64_t* hi) {
+    // remainder after n terms: 1/(n+1) < sum_{k > n} 1/k^2 < 1/n
+    uint64_t n = s->terms;
+    uint64_t low = series_saturating_sub(s->sum, s->errorBelow);
+    uint64_t high = series_saturating_add(s->sum, s->errorAbove);
+    low = series_saturating_add(low, SERIES_FIXED_ONE / (n + 1));
+    high = (n == 0) ? UINT64_MAX : series_saturating_add(high, series_fixed_recip_ceil(n));
+    // 6x leaves the format from 2 on, like Leibniz the whole format then
+    if(low >= (uint64_t)1 << 63 || high >= (uint64_t)1 << 63) {
+        *lo = 0;
+        *hi = UINT64_MAX;
+        return;
+    }
+    *lo = series_fixed_basel_to_pi(low, false);
+    *hi = series_fixed_basel_to_pi(high, true);
+}
+
+uint32_t series_fixed_certified_digits(uint64_t lo, uint64_t hi) {
+    if((lo >> SERIES_FIXED_FRACTION_BITS) != (hi >> SERIES_FIXED_FRACTION_BITS)) {
+        return 0;
+    }
+    // fractions as Q0.64, peel off one decimal digit per step: digit = floor(f * 10), f = f * 10 mod 1
+    uint64_t a = lo << (64 - SERIES_FIXED_FRACTION_BITS);
+    uint64_t b = hi << (64 - SERIES_FIXED_FRACTION_BITS);
+    uint32_t digits = 0;
+    // Q2.62 resolves a bit over 18 decimal places
+    while(digits < 18) {
+        seriesU128_t ta = series_mul_64(a, 10);
+        seriesU128_t tb = series_mul_64(b, 10);
+        if(ta.hi != tb.hi) {
+            break;
+        }
+        a = ta.lo;
+        b = tb.lo;
+        digits++;
+    }
+    return digits;
+}
+
+double series_fixed_to_double(uint64_t x) {
+    return ldexp((double)x, -SERIES_FIXED_FRACTION_BITS);
+}
+
+const char* series_format_name(seriesFormat_t format) {
+    switch(format) {
+        case SERIES_FORMAT_DOUBLE:
+            return "double";
+        case SERIES_FORMAT_FF:
+            return "float-float";
+        case SERIES_FORMAT_FIXED:
+            return "Q2.62";
+        case SERIES_FORMAT_FLOAT:
+            return "float";
+        case SERIES_FORMAT_ADAPTIVE:
+            return "adaptive";
+    }
+    return "?";
+}
+
+void series_init(series_t* s, seriesKind_t kind, seriesFormat_t format, seriesSumMode_t sumMode) {
+    s->kind = kind;
+    s->format = format;
+    series_double_init(&s->dbl, sumMode);
+    s->ff = ff_from_float(0.0f);
+    s->flt = 0.0f;
+    series_fixed_init(&s->fixed);
+    s->terms = 0;
+    s->roundings = 0;
+    s->carried = 0.0;
+}
+
+static double series_value(const series_t* s) {
+    switch(s->format) {
+        case SERIES_FORMAT_FF:
+            return ff_to_double(s->ff);
+        case SERIES_FORMAT_FIXED:
+            return series_fixed_to_double(s->fixed.sum);
+        case SERIES_FORMAT_FLOAT:
+            return (double)s->flt;
+        default:
+            return series_double_value(&s->dbl);
+    }
+}
+
+// The bound with the given number of terms and adds at the size of the total
+static double series_bound(const series_t* s, uint64_t terms, uint32_t roundings) {
+    // the partial sums stay below 1 for Leibniz and pi^2/6 for Basel
+    double size = (s->kind == SERIES_LEIBNIZ) ? 1.0 : 1.65;
+    switch(s->format) {
+        case SERIES_FORMAT_FF:
+            return (double)roundings * SERIES_FF_EPSILON * size + s->carried;
+        case SERIES_FORMAT_FLOAT: {
+            // float has no floor below it like float-float, the adds inside the blocks count here
+            double inBlocks = (terms < 2 * SERIES_FF_BLOCK) ? (double)terms : 2.0 * SERIES_FF_BLOCK;
+            return ((double)roundings + inBlocks) * FLT_EPSILON * size + s->carried;
+        }
+        case SERIES_FORMAT_FIXED: {
+            // series_escalate folds the carried bound into the units
+            uint64_t error = (s->fixed.errorBelow > s->fixed.errorAbove) ? s->fixed.errorBelow : s->fixed.errorAbove;
+            return series_fixed_to_double(error);
+        }
+        default:
+            if(s->dbl.mode == SERIES_SUM_NEUMAIER) {
+                return 4.0 * DBL_EPSILON * size + s->carried;
+            }
+            if(s->dbl.mode == SERIES_SUM_PAIRWISE) {
+                return ((double)(terms / SERIES_PAIRWISE_BLOCK) + 1.0) * DBL_EPSILON * size + s->carried;
+            }
+            return ((double)terms + 1.0) * DBL_EPSILON * size + s->carried;
+    }
+}
+
+double series_rounding_bound(const series_t* s) {
+    return series_bound(s, s->terms, s->roundings);
+}
+
+double series_rounding_bound_after(const series_t* s, uint32_t count) {
+    // one add per block, a tail and a merge per parallel chunk at most. Q2.62 grows by a unit
+    // per term, that one is left to the caller.
+    uint32_t roundings = s->roundings + (count + SERIES_FF_BLOCK - 1) / SERIES_FF_BLOCK + 2 * SERIES_PARALLEL_CHUNKS;
+    return series_bound(s, s->terms + count, roundings);
+}
+
+// Round to nearest Q2.62, half a unit off at most. The partial sums are positive and below 2.
+static uint64_t series_double_to_fixed(double x) {
+    return (uint64_t)llround(ldexp(x, SERIES_FIXED_FRACTION_BITS));
+}
+
+void series_escalate(series_t* s, seriesFormat_t format) {
+    if(format == s->format) {
+        return;
+    }
+    double carried = series_rounding_bound(s);
+    if(format == SERIES_FORMAT_FF && s->format == SERIES_FORMAT_FLOAT) {
+        s->ff = ff_from_float(s->flt);
+    } else if(format == SERIES_FORMAT_FIXED) {
+        // hi of float-float and the double sum are whole units of Q2.62, lo and the compensation
+        // round by half a unit, one unit each way covers it
+        double hi, lo;
+        switch(s->format) {
+            case SERIES_FORMAT_FLOAT:
+                hi = s->flt;
+                lo = 0.0;
+                break;
+            case SERIES_FORMAT_FF:
+                hi = s->ff.hi;
+                lo = s->ff.lo;
+                break;
+            default:
+                hi = s->dbl.sum;
+                lo = s->dbl.compensation;
+                break;
+        }
+        uint64_t error = (uint64_t)ceil(ldexp(carried, SERIES_FIXED_FRACTION_BITS)) + 1;
+        s->fixed.sum = series_double_to_fixed(hi) + (uint64_t)llround(ldexp(lo, SERIES_FIXED_FRACTION_BITS));
+        s->fixed.errorBelow = error;
+        s->fixed.errorAbove = error;
+        s->fixed.terms = s->terms;
+        carried = 0.0;
+    } else {
+        // the narrower formats only ever hand over upwards
+        abort();
+    }
+    s->format = format;
+    s->roundings = 0;
+    s->carried = carried;
+}
+
+// Runs the kernel of the format over the next count terms, the state only knows where it stands
+static void series_run(series_t* s, uint32_t count) {
+    bool leibniz = (s->kind == SERIES_LEIBNIZ);
+    switch(s->format) {
+        case SERIES_FORMAT_FF:
+            // vector kernels of the back end chosen at compile time, see picalc_simd.h
+            s->ff = leibniz ? SERIES_SIMD_FN(series_leibniz_ff)(s->ff, s->terms, count) : SERIES_SIMD_FN(series_basel_ff)(s->ff, s->terms + 1, count);
+            // one add per block, the vector kernels add their scalar tail on top
+            s->roundings += (count + SERIES_FF_BLOCK - 1) / SERIES_FF_BLOCK + 1;
+            break;
+        case SERIES_FORMAT_FLOAT:
+            s->flt = leibniz ? series_leibniz_float(s->flt, s->terms, count) : series_basel_float(s->flt, s->terms + 1, count);
+            s->roundings += (count + SERIES_FF_BLOCK - 1) / SERIES_FF_BLOCK;
+            break;
+        case SERIES_FORMAT_FIXED:
+            if(leibniz) {
+                series_leibniz_fixed(&s->fixed, count);
+            } else {
+                series_basel_fixed(&s->fixed, count);
+            }
+            break;
+        default:
+            if(leibniz) {
+                series_leibniz_sum(&s->dbl, count);
+            } else {
+                series_basel_sum(&s->dbl, count);
+            }
+            break;
+    }
+    s->terms += count;
+}
+
+double series_advance(series_t* s, uint32_t count) {
+    series_run(s, count);
+    return series_value(s);
+}
+
+typedef struct {
+    const series_t* series;
+    seriesSplit_t split;
+    uint32_t chunkTerms;
+    uint32_t count;
+    series_t chunk[SERIES_PARALLEL_CHUNKS];
+} seriesParallelJob_t;
+
+// A chunk is a fresh sum that starts at its first term
+static void series_run_chunk(seriesParallelJob_t* job, uint32_t c) {
+    series_t* chunk = &job->chunk[c];
+    uint32_t start = c * job->chunkTerms;
+    uint32_t terms = (start >= job->count) ? 0 : (job->count - start < job->chunkTerms ? job->count - start : job->chunkTerms);
+    series_init(chunk, job->series->kind, job->series->format, job->series->dbl.mode);
+    chunk->terms = job->series->terms + start;
+    chunk->dbl.terms = chunk->terms;
+    chunk->fixed.terms = chunk->terms;
+    if(terms > 0) {
+        series_run(chunk, terms);
+    }
+}
+
+static void series_chunk_worker(void* arg, uint32_t worker, uint32_t workers) {
+    seriesParallelJob_t* job = (seriesParallelJob_t*)arg;
+    uint32_t first, last, step;
+    if(job->split == SERIES_SPLIT_INTERLEAVED) {
+        first = worker;
+        last = SERIES_PARALLEL_CHUNKS;
+        step = workers;
+    } else {
+        first = worker * SERIES_PARALLEL_CHUNKS / workers;
+        last = (worker + 1) * SERIES_PARALLEL_CHUNKS / workers;
+        step = 1;
+    }
+    for(uint32_t c = first; c < last; c += step) {
+        series_run_chunk(job, c);
+    }
+}
+
+static void series_chunk_range(void* arg, uint32_t begin, uint32_t end) {
+    for(uint32_t c = begin; c < end; c++) {
+        series_run_chunk((seriesParallelJob_t*)arg, c);
+    }
+}
+
+// Adds a chunk sum to the running sum, always in chunk order
+static void series_merge(series_t* s, const series_t* chunk) {
+    switch(s->format) {
+        case SERIES_FORMAT_FF:
+            s->ff = ff_add(s->ff, chunk->ff);
+            s->roundings += chunk->roundings + 1;
+            break;
+        case SERIES_FORMAT_FLOAT:
+            s->flt += chunk->flt;
+            s->roundings += chunk->roundings + 1;
+            break;
+        case SERIES_FORMAT_FIXED:
+            // chunks of Leibniz may be negative, the sum is modulo 2^64 and ends up in range
+            s->fixed.sum += chunk->fixed.sum;
+            s->fixed.errorBelow += chunk->fixed.errorBelow;
+            s->fixed.errorAbove += chunk->fixed.errorAbove;
+            break;
+        default:
+            if(s->dbl.mode == SERIES_SUM_NEUMAIER) {
+                double t = s->dbl.sum + chunk->dbl.sum;
+                double bb = t - s->dbl.sum;
+                s->dbl.compensation += (s->dbl.sum - (t - bb)) + (chunk->dbl.sum - bb) + chunk->dbl.compensation;
+                s->dbl.sum = t;
+            } else {
+                s->dbl.sum += chunk->dbl.sum;
+            }
+            break;
+    }
+}
+
+static seriesParallelJob_t* series_parallel_begin(const series_t* s, uint32_t count, seriesSplit_t split) {
+    seriesParallelJob_t* job = malloc(sizeof(seriesParallelJob_t));
+    if(job == NULL) {
+        abort();
+    }
+    job->series = s;
+    job->split = split;
+    job->count = count;
+    job->chunkTerms = (count + SERIES_PARALLEL_CHUNKS - 1) / SERIES_PARALLEL_CHUNKS;
+    return job;
+}
+
+static double series_parallel_end(series_t* s, seriesParallelJob_t* job) {
+    for(uint32_t c = 0; c < SERIES_PARALLEL_CHUNKS; c++) {
+        series_merge(s, &job->chunk[c]);
+    }
+    s->terms += job->count;
+    s->dbl.terms = s->terms;
+    s->fixed.terms = s->terms;
+    free(job);
+    return series_value(s);
+}
+
+double series_advance_parallel(series_t* s, uint32_t count, uint32_t workers, seriesSplit_t split) {
+    seriesParallelJob_t* job = series_parallel_begin(s, count, split);
+    if(workers > SERIES_PARALLEL_CHUNKS) {
+        workers = SERIES_PARALLEL_CHUNKS;
+    }
+    picalc_parallel_run(series_chunk_worker, job, workers < 1 ? 1 : workers);
+    return series_parallel_end(s, job);
+}
+
+double series_advance_executor(series_t* s, uint32_t count, executor_t* ex) {
+    seriesParallelJob_t* job = series_parallel_begin(s, count, SERIES_SPLIT_BLOCKED);
+    executor_parallel_for(ex, 0, SERIES_PARALLEL_CHUNKS, 1, series_chunk_range, job);
+    return series_parallel_end(s, job);
+}
+
@@ -0,0 +1,248 @@
+#include <stdlib.h>
+#include <math.h>
+
+#include "../picalc_simd.h"
+#include "../picalc_series.h"
+
+#if SERIES_SIMD_HAS_X86
+#include <immintrin.h>
+#endif
+
+// Terms per lane block before the lanes go into the running sum, like SERIES_FF_BLOCK
+#define SERIES_SIMD_BLOCK           256
+// First term whose denominator is no longer exact as float
+#define SERIES_SIMD_FF_LEIBNIZ_END  (1u << 23)
+#define SERIES_SIMD_FF_BASEL_END    (1u << 24)
+
+// Scalar back end: 4 lanes as arrays, independent dependency chains for the FPU pipeline
+typedef struct {
+    float v[4];
+} seriesVf4_t;
+
+typedef struct {
+    double v[4];
+} seriesVd4_t;
+
+#define SERIES_LANE_OP(type, name, expr) \
+    static inline type name(type a, type b) { \
+        type r; \
+        for(uint32_t j = 0; j < 4; j++) { \
+            r.v[j] = expr; \
+        } \
+        return r; \
+    }
+
+SERIES_LANE_OP(seriesVf4_t, vf4_add, a.v[j] + b.v[j])
+SERIES_LANE_OP(seriesVf4_t, vf4_sub, a.v[j] - b.v[j])
+SERIES_LANE_OP(seriesVf4_t, vf4_mul, a.v[j] * b.v[j])
+SERIES_LANE_OP(seriesVf4_t, vf4_div, a.v[j] / b.v[j])
+SERIES_LANE_OP(seriesVd4_t, vd4_add, a.v[j] + b.v[j])
+SERIES_LANE_OP(seriesVd4_t, vd4_mul, a.v[j] * b.v[j])
+SERIES_LANE_OP(seriesVd4_t, vd4_div, a.v[j] / b.v[j])
+
+static inline seriesVf4_t vf4_set1(float x) {
+    seriesVf4_t r = {{x, x, x, x}};
+    return r;
+}
+
+static inline seriesVf4_t vf4_load(const float* p) {
+    seriesVf4_t r = {{p[0], p[1], p[2], p[3]}};
+    return r;
+}
+
+static inline void vf4_store(float* p, seriesVf4_t a) {
+    for(uint32_t j = 0; j < 4; j++) {
+        p[j] = a.v[j];
+    }
+}
+
+#if FF_HAS_FMA
+static inline seriesVf4_t vf4_fms(seriesVf4_t a, seriesVf4_t b, seriesVf4_t c) {
+    seriesVf4_t r;
+    for(uint32_t j = 0; j < 4; j++) {
+        r.v[j] = fmaf(a.v[j], b.v[j], -c.v[j]);
+    }
+    return r;
+}
+#endif
+
+static inline seriesVd4_t vd4_set1(double x) {
+    seriesVd4_t r = {{x, x, x, x}};
+    return r;
+}
+
+static inline seriesVd4_t vd4_load(const double* p) {
+    seriesVd4_t r = {{p[0], p[1], p[2], p[3]}};
+    return r;
+}
+
+static inline void vd4_store(double* p, seriesVd4_t a) {
+    for(uint32_t j = 0; j < 4; j++) {
+        p[j] = a.v[j];
+    }
+}
+
+#define SIMD_SUFFIX     scalar4
+#define VF              seriesVf4_t
+#define VF_LANES        4
+#define VF_SET1         vf4_set1
+#define VF_LOAD         vf4_load
+#define VF_STORE        vf4_store
+#define VF_ADD          vf4_add
+#define VF_SUB          vf4_sub
+#define VF_MUL          vf4_mul
+#define VF_DIV          vf4_div
+#define VF_HAS_FMA      FF_HAS_FMA
+#define VF_FMS          vf4_fms
+#define VD              seriesVd4_t
+#define VD_LANES        4
+#define VD_SET1         vd4_set1
+#define VD_LOAD         vd4_load
+#define VD_STORE        vd4_store
+#define VD_ADD          vd4_add
+#define VD_MUL          vd4_mul
+#define VD_DIV          vd4_div
+#include "picalc_simd_kernels.inc"
+#undef SIMD_SUFFIX
+#undef VF
+#undef VF_LANES
+#undef VF_SET1
+#undef VF_LOAD
+#undef VF_STORE
+#undef VF_ADD
+#undef VF_SUB
+#undef VF_MUL
+#undef VF_DIV
+#undef VF_HAS_FMA
+#undef VF_FMS
+#undef VD
+#undef VD_LANES
+#undef VD_SET1
+#undef VD_LOAD
+#undef VD_STORE
+#undef VD_ADD
+#undef VD_MUL
+#undef VD_DIV
+
+#if SERIES_SIMD_HAS_X86
+
+#pragma GCC push_options
+#pragma GCC target("sse2")
+#define SIMD_SUFFIX     sse2
+#define VF              __m128
+#define VF_LANES        4
+#define VF_SET1         _mm_set1_ps
+#define VF_LOAD         _mm_loadu_ps
+#define VF_STORE        _mm_storeu_ps
+#define VF_ADD          _mm_add_ps
+#define VF_SUB          _mm_sub_ps
+#define VF_MUL          _mm_mul_ps
+#define VF_DIV          _mm_div_ps
+#define VF_HAS_FMA      0
+#define VD              __m128d
+#define VD_LANES        2
+#define VD_SET1         _mm_set1_pd
+#define VD_LOAD         _mm_loadu_pd
+#define VD_STORE        _mm_storeu_pd
+#define VD_ADD          _mm_add_pd
+#define VD_MUL          _mm_mul_pd
+#define VD_DIV          _mm_div_pd
+#include "picalc_simd_kernels.inc"
+#undef SIMD_SUFFIX
+#undef VF
+#undef VF_LANES
+#undef VF_SET1
+#undef VF_LOAD
+#undef VF_STORE
+#undef VF_ADD
+#undef VF_SUB
+#undef VF_MUL
+#undef VF_DIV
+#undef VF_HAS_FMA
+#undef VD
+#undef VD_LANES
+#undef VD_SET1
+#undef VD_LOAD
+#undef VD_STORE
+#undef VD_ADD
+#undef VD_MUL
+#undef VD_DIV
+#pragma GCC pop_options
+
+#pragma GCC push_options
+#pragma GCC target("avx2,fma")
+#define SIMD_SUFFIX     avx2
+#define VF              __m256
+#define VF_LANES        8
+#define VF_SET1         _mm256_set1_ps
+#define VF_LOAD         _mm256_loadu_ps
+#define VF_STORE        _mm256_storeu_ps
+#define VF_ADD          _mm256_add_ps
+#define VF_SUB          _mm256_sub_ps
+#define VF_MUL          _mm256_mul_ps
+#define VF_DIV          _mm256_div_ps
+#define VF_HAS_FMA      1
+#define VF_FMS          _mm256_fmsub_ps
+#define VD              __m256d
+#define VD_LANES        4
+#define VD_SET1         _mm256_set1_pd
+#define VD_LOAD         _mm256_loadu_pd
+#define VD_STORE        _mm256_storeu_pd
+#define VD_ADD          _mm256_add_pd
+#define VD_MUL          _mm256_mul_pd
+#define VD_DIV          _mm256_div_pd
+#include "picalc_simd_kernels.inc"
+#undef SIMD_SUFFIX
+#undef VF
+#undef VF_LANES
+#undef VF_SET1
+#undef VF_LOAD
+#undef VF_STORE
+#undef VF_ADD
+#undef VF_SUB
+#undef VF_MUL
+#undef VF_DIV
+#undef VF_HAS_FMA
+#undef VF_FMS
+#undef VD
+#undef VD_LANES
+#undef VD_SET1
+#undef VD_LOAD
+#undef VD_STORE
+#undef VD_ADD
+#undef VD_MUL
+#undef VD_DIV
+#pragma GCC pop_options
+
+#endif
+
+const char* series_simd_name(seriesSimd_t backend) {
+    switch(backend) {
+        case SERIES_SIMD_SCALAR:
+            return "scalar";
+        case SERIES_SIMD_SSE2:
+            return "SSE2";
+        case SERIES_SIMD_AVX2:
+            return "AVX2";
+    }
+    return "?";
+}
+
+uint32_t series_simd_lanes(seriesSimd_t backend) {
+    return (backend == SERIES_SIMD_AVX2) ? 8 : 4;
+}
+
+bool series_simd_available(seriesSimd_t backend) {
+    switch(backend) {
+        case SERIES_SIMD_SCALAR:
+            return true;
+#if SERIES_SIMD_HAS_X86
+        case SERIES_SIMD_SSE2:
+            return __builtin_cpu_supports("sse2");
+        case SERIES_SIMD_AVX2:
+            return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+#endif
+        default:
+            return false;
+    }
+}
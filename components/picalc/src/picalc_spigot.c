@@ -0,0 +1,97 @@
+#include "../picalc_spigot.h"
+
+bool spigot_init(spigot_t* s, uint32_t digits, uint32_t* cells) {
+    if(digits > SPIGOT_DIGIT_LIMIT) {
+        return false;
+    }
+    s->cells = cells;
+    s->length = SPIGOT_CELLS(digits);
+    s->digits = digits;
+    s->steps = 0;
+    s->emitted = 0;
+    s->predigit = 0;
+    s->nines = 0;
+    s->leadPending = false;
+    s->lead = 0;
+    s->fillDigit = 0;
+    s->fillCount = 0;
+    for(uint32_t i = 0; i < s->length; i++) {
+        cells[i] = 2;
+    }
+    return true;
+}
+
+// Total passes: two more than digits so the last requested digit is proven by a later pass
+static inline uint32_t spigot_total_steps(const spigot_t* s) {
+    return s->digits + 2;
+}
+
+static void spigot_pass(spigot_t* s) {
+    // The low weight cells at the top of the array only matter for later digits. Each digit
+    // needs log2(10) = 3.32 cells, dropping 3 per pass keeps a margin that grows with every pass.
+    uint32_t shrink = (uint32_t)(s->steps * 3);
+    uint32_t active = (s->length > shrink + 1) ? s->length - shrink : 1;
+    uint32_t* cells = s->cells;
+
+    // x < 40 * length, see SPIGOT_DIGIT_LIMIT
+    uint32_t q = 0;
+    for(uint32_t i = active; i > 0; i--) {
+        uint32_t x = 10 * cells[i - 1] + q * i;
+        uint32_t d = 2 * i - 1;
+        q = x / d;
+        cells[i - 1] = x - q * d;
+    }
+    cells[0] = q % 10;
+    q /= 10;
+    s->steps++;
+
+    if(q == 9) {
+        s->nines++;
+    } else if(q == 10) {
+        // carry into the held digits: predigit + 1 followed by the nines turned into zeros
+        s->lead = s->predigit + 1;
+        s->leadPending = true;
+        s->fillDigit = 0;
+        s->fillCount = s->nines;
+        s->predigit = 0;
+        s->nines = 0;
+    } else {
+        s->lead = s->predigit;
+        s->leadPending = (s->steps > 1);    // the first pass only yields a leading zero
+        s->fillDigit = 9;
+        s->fillCount = s->nines;
+        s->predigit = (uint8_t)q;
+        s->nines = 0;
+    }
+}
+
+uint32_t spigot_generate(spigot_t* s, ringbuf_t* rb, uint32_t maxDigits) {
+    uint32_t pushed = 0;
+    while(pushed < maxDigits && !spigot_done(s)) {
+        if(s->leadPending) {
+            if(!ringbuf_push(rb, s->lead)) {
+                break;
+            }
+            s->leadPending = false;
+            s->emitted++;
+            pushed++;
+        } else if(s->fillCount > 0) {
+            if(!ringbuf_push(rb, s->fillDigit)) {
+                break;
+            }
+            s->fillCount--;
+            s->emitted++;
+            pushed++;
+        } else if(s->steps < spigot_total_steps(s)) {
+            spigot_pass(s);
+        } else {
+            // Out of passes while digits are still held back, release them as they are
+            s->lead = s->predigit;
+            s->leadPending = true;
+            s->fillDigit = 9;
+            s->fillCount = s->nines;
+            s->nines = 0;
+        }
+    }
+    return pushed;
+}
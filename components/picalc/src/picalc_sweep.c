@@ -0,0 +1,164 @@
+#include <stdlib.h>
+
+#include "../picalc_sweep.h"
+#include "../picalc_port.h"
+
+typedef struct {
+    bool reached;
+    uint64_t count;
+    int64_t us;
+    int64_t cpuUs;
+    uint64_t cycles;
+} sweepRun_t;
+
+void sweep_default_config(sweepConfig_t* sc) {
+    sc->algos = PI_ALGO_ALL;
+    sc->minDigits = 1;
+    sc->maxDigits = 10;
+    sc->repeats = 3;
+    sc->timeoutUs = 10000000;
+    sc->sliceUs = 1000;
+    sc->config = (piAlgoConfig_t){SERIES_FORMAT_ADAPTIVE, SERIES_SUM_NEUMAIER, SERIES_ACCEL_NONE, 1, SERIES_SPLIT_BLOCKED, NULL, 0, 0};
+    sc->format = SWEEP_FORMAT_CSV;
+    sc->out = stdout;
+    sc->cancel = NULL;
+}
+
+// false if cancelled, run->reached tells whether the target was reached before the timeout
+static bool sweep_run_once(const sweepConfig_t* sc, const piAlgo_t* algo, uint32_t digits, sweepRun_t* run) {
+    // the engine only widens its number format as far as this target needs
+    piAlgoConfig_t config = sc->config;
+    config.digitTarget = digits;
+    void* state = algo_create(algo, &config);
+    // from a single term, the batches grow 4x per step, so the small targets get exact counts
+    uint32_t batch = 1;
+    int64_t lastYield = picalc_time_us();
+    *run = (sweepRun_t){false, 0, 0, 0, 0};
+    while(run->us < sc->timeoutUs) {
+        if(sc->cancel != NULL && *sc->cancel) {
+            free(state);
+            return false;
+        }
+        // steps stay far below the 17 s wrap of the 32-bit cycle counter on the board
+        uint64_t cpuStart = picalc_cpu_time_us();
+        uint64_t cycleStart = picalc_cycle_count();
+        int64_t start = picalc_time_us();
+        algo->step(state, batch);
+        uint32_t reached = algo_digits(algo, state);
+        int64_t end = picalc_time_us();
+        run->cycles += picalc_cycles_since(cycleStart);
+        run->cpuUs += (int64_t)picalc_cpu_time_since_us(cpuStart);
+        run->us += end - start;
+        batch = algo_next_batch(batch, end - start, sc->sliceUs);
+        if(reached >= digits) {
+            run->reached = true;
+            break;
+        }
+        if(end - lastYield >= SWEEP_YIELD_US) {
+            picalc_yield();
+            lastYield = picalc_time_us();
+        }
+    }
+    run->count = algo->count(state);
+    free(state);
+    return true;
+}
+
+static int sweep_compare_us(const void* a, const void* b) {
+    int64_t x = ((const sweepRun_t*)a)->us;
+    int64_t y = ((const sweepRun_t*)b)->us;
+    return (x > y) - (x < y);
+}
+
+bool sweep_measure(const sweepConfig_t* sc, piAlgoId_t id, uint32_t digits, sweepResult_t* result) {
+    sweepRun_t runs[SWEEP_MAX_REPEATS];
+    uint32_t repeats = (sc->repeats > SWEEP_MAX_REPEATS) ? SWEEP_MAX_REPEATS : sc->repeats;
+    uint32_t reached = 0;
+    *result = (sweepResult_t){id, digits, 0, 0, 0, 0, 0, 0, 0, 0, 0};
+    for(uint32_t i = 0; i < repeats; i++) {
+        if(!sweep_run_once(sc, &piAlgos[id], digits, &runs[reached])) {
+            return false;
+        }
+        result->runs++;
+        if(!runs[reached].reached) {
+            // a deterministic engine would time out again, Monte-Carlo most likely too
+            break;
+        }
+        reached++;
+    }
+    result->reached = reached;
+    result->heapPeak = picalc_heap_peak();
+    if(reached == 0) {
+        return true;
+    }
+    // count, CPU time and cycles of the run with the median wall time
+    qsort(runs, reached, sizeof(sweepRun_t), sweep_compare_us);
+    const sweepRun_t* median = &runs[reached / 2];
+    result->count = median->count;
+    result->usMin = runs[0].us;
+    result->usMedian = median->us;
+    result->usMax = runs[reached - 1].us;
+    result->cpuUs = median->cpuUs;
+    result->cycles = median->cycles;
+    return true;
+}
+
+void sweep_print_header(const sweepConfig_t* sc) {
+    if(sc->format == SWEEP_FORMAT_CSV) {
+        fprintf(sc->out, "platform,engine,digits,runs,reached,count,us_min,us_median,us_max,cpu_us,cycles,state_bytes,heap_peak\n");
+    } else {
+        fprintf(sc->out, "[\n");
+    }
+}
+
+void sweep_print_result(const sweepConfig_t* sc, const sweepResult_t* r, bool first) {
+    const piAlgo_t* algo = &piAlgos[r->id];
+    if(sc->format == SWEEP_FORMAT_CSV) {
+        fprintf(sc->out, "%s,%s,%u,%u,%u,%llu,%lld,%lld,%lld,%lld,%llu,%u,%u\n", picalc_platform_name(), algo->name,
+                (unsigned)r->digits, (unsigned)r->runs, (unsigned)r->reached, (unsigned long long)r->count,
+                (long long)r->usMin, (long long)r->usMedian, (long long)r->usMax, (long long)r->cpuUs,
+                (unsigned long long)r->cycles, (unsigned)algo->stateSize, (unsigned)r->heapPeak);
+    } else {
+        fprintf(sc->out, "%s  {\"platform\": \"%s\", \"engine\": \"%s\", \"digits\": %u, \"runs\": %u, \"reached\": %u, "
+                "\"count\": %llu, \"us_min\": %lld, \"us_median\": %lld, \"us_max\": %lld, \"cpu_us\": %lld, "
+                "\"cycles\": %llu, \"state_bytes\": %u, \"heap_peak\": %u}",
+                first ? "" : ",\n", picalc_platform_name(), algo->name, (unsigned)r->digits, (unsigned)r->runs,
+                (unsigned)r->reached, (unsigned long long)r->count, (long long)r->usMin, (long long)r->usMedian,
+                (long long)r->usMax, (long long)r->cpuUs, (unsigned long long)r->cycles, (unsigned)algo->stateSize,
+                (unsigned)r->heapPeak);
+    }
+    fflush(sc->out);
+}
+
+void sweep_print_footer(const sweepConfig_t* sc) {
+    if(sc->format == SWEEP_FORMAT_JSON) {
+        fprintf(sc->out, "\n]\n");
+    }
+    fflush(sc->out);
+}
+
+bool sweep_run(const sweepConfig_t* sc) {
+    uint32_t maxDigits = (sc->maxDigits > ALGO_MAX_DIGITS) ? ALGO_MAX_DIGITS : sc->maxDigits;
+    bool first = true;
+    bool done = true;
+    sweep_print_header(sc);
+    for(uint32_t id = 0; id < PI_ALGO_COUNT && done; id++) {
+        if(!(sc->algos & PI_ALGO_MASK(id))) {
+            continue;
+        }
+        for(uint32_t digits = sc->minDigits; digits <= maxDigits; digits++) {
+            sweepResult_t result;
+            if(!sweep_measure(sc, (piAlgoId_t)id, digits, &result)) {
+                done = false;
+                break;
+            }
+            sweep_print_result(sc, &result, first);
+            first = false;
+            if(result.reached == 0) {
+                break;
+            }
+        }
+    }
+    sweep_print_footer(sc);
+    return done;
+}
@@ -0,0 +1,1217 @@
+/********************************************************************************************* */
+//    picalc host tests
+//    Pass/fail checks of the engine code, registered with CTest. Timings stay in picalc_bench.
+//
+//    Usage: picalc_test [test...], all tests without arguments
+/********************************************************************************************* */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <float.h>
+
+#include "picalc_bigint.h"
+#include "picalc_ntt.h"
+#include "picalc_chudnovsky.h"
+#include "picalc_spigot.h"
+#include "picalc_bbp.h"
+#include "picalc_machin.h"
+#include "picalc_agm.h"
+#include "picalc_series.h"
+#include "picalc_executor.h"
+#include "picalc_simd.h"
+#include "picalc_algo.h"
+#include "picalc_montecarlo.h"
+#include "picalc_race.h"
+#include "picalc_checkpoint.h"
+#include "picalc_port.h"
+
+#define PI_PREFIX "3.14159265358979323846264338327950288419716939937510"
+#define PI_HEX_PREFIX "243F6A8885A308D313198A2E03707344A4093822299F31D0082EFA98EC4E6C89"
+// floor(pi * 2^62), pi lies strictly between this and the next integer
+#define PI_Q62 0xC90FDAA22168C234ull
+// hex digits 1000000.. (counted from 1), i.e. position 999999 of bbp_hex_digits
+#define PI_HEX_AT_999999 "26C65E52CB4593"
+
+static uint64_t testBigintSeed = 0x2545F4914F6CDD1Dull;
+
+static uint64_t test_bigint_random(void) {
+    testBigintSeed ^= testBigintSeed << 13;
+    testBigintSeed ^= testBigintSeed >> 7;
+    testBigintSeed ^= testBigintSeed << 17;
+    return testBigintSeed;
+}
+
+// Random limbs, some operands all ones or with runs of zero limbs to hit the carries
+static void test_bigint_fill(bigint_limb_t* a, size_t n) {
+    uint64_t pattern = test_bigint_random() % 4;
+    for(size_t i = 0; i < n; i++) {
+        bigint_limb_t limb = (bigint_limb_t)test_bigint_random();
+        a[i] = (pattern == 0) ? (bigint_limb_t)~(bigint_limb_t)0 : (pattern == 1 && i % 3 == 1) ? 0 : limb;
+    }
+    if(n > 0 && a[n - 1] == 0) {
+        a[n - 1] = 1;
+    }
+}
+
+// Byte by byte schoolbook, shares no code with the bigint it checks
+static void test_bigint_reference(bigint_limb_t* r, const bigint_limb_t* a, size_t an, const bigint_limb_t* b, size_t bn) {
+    size_t aBytes = an * sizeof(bigint_limb_t), bBytes = bn * sizeof(bigint_limb_t);
+    const uint8_t* x = (const uint8_t*)a;
+    const uint8_t* y = (const uint8_t*)b;
+    uint32_t* sum = calloc(aBytes + bBytes + 1, sizeof(uint32_t));
+    for(size_t i = 0; i < aBytes; i++) {
+        uint32_t carry = 0;
+        for(size_t j = 0; j < bBytes; j++) {
+            uint32_t t = sum[i + j] + (uint32_t)x[i] * y[j] + carry;
+            sum[i + j] = t & 0xFF;
+            carry = t >> 8;
+        }
+        for(size_t k = i + bBytes; carry != 0; k++) {
+            uint32_t t = sum[k] + carry;
+            sum[k] = t & 0xFF;
+            carry = t >> 8;
+        }
+    }
+    uint8_t* bytes = (uint8_t*)r;
+    for(size_t i = 0; i < aBytes + bBytes; i++) {
+        bytes[i] = (uint8_t)sum[i];
+    }
+    free(sum);
+}
+
+static void test_bigint_from_limbs(bigint_t* r, const bigint_limb_t* a, size_t n, bool negative) {
+    bigint_reserve(r, n);
+    memcpy(r->limbs, a, n * sizeof(bigint_limb_t));
+    r->size = n;
+    while(r->size > 0 && r->limbs[r->size - 1] == 0) {
+        r->size--;
+    }
+    r->negative = negative && r->size > 0;
+}
+
+// Long products on the calling thread and on an executor: the transforms have to agree with each
+// other, with Toom-3 and modulo a few small primes
+static int test_bigint_ntt(void) {
+    const size_t maxLimbs = 4096;
+    executor_t ex;
+    executor_init(&ex, picalc_core_count(), 1);
+    bigint_limb_t* a = malloc(2 * maxLimbs * sizeof(bigint_limb_t));
+    bigint_limb_t* b = &a[maxLimbs];
+    bigint_limb_t* serial = malloc(2 * maxLimbs * sizeof(bigint_limb_t));
+    bigint_limb_t* parallel = malloc(2 * maxLimbs * sizeof(bigint_limb_t));
+    bigint_limb_t* toom = malloc(2 * maxLimbs * sizeof(bigint_limb_t));
+    const bigintMulThresholds_t noNtt = {BIGINT_KARATSUBA_THRESHOLD, BIGINT_TOOM3_THRESHOLD, SIZE_MAX};
+    int result = 0;
+    for(size_t n = 1024; n <= maxLimbs; n *= 2) {
+        test_bigint_fill(a, n);
+        test_bigint_fill(b, n);
+        bigint_mul_limbs(toom, a, n, b, n, BIGINT_MUL_AUTO, &noNtt);
+        ntt_set_executor(NULL);
+        bool done = ntt_mul(serial, a, n, b, n);
+        ntt_set_executor(&ex);
+        done = done && ntt_mul(parallel, a, n, b, n);
+        ntt_set_executor(NULL);
+        if(!done) {
+            fprintf(stderr, "bigint: %u limbs are too long for the transforms\n", (unsigned)n);
+            result = 1;
+            break;
+        }
+
+        bigint_t x, y, p, rest;
+        bigint_init(&x);
+        bigint_init(&y);
+        bigint_init(&p);
+        bigint_init(&rest);
+        test_bigint_from_limbs(&x, a, n, false);
+        test_bigint_from_limbs(&y, b, n, false);
+        test_bigint_from_limbs(&p, serial, 2 * n, false);
+        bool modular = true;
+        for(int i = 0; i < 4; i++) {
+            uint32_t q = (uint32_t)test_bigint_random() | 1;
+            uint64_t expected = (uint64_t)bigint_div_u32(&rest, &x, q) * bigint_div_u32(&rest, &y, q) % q;
+            modular = modular && bigint_div_u32(&rest, &p, q) == expected;
+        }
+        bigint_free(&x);
+        bigint_free(&y);
+        bigint_free(&p);
+        bigint_free(&rest);
+        if(!modular || memcmp(serial, parallel, 2 * n * sizeof(bigint_limb_t)) != 0 ||
+           memcmp(serial, toom, 2 * n * sizeof(bigint_limb_t)) != 0) {
+            fprintf(stderr, "bigint: ntt product of %u limbs is wrong\n", (unsigned)n);
+            result = 1;
+        }
+    }
+    executor_shutdown(&ex);
+    free(a);
+    free(serial);
+    free(parallel);
+    free(toom);
+    return result;
+}
+
+// Every multiplication method against the byte-wise reference, with the built-in crossovers and
+// with tiny ones so every level of a small product recurses. Then the signed wrapper, the
+// division and the shifts on the same operands, and the long products of the transforms.
+static int test_bigint(void) {
+    const size_t maxLimbs = 200;
+    const uint32_t rounds = 150;
+    const bigintMulThresholds_t deep = {2, 3, SIZE_MAX};
+    static const bigintMul_t methods[] = {BIGINT_MUL_AUTO, BIGINT_MUL_SCHOOLBOOK, BIGINT_MUL_KARATSUBA, BIGINT_MUL_TOOM3,
+                                          BIGINT_MUL_NTT};
+    static const char* const names[] = {"auto", "schoolbook", "karatsuba", "toom3", "ntt"};
+    bigint_limb_t* a = malloc(2 * maxLimbs * sizeof(bigint_limb_t));
+    bigint_limb_t* b = &a[maxLimbs];
+    bigint_limb_t* expected = malloc(2 * maxLimbs * sizeof(bigint_limb_t));
+    bigint_limb_t* r = malloc(2 * maxLimbs * sizeof(bigint_limb_t));
+    bigint_t x, y, q, rem, t;
+    bigint_init(&x);
+    bigint_init(&y);
+    bigint_init(&q);
+    bigint_init(&rem);
+    bigint_init(&t);
+    executor_t ex;
+    executor_init(&ex, picalc_core_count(), 1);
+    int result = 0;
+    for(uint32_t round = 0; round < rounds && result == 0; round++) {
+        // every third pair unbalanced, every fifth a square, the transforms on the executor every other round
+        size_t an = 1 + test_bigint_random() % maxLimbs;
+        size_t bn = (round % 3 == 2) ? 1 + test_bigint_random() % (an / 4 + 1) : 1 + test_bigint_random() % an;
+        test_bigint_fill(a, an);
+        test_bigint_fill(b, bn);
+        const bigint_limb_t* factor = b;
+        if(round % 5 == 4) {
+            factor = a;
+            bn = an;
+        }
+        ntt_set_executor((round & 1) ? &ex : NULL);
+        test_bigint_reference(expected, a, an, factor, bn);
+        for(size_t m = 0; m < sizeof(methods) / sizeof(methods[0]); m++) {
+            for(int d = 0; d < 2; d++) {
+                bigint_mul_limbs(r, a, an, factor, bn, methods[m], d ? &deep : NULL);
+                if(memcmp(r, expected, (an + bn) * sizeof(bigint_limb_t)) != 0) {
+                    fprintf(stderr, "bigint: %s%s product of %u x %u limbs is wrong\n", names[m], d ? " (deep)" : "",
+                            (unsigned)an, (unsigned)bn);
+                    result = 1;
+                }
+            }
+        }
+
+        test_bigint_from_limbs(&x, a, an, round & 1);
+        test_bigint_from_limbs(&y, factor, bn, round & 2);
+        bigint_mul(&t, &x, &y);
+        test_bigint_from_limbs(&q, expected, an + bn, x.negative != y.negative);
+        if(bigint_cmp(&t, &q) != 0) {
+            fprintf(stderr, "bigint: bigint_mul of %u x %u limbs is wrong\n", (unsigned)an, (unsigned)bn);
+            result = 1;
+        }
+        x.negative = y.negative = false;
+        bigint_divmod(&q, &rem, &x, &y);
+        bigint_mul(&t, &q, &y);
+        bigint_add(&t, &t, &rem);
+        if(bigint_cmp(&t, &x) != 0 || bigint_cmp_abs(&rem, &y) >= 0) {
+            fprintf(stderr, "bigint: divmod of %u by %u limbs is wrong\n", (unsigned)an, (unsigned)bn);
+            result = 1;
+        }
+        size_t bits = test_bigint_random() % 200;
+        bigint_shl(&t, &x, bits);
+        bigint_shr(&t, &t, bits);
+        bigint_add(&q, &x, &y);
+        bigint_sub(&q, &q, &y);
+        uint32_t divisor = (uint32_t)test_bigint_random() | 1;
+        uint32_t remainder = bigint_div_u32(&rem, &x, divisor);
+        bigint_mul_u32(&rem, &rem, divisor);
+        bigint_add_u32(&rem, &rem, remainder);
+        if(bigint_cmp(&t, &x) != 0 || bigint_cmp(&q, &x) != 0 || bigint_cmp(&rem, &x) != 0) {
+            fprintf(stderr, "bigint: shift, add or div_u32 round trip of %u limbs is wrong\n", (unsigned)an);
+            result = 1;
+        }
+    }
+    bigint_free(&x);
+    bigint_free(&y);
+    bigint_free(&q);
+    bigint_free(&rem);
+    bigint_free(&t);
+    ntt_set_executor(NULL);
+    executor_shutdown(&ex);
+    free(a);
+    free(expected);
+    free(r);
+    return result | test_bigint_ntt();
+}
+
+// The digit engines against each other: Chudnovsky against the known prefix, then the spigot,
+// every Machin formula sequential and with a worker per series, and AGM against Chudnovsky.
+// BBP against the known hex digits.
+static int test_digits(void) {
+    const uint32_t digits = 2000;
+    char* reference = malloc(digits + 3);
+    char* out = malloc(digits + 3);
+    uint32_t* cells = malloc(SPIGOT_CELLS(digits) * sizeof(uint32_t));
+    if(reference == NULL || out == NULL || cells == NULL) {
+        abort();
+    }
+    int result = 0;
+    if(!chudnovsky_compute(digits, reference, digits + 3, NULL, NULL) ||
+       strncmp(reference, PI_PREFIX, strlen(PI_PREFIX)) != 0) {
+        fprintf(stderr, "chudnovsky: wrong digits\n");
+        free(reference);
+        free(out);
+        free(cells);
+        return 1;
+    }
+
+    spigot_t spigot;
+    uint8_t storage[256];
+    ringbuf_t rb;
+    uint8_t value;
+    uint32_t count = 0;
+    spigot_init(&spigot, digits, cells);
+    ringbuf_init(&rb, storage, sizeof(storage));
+    while(!spigot_done(&spigot) || ringbuf_count(&rb) > 0) {
+        spigot_generate(&spigot, &rb, UINT32_MAX);
+        while(ringbuf_pop(&rb, &value)) {
+            // the spigot emits 3 1 4 1 ..., the reference has the decimal point
+            if(count > digits || reference[count == 0 ? 0 : count + 1] != '0' + value) {
+                fprintf(stderr, "spigot: wrong digit at %u\n", (unsigned)count);
+                result = 1;
+            }
+            count++;
+        }
+    }
+    if(count != digits || spigot_init(&spigot, SPIGOT_DIGIT_LIMIT + 1, cells)) {
+        fprintf(stderr, "spigot: %u digits, or a target past SPIGOT_DIGIT_LIMIT was taken\n", (unsigned)count);
+        result = 1;
+    }
+
+    for(machinFormula_t formula = MACHIN_FORMULA_MACHIN; formula <= MACHIN_FORMULA_STORMER; formula++) {
+        for(uint32_t workers = 1; workers <= 2; workers++) {
+            // workers = 0 hands every series its own worker, like the tasks on the board
+            if(!machin_compute(formula, digits, out, digits + 3, workers == 1 ? 1 : 0, NULL, NULL) ||
+               strcmp(out, reference) != 0) {
+                fprintf(stderr, "machin: %s gives wrong digits\n", machin_formula_name(formula));
+                result = 1;
+            }
+        }
+    }
+    if(!agm_compute(digits, out, digits + 3, NULL, NULL) || strcmp(out, reference) != 0) {
+        fprintf(stderr, "agm: wrong digits\n");
+        result = 1;
+    }
+
+    char hex[sizeof(PI_HEX_PREFIX)];
+    if(!bbp_hex_digits(0, strlen(PI_HEX_PREFIX), hex, 1) || strcmp(hex, PI_HEX_PREFIX) != 0) {
+        fprintf(stderr, "bbp: wrong leading hex digits\n");
+        result = 1;
+    }
+    for(uint32_t workers = 1; workers <= 2; workers++) {
+        if(!bbp_hex_digits(999999, strlen(PI_HEX_AT_999999), hex, workers) || strcmp(hex, PI_HEX_AT_999999) != 0) {
+            fprintf(stderr, "bbp: wrong digits at position 999999 on %u workers\n", (unsigned)workers);
+            result = 1;
+        }
+    }
+    free(reference);
+    free(out);
+    free(cells);
+    return result;
+}
+
+// Relative error in bits below 1, i.e. how many mantissa bits are right
+static double test_bits(long double value, long double reference) {
+    long double error = fabsl(value - reference);
+    if(error == 0.0L) {
+        return 64.0;
+    }
+    return -log2((double)(error / fabsl(reference)));
+}
+
+static long double test_series_long_double(bool leibniz, uint32_t terms) {
+    long double sum = 0.0L;
+    for(uint32_t k = 0; k < terms; k++) {
+        if(leibniz) {
+            long double term = 1.0L / (2.0L * k + 1.0L);
+            sum += (k & 1) ? -term : term;
+        } else {
+            long double d = (long double)k + 1.0L;
+            sum += 1.0L / (d * d);
+        }
+    }
+    return sum;
+}
+
+// Float-float operations and series kernels against long double, and the vector back ends
+static int test_ff(void) {
+    static const char* opNames[] = {"add", "mul", "div", "recip", "sqrt"};
+    int result = 0;
+    srand(1);
+    for(int i = 0; i < 100000; i++) {
+        double x = ldexp((double)rand() / RAND_MAX + 0.5, rand() % 40 - 20);
+        double y = ldexp((double)rand() / RAND_MAX + 0.5, rand() % 40 - 20);
+        ff_t a = ff_from_double(x);
+        ff_t b = ff_from_double(y);
+        long double la = ff_to_long_double(a);
+        long double lb = ff_to_long_double(b);
+        double bits[5] = {
+            test_bits(ff_to_long_double(ff_add(a, b)), la + lb),
+            test_bits(ff_to_long_double(ff_mul(a, b)), la * lb),
+            test_bits(ff_to_long_double(ff_div(a, b)), la / lb),
+            test_bits(ff_to_long_double(ff_recip(b)), 1.0L / lb),
+            test_bits(ff_to_long_double(ff_sqrt(a)), sqrtl(la)),
+        };
+        for(int op = 0; op < 5; op++) {
+            if(bits[op] < 44.0) {
+                fprintf(stderr, "ff: %s of %a and %a has %.1f bits\n", opNames[op], x, y, bits[op]);
+                result = 1;
+                i = 100000;
+            }
+        }
+    }
+
+    for(int leibniz = 1; leibniz >= 0; leibniz--) {
+        for(uint32_t terms = 1000; terms <= 1000000; terms *= 10) {
+            long double reference = test_series_long_double(leibniz, terms);
+            ff_t f = leibniz ? series_leibniz_ff(ff_from_float(0.0f), 0, terms) : series_basel_ff(ff_from_float(0.0f), 1, terms);
+            if(test_bits(ff_to_long_double(f), reference) < 40.0) {
+                fprintf(stderr, "ff: %s sum lost precision at %u terms\n", leibniz ? "Leibniz" : "Basel", (unsigned)terms);
+                result = 1;
+            }
+        }
+    }
+    return result;
+}
+
+typedef struct {
+    seriesSimd_t backend;
+    ff_t (*leibnizFf)(ff_t sum, uint64_t start, uint32_t count);
+    ff_t (*baselFf)(ff_t sum, uint64_t start, uint32_t count);
+    double (*leibnizDouble)(double sum, uint64_t start, uint32_t count);
+    double (*baselDouble)(double sum, uint64_t start, uint32_t count);
+} testSimdKernels_t;
+
+static const testSimdKernels_t testSimdKernels[] = {
+    {SERIES_SIMD_SCALAR, series_leibniz_ff_scalar4, series_basel_ff_scalar4, series_leibniz_double_scalar4, series_basel_double_scalar4},
+#if SERIES_SIMD_HAS_X86
+    {SERIES_SIMD_SSE2, series_leibniz_ff_sse2, series_basel_ff_sse2, series_leibniz_double_sse2, series_basel_double_sse2},
+    {SERIES_SIMD_AVX2, series_leibniz_ff_avx2, series_basel_ff_avx2, series_leibniz_double_avx2, series_basel_double_avx2},
+#endif
+};
+
+static int test_simd(void) {
+    const uint32_t terms = 1000000;
+    int result = 0;
+    for(int leibniz = 1; leibniz >= 0; leibniz--) {
+        long double reference = test_series_long_double(leibniz, terms);
+        uint32_t start = leibniz ? 0 : 1;
+        for(size_t i = 0; i < sizeof(testSimdKernels) / sizeof(testSimdKernels[0]); i++) {
+            const testSimdKernels_t* k = &testSimdKernels[i];
+            if(!series_simd_available(k->backend)) {
+                continue;
+            }
+            ff_t f = leibniz ? k->leibnizFf(ff_from_float(0.0f), start, terms) : k->baselFf(ff_from_float(0.0f), start, terms);
+            double d = leibniz ? k->leibnizDouble(0.0, start, terms) : k->baselDouble(0.0, start, terms);
+            if(test_bits(ff_to_long_double(f), reference) < 40.0 || test_bits(d, reference) < 40.0) {
+                fprintf(stderr, "simd: %s %s lost precision\n", series_simd_name(k->backend), leibniz ? "Leibniz" : "Basel");
+                result = 1;
+            }
+        }
+    }
+    return result;
+}
+
+// Digits the sprintf compare of the estimate against M_PI claims, the way the digits were counted
+// before the intervals
+static uint32_t test_string_digits(double estimate) {
+    char calc[32], ref[32];
+    snprintf(calc, sizeof(calc), "%.15f", estimate);
+    snprintf(ref, sizeof(ref), "%.15f", M_PI);
+    uint32_t digits = 0;
+    while(calc[2 + digits] != '\0' && calc[2 + digits] == ref[2 + digits]) {
+        digits++;
+    }
+    return digits;
+}
+
+// The Q2.62 interval holds pi along the running sums and never certifies more than the midpoint has
+static int test_fixed(void) {
+    int result = 0;
+    for(int leibniz = 1; leibniz >= 0; leibniz--) {
+        seriesFixed_t fixed;
+        series_fixed_init(&fixed);
+        for(uint32_t terms = 1000; terms <= 1000000; terms *= 10) {
+            uint32_t count = terms - fixed.terms;
+            uint64_t lo, hi;
+            if(leibniz) {
+                series_leibniz_fixed(&fixed, count);
+                series_leibniz_fixed_pi(&fixed, &lo, &hi);
+            } else {
+                series_basel_fixed(&fixed, count);
+                series_basel_fixed_pi(&fixed, &lo, &hi);
+            }
+            uint32_t certified = series_fixed_certified_digits(lo, hi);
+            if(lo > PI_Q62 || hi <= PI_Q62 || certified > test_string_digits(series_fixed_to_double(lo / 2 + hi / 2))) {
+                fprintf(stderr, "fixed: %s interval does not hold pi at %u terms\n", leibniz ? "Leibniz" : "Basel", (unsigned)terms);
+                result = 1;
+            }
+        }
+
+        // without terms, and with a sum the format cannot turn into pi, nothing is certified
+        seriesFixed_t outside[2];
+        series_fixed_init(&outside[0]);
+        series_fixed_init(&outside[1]);
+        outside[1].sum = leibniz ? SERIES_FIXED_ONE + 1000 : (uint64_t)1 << 63;
+        outside[1].terms = 1000;
+        for(uint32_t i = 0; i < 2; i++) {
+            uint64_t lo, hi;
+            if(leibniz) {
+                series_leibniz_fixed_pi(&outside[i], &lo, &hi);
+            } else {
+                series_basel_fixed_pi(&outside[i], &lo, &hi);
+            }
+            if(lo != 0 || hi != UINT64_MAX || series_fixed_certified_digits(lo, hi) != 0) {
+                fprintf(stderr, "fixed: %s certifies digits outside the format\n", leibniz ? "Leibniz" : "Basel");
+                result = 1;
+            }
+        }
+    }
+    return result;
+}
+
+// Term indices past 2^32: the kernels continue from a partial sum just below n = 2^32, a series_t
+// in Q2.62 keeps an interval around pi. The start sums come from the asymptotic remainders, their
+// error is far inside the 4096 units the start interval allows.
+static int test_wide(void) {
+    const uint64_t start = ((uint64_t)1 << 32) - 300;
+    const uint32_t count = 600;
+    const long double pi = 3.14159265358979323846264338327950288L;
+    int result = 0;
+    for(int leibniz = 1; leibniz >= 0; leibniz--) {
+        const char* name = leibniz ? "Leibniz" : "Basel";
+        // start is even, pi/4 - S_n = 1/(2m) + 1/(2m^2) + O(m^-4) with m = 2n + 1
+        long double m = 2.0L * (long double)start + 1.0L;
+        long double partial = leibniz ? pi / 4.0L - 1.0L / (2.0L * m) - 1.0L / (2.0L * m * m)
+                                      : pi * pi / 6.0L - (long double)accel_basel_tail(start);
+        long double reference = 0.0L;
+        for(uint64_t k = start; k < start + count; k++) {
+            long double d = leibniz ? 2.0L * (long double)k + 1.0L : (long double)(k + 1);
+            reference += leibniz ? ((k & 1) ? -1.0L / d : 1.0L / d) : 1.0L / (d * d);
+        }
+
+        // every term and add rounds by a unit of its format at most, relative to the largest partial
+        // sum. Past 2^24 Basel float-float takes 1/k of k rounded to float, a float unit per term.
+        double largest = leibniz ? 1.0 / (double)m : count / ((double)start * (double)start);
+        double values[3] = {
+            leibniz ? series_leibniz_double(0.0, start, count) : series_basel_double(0.0, start + 1, count),
+            ff_to_double(leibniz ? series_leibniz_ff(ff_from_float(0.0f), start, count)
+                                 : series_basel_ff(ff_from_float(0.0f), start + 1, count)),
+            leibniz ? series_leibniz_float(0.0f, start, count) : series_basel_float(0.0f, start + 1, count),
+        };
+        double tolerances[3] = {2 * count * DBL_EPSILON * largest, 2 * count * (leibniz ? SERIES_FF_EPSILON : FLT_EPSILON) * largest,
+                                2 * count * FLT_EPSILON * largest};
+        for(uint32_t i = 0; i < 3; i++) {
+            if(fabsl(values[i] - reference) > tolerances[i]) {
+                fprintf(stderr, "wide: %s kernel %u is off by %Lg past 2^32\n", name, (unsigned)i, fabsl(values[i] - reference));
+                result = 1;
+            }
+        }
+        for(size_t i = 0; i < sizeof(testSimdKernels) / sizeof(testSimdKernels[0]); i++) {
+            const testSimdKernels_t* k = &testSimdKernels[i];
+            if(!series_simd_available(k->backend)) {
+                continue;
+            }
+            double d = leibniz ? k->leibnizDouble(0.0, start, count) : k->baselDouble(0.0, start + 1, count);
+            double f = ff_to_double(leibniz ? k->leibnizFf(ff_from_float(0.0f), start, count)
+                                            : k->baselFf(ff_from_float(0.0f), start + 1, count));
+            if(fabsl(d - reference) > tolerances[0] || fabsl(f - reference) > tolerances[1]) {
+                fprintf(stderr, "wide: %s %s kernels are off past 2^32\n", series_simd_name(k->backend), name);
+                result = 1;
+            }
+        }
+
+        // an odd count in between takes the single term path of Leibniz
+        series_t series;
+        series_init(&series, leibniz ? SERIES_LEIBNIZ : SERIES_BASEL, SERIES_FORMAT_FIXED, SERIES_SUM_NAIVE);
+        series.terms = start;
+        series.fixed.terms = start;
+        series.fixed.sum = (uint64_t)llroundl(ldexpl(partial, SERIES_FIXED_FRACTION_BITS));
+        series.fixed.errorBelow = 4096;
+        series.fixed.errorAbove = 4096;
+        series_advance(&series, 101);
+        series_advance_parallel(&series, count - 101, 4, SERIES_SPLIT_BLOCKED);
+        uint64_t lo, hi;
+        if(leibniz) {
+            series_leibniz_fixed_pi(&series.fixed, &lo, &hi);
+        } else {
+            series_basel_fixed_pi(&series.fixed, &lo, &hi);
+        }
+        if(series.terms != start + count || series.fixed.terms != start + count || lo > PI_Q62 || hi <= PI_Q62 ||
+           series_fixed_certified_digits(lo, hi) < 8) {
+            fprintf(stderr, "wide: %s Q2.62 interval [%.17f, %.17f] after %llu terms\n", name, series_fixed_to_double(lo),
+                    series_fixed_to_double(hi), (unsigned long long)series.terms);
+            result = 1;
+        }
+    }
+    return result;
+}
+
+// The parallel partial sums give the bits of the single worker sum, for every split and worker
+// count, and the executor's chunks give the bits of the static split
+static int test_parallel(void) {
+    const uint32_t terms = 1000000;
+    int result = 0;
+    for(int kind = SERIES_LEIBNIZ; kind <= SERIES_BASEL; kind++) {
+        for(int format = SERIES_FORMAT_DOUBLE; format <= SERIES_FORMAT_FLOAT; format++) {
+            double reference = 0.0;
+            for(int split = SERIES_SPLIT_BLOCKED; split <= SERIES_SPLIT_INTERLEAVED; split++) {
+                for(uint32_t workers = 1; workers <= 4; workers *= 2) {
+                    series_t series;
+                    series_init(&series, (seriesKind_t)kind, (seriesFormat_t)format, SERIES_SUM_NEUMAIER);
+                    double value = series_advance_parallel(&series, terms, workers, (seriesSplit_t)split);
+                    if(split == SERIES_SPLIT_BLOCKED && workers == 1) {
+                        reference = value;
+                    } else if(memcmp(&value, &reference, sizeof(double)) != 0) {
+                        fprintf(stderr, "parallel: %s %s on %u workers differs\n", kind == SERIES_LEIBNIZ ? "Leibniz" : "Basel",
+                                series_format_name((seriesFormat_t)format), (unsigned)workers);
+                        result = 1;
+                    }
+                }
+            }
+        }
+    }
+
+    for(uint32_t workers = 1; workers <= 4; workers *= 2) {
+        executor_t* ex = malloc(sizeof(executor_t));
+        if(ex == NULL) {
+            abort();
+        }
+        executor_init(ex, workers, 1);
+        series_t a, b;
+        series_init(&a, SERIES_LEIBNIZ, SERIES_FORMAT_FF, SERIES_SUM_NEUMAIER);
+        series_init(&b, SERIES_LEIBNIZ, SERIES_FORMAT_FF, SERIES_SUM_NEUMAIER);
+        double va = series_advance_parallel(&a, terms, workers, SERIES_SPLIT_BLOCKED);
+        double vb = series_advance_executor(&b, terms, ex);
+        if(memcmp(&va, &vb, sizeof(double)) != 0) {
+            fprintf(stderr, "executor: series chunks on %u workers differ from the static split\n", (unsigned)workers);
+            result = 1;
+        }
+        executor_shutdown(ex);
+        free(ex);
+    }
+    return result;
+}
+
+// Item i costs about i * 64 terms, the first half of the range is far cheaper than the second
+#define TEST_UNEVEN_ITEMS   2048
+
+typedef struct {
+    double result[TEST_UNEVEN_ITEMS];
+} testUneven_t;
+
+static void test_uneven_range(void* arg, uint32_t begin, uint32_t end) {
+    testUneven_t* u = (testUneven_t*)arg;
+    for(uint32_t i = begin; i < end; i++) {
+        u->result[i] = series_leibniz_double(0.0, 0, i * 64);
+    }
+}
+
+static void test_uneven_static(void* arg, uint32_t worker, uint32_t workers) {
+    test_uneven_range(arg, worker * TEST_UNEVEN_ITEMS / workers, (worker + 1) * TEST_UNEVEN_ITEMS / workers);
+}
+
+// The static split and the work stealing executor fill in every item like one thread does
+static int test_executor(void) {
+    testUneven_t* reference = malloc(sizeof(testUneven_t));
+    testUneven_t* u = malloc(sizeof(testUneven_t));
+    if(reference == NULL || u == NULL) {
+        abort();
+    }
+    int result = 0;
+    test_uneven_range(reference, 0, TEST_UNEVEN_ITEMS);
+    for(uint32_t workers = 1; workers <= 4; workers *= 2) {
+        memset(u, 0, sizeof(testUneven_t));
+        picalc_parallel_run(test_uneven_static, u, workers);
+        if(memcmp(u, reference, sizeof(testUneven_t)) != 0) {
+            fprintf(stderr, "executor: static split on %u workers differs\n", (unsigned)workers);
+            result = 1;
+        }
+        executor_t* ex = malloc(sizeof(executor_t));
+        if(ex == NULL) {
+            abort();
+        }
+        executor_init(ex, workers, 1);
+        memset(u, 0, sizeof(testUneven_t));
+        executor_parallel_for(ex, 0, TEST_UNEVEN_ITEMS, 16, test_uneven_range, u);
+        if(memcmp(u, reference, sizeof(testUneven_t)) != 0) {
+            fprintf(stderr, "executor: work stealing on %u workers differs\n", (unsigned)workers);
+            result = 1;
+        }
+        executor_shutdown(ex);
+        free(ex);
+    }
+    free(reference);
+    free(u);
+    return result;
+}
+
+// Every registered engine stays within its error bound and resets, Monte-Carlo's bound is a
+// confidence interval and is left out
+static int test_race(void) {
+    piAlgoConfig_t config = {SERIES_FORMAT_FF, SERIES_SUM_NEUMAIER, SERIES_ACCEL_NONE, 1, SERIES_SPLIT_BLOCKED, NULL, 1, 0};
+    int result = 0;
+    for(uint32_t id = 0; id < PI_ALGO_COUNT; id++) {
+        const piAlgo_t* algo = &piAlgos[id];
+        void* state = algo_create(algo, &config);
+        uint32_t batch = 1;
+        for(uint32_t step = 0; step < 16; step++) {
+            algo->step(state, batch);
+            batch *= 2;
+        }
+        double bound = algo->error_bound(state);
+        if(id != PI_ALGO_MONTE_CARLO && fabs(algo->estimate(state) - M_PI) > bound) {
+            fprintf(stderr, "race: %s is outside its error bound\n", algo->name);
+            result = 1;
+        }
+        algo->reset(state);
+        if(algo->count(state) != 0 || algo->error_bound(state) < bound) {
+            fprintf(stderr, "race: %s did not reset\n", algo->name);
+            result = 1;
+        }
+        free(state);
+    }
+    return result;
+}
+
+// The interval of every engine and mode holds pi after every step and proves no more digits than
+// the estimate has. Monte-Carlo is left out, its interval is a confidence interval.
+static int test_certify(void) {
+    const uint64_t maxCount = 1000000;
+    static const struct {
+        piAlgoId_t id;
+        seriesFormat_t format;
+        seriesAccel_t accel;
+        uint32_t digitTarget;       // adaptive only, where it widens along the run
+    } modes[] = {
+        {PI_ALGO_LEIBNIZ, SERIES_FORMAT_DOUBLE, SERIES_ACCEL_NONE, 0},
+        {PI_ALGO_LEIBNIZ, SERIES_FORMAT_FLOAT, SERIES_ACCEL_NONE, 0},
+        {PI_ALGO_LEIBNIZ, SERIES_FORMAT_FF, SERIES_ACCEL_NONE, 0},
+        {PI_ALGO_LEIBNIZ, SERIES_FORMAT_FIXED, SERIES_ACCEL_NONE, 0},
+        {PI_ALGO_LEIBNIZ, SERIES_FORMAT_FF, SERIES_ACCEL_EULER, 0},
+        {PI_ALGO_LEIBNIZ, SERIES_FORMAT_FIXED, SERIES_ACCEL_EULER, 0},
+        {PI_ALGO_LEIBNIZ, SERIES_FORMAT_FF, SERIES_ACCEL_WYNN, 0},
+        {PI_ALGO_LEIBNIZ, SERIES_FORMAT_ADAPTIVE, SERIES_ACCEL_NONE, 3},
+        {PI_ALGO_LEIBNIZ, SERIES_FORMAT_ADAPTIVE, SERIES_ACCEL_NONE, 8},
+        {PI_ALGO_LEIBNIZ, SERIES_FORMAT_ADAPTIVE, SERIES_ACCEL_EULER, 12},
+        {PI_ALGO_BASEL, SERIES_FORMAT_DOUBLE, SERIES_ACCEL_NONE, 0},
+        {PI_ALGO_BASEL, SERIES_FORMAT_FLOAT, SERIES_ACCEL_NONE, 0},
+        {PI_ALGO_BASEL, SERIES_FORMAT_FIXED, SERIES_ACCEL_NONE, 0},
+        {PI_ALGO_BASEL, SERIES_FORMAT_FF, SERIES_ACCEL_EULER_MACLAURIN, 0},
+        {PI_ALGO_BASEL, SERIES_FORMAT_ADAPTIVE, SERIES_ACCEL_NONE, 3},
+        {PI_ALGO_BASEL, SERIES_FORMAT_ADAPTIVE, SERIES_ACCEL_EULER_MACLAURIN, 10},
+        {PI_ALGO_NILAKANTHA, SERIES_FORMAT_DOUBLE, SERIES_ACCEL_NONE, 0},
+        {PI_ALGO_WALLIS, SERIES_FORMAT_DOUBLE, SERIES_ACCEL_NONE, 0},
+        {PI_ALGO_VIETE, SERIES_FORMAT_DOUBLE, SERIES_ACCEL_NONE, 0},
+        {PI_ALGO_RAMANUJAN, SERIES_FORMAT_DOUBLE, SERIES_ACCEL_NONE, 0},
+    };
+    int result = 0;
+    for(size_t m = 0; m < sizeof(modes) / sizeof(modes[0]); m++) {
+        const piAlgo_t* algo = &piAlgos[modes[m].id];
+        piAlgoConfig_t config = {modes[m].format, SERIES_SUM_NEUMAIER, modes[m].accel, 1, SERIES_SPLIT_BLOCKED, NULL, 1,
+                                 modes[m].digitTarget};
+        void* state = algo_create(algo, &config);
+        // the batches grow 2x per step up to ALGO_MAX_BATCH, the engines with a cap stop counting
+        uint32_t batch = 1;
+        uint64_t last = UINT64_MAX;
+        while(algo->count(state) < maxCount && algo->count(state) != last) {
+            last = algo->count(state);
+            algo->step(state, batch);
+            batch = (batch < ALGO_MAX_BATCH) ? batch * 2 : ALGO_MAX_BATCH;
+
+            uint64_t lo, hi;
+            algo_interval(algo, state, &lo, &hi);
+            if(lo > PI_Q62 || hi <= PI_Q62) {
+                fprintf(stderr, "certify: %s %s %s interval does not hold pi at %llu\n", algo->name,
+                        series_format_name(modes[m].format), accel_mode_name(modes[m].accel),
+                        (unsigned long long)algo->count(state));
+                result = 1;
+                break;
+            }
+        }
+        free(state);
+    }
+    return result;
+}
+
+// Adaptive reaches every digit target one of the fixed formats reaches
+static int test_adaptive(void) {
+    const uint32_t maxDigits = 8;
+    const uint64_t maxCount = 2000000;
+    static const struct {
+        piAlgoId_t id;
+        seriesAccel_t accel;
+    } engines[] = {
+        {PI_ALGO_LEIBNIZ, SERIES_ACCEL_NONE},
+        {PI_ALGO_LEIBNIZ, SERIES_ACCEL_EULER},
+        {PI_ALGO_BASEL, SERIES_ACCEL_NONE},
+        {PI_ALGO_BASEL, SERIES_ACCEL_EULER_MACLAURIN},
+    };
+    static const seriesFormat_t formats[] = {SERIES_FORMAT_FLOAT, SERIES_FORMAT_FF, SERIES_FORMAT_FIXED, SERIES_FORMAT_ADAPTIVE};
+    int result = 0;
+    for(size_t e = 0; e < sizeof(engines) / sizeof(engines[0]); e++) {
+        const piAlgo_t* algo = &piAlgos[engines[e].id];
+        bool any = true;
+        for(uint32_t digits = 1; digits <= maxDigits && any; digits++) {
+            bool fixed = false;
+            bool adaptive = false;
+            for(size_t f = 0; f < sizeof(formats) / sizeof(formats[0]); f++) {
+                piAlgoConfig_t config = {formats[f], SERIES_SUM_NEUMAIER, engines[e].accel, 1, SERIES_SPLIT_BLOCKED, NULL, 1,
+                                         digits};
+                void* state = algo_create(algo, &config);
+                uint32_t batch = 1;
+                bool reached = false;
+                while(algo->count(state) < maxCount && !reached) {
+                    algo->step(state, batch);
+                    batch = (batch < ALGO_MAX_BATCH) ? batch * 2 : ALGO_MAX_BATCH;
+                    reached = algo_digits(algo, state) >= digits;
+                }
+                free(state);
+                if(formats[f] == SERIES_FORMAT_ADAPTIVE) {
+                    adaptive = reached;
+                } else {
+                    fixed = fixed || reached;
+                }
+            }
+            any = fixed || adaptive;
+            if(fixed && !adaptive) {
+                fprintf(stderr, "adaptive: %s %s misses %u digits\n", algo->name, accel_mode_name(engines[e].accel),
+                        (unsigned)digits);
+                result = 1;
+            }
+        }
+    }
+    return result;
+}
+
+// Steps with batches doubling from 1 until the engine reaches digits, from wherever it stands
+static void test_step_to(const piAlgo_t* algo, void* state, uint32_t* batch, uint32_t digits, uint64_t maxCount) {
+    while(algo_digits(algo, state) < digits && algo->count(state) < maxCount) {
+        algo->step(state, *batch);
+        *batch = (*batch < ALGO_MAX_BATCH) ? *batch * 2 : ALGO_MAX_BATCH;
+    }
+}
+
+// Raising the target after a finished run: the run goes on from a snapshot restored into a new
+// state and ends on the same bits as the run that was never stopped. Then the same through the
+// race: snapshot, reset, restore, start at the next target.
+static int test_resume(void) {
+    const uint32_t digits = 4;
+    const uint64_t maxCount = 2000000;
+    int result = 0;
+    for(uint32_t id = 0; id < PI_ALGO_COUNT; id++) {
+        const piAlgo_t* algo = &piAlgos[id];
+        piAlgoConfig_t config = {SERIES_FORMAT_ADAPTIVE, SERIES_SUM_NEUMAIER, SERIES_ACCEL_NONE, 1, SERIES_SPLIT_BLOCKED, NULL, 1,
+                                 digits};
+        void* kept = algo_create(algo, &config);
+        void* restored = algo_create(algo, &config);
+        uint32_t batch = 1;
+        test_step_to(algo, kept, &batch, digits, maxCount);
+        uint64_t first = algo->count(kept);
+        algoSnapshot_t snapshot;
+        algo_snapshot(algo, kept, &snapshot);
+        if(!algo_restore(algo, restored, &snapshot) || algo->count(restored) != first) {
+            fprintf(stderr, "resume: %s did not restore\n", algo->name);
+            result = 1;
+        }
+        uint32_t restoredBatch = batch;
+        test_step_to(algo, kept, &batch, digits + 1, maxCount);
+        test_step_to(algo, restored, &restoredBatch, digits + 1, maxCount);
+        double keptValue = algo->estimate(kept);
+        double restoredValue = algo->estimate(restored);
+        if(algo->count(kept) != algo->count(restored) || memcmp(&keptValue, &restoredValue, sizeof(double)) != 0) {
+            fprintf(stderr, "resume: %s went on to different bits\n", algo->name);
+            result = 1;
+        }
+        free(kept);
+        free(restored);
+    }
+
+    static race_t race;
+    uint32_t mask = PI_ALGO_MASK(PI_ALGO_LEIBNIZ) | PI_ALGO_MASK(PI_ALGO_BASEL) | PI_ALGO_MASK(PI_ALGO_NILAKANTHA);
+    piAlgoConfig_t config = {SERIES_FORMAT_ADAPTIVE, SERIES_SUM_NEUMAIER, SERIES_ACCEL_NONE, 1, SERIES_SPLIT_BLOCKED, NULL, 1, 0};
+    race_init(&race, &config, 1000, 100000);
+    race_start_workers(&race, 1, 3 * 2048);
+    for(uint32_t target = digits; target <= digits + 1; target++) {
+        // engines that are past the target already do not start
+        uint32_t pending = 0;
+        for(uint32_t id = 0; id < PI_ALGO_COUNT; id++) {
+            if((mask & PI_ALGO_MASK(id)) && race.engines[id].digits < target) {
+                pending |= PI_ALGO_MASK(id);
+            }
+        }
+        race_start(&race, mask, target);
+        int64_t end = picalc_time_us() + 60000000;
+        while(pending != 0 && picalc_time_us() < end) {
+            vTaskDelay(1);
+            for(uint32_t id = 0; id < PI_ALGO_COUNT; id++) {
+                if((pending & PI_ALGO_MASK(id)) && race_update(&race, (piAlgoId_t)id, target)) {
+                    pending &= ~PI_ALGO_MASK(id);
+                }
+            }
+        }
+        if(pending != 0) {
+            fprintf(stderr, "resume: the race did not reach %u digits\n", (unsigned)target);
+            return 1;
+        }
+        if(target > digits) {
+            break;
+        }
+        // throw the states away and bring the runs back from their snapshots, they publish
+        // what they published before
+        static raceSnapshot_t snapshots[PI_ALGO_COUNT];
+        static piResult_t before[PI_ALGO_COUNT];
+        for(uint32_t id = 0; id < PI_ALGO_COUNT; id++) {
+            if(!(mask & PI_ALGO_MASK(id))) {
+                continue;
+            }
+            race_snapshot(&race, (piAlgoId_t)id, &snapshots[id]);
+            race_update(&race, (piAlgoId_t)id, target);
+            before[id] = race.engines[id].result;
+        }
+        race_reset(&race);
+        for(uint32_t id = 0; id < PI_ALGO_COUNT; id++) {
+            if(!(mask & PI_ALGO_MASK(id))) {
+                continue;
+            }
+            raceEngine_t* engine = &race.engines[id];
+            bool restored = race_restore(&race, (piAlgoId_t)id, &snapshots[id]);
+            race_update(&race, (piAlgoId_t)id, target);
+            if(!restored || engine->result.iterations != before[id].iterations ||
+               memcmp(&engine->result.piValue, &before[id].piValue, sizeof(double)) != 0 ||
+               engine->result.elapsedUs != before[id].elapsedUs) {
+                fprintf(stderr, "resume: %s did not restore in the race\n", engine->algo->name);
+                result = 1;
+            }
+        }
+    }
+    race_reset(&race);
+    return result;
+}
+
+// NOR flash in memory for the checkpoints: programs only clear bits and stay within a page, an
+// erase sets a sector. The operation numbered tearAt is cut short like by a reset, it and every
+// operation after it fail until the next boot.
+#define TEST_FLASH_PAGE     256
+#define TEST_FLASH_SECTOR   4096
+
+typedef struct {
+    uint8_t memory[CHECKPOINT_SECTORS * TEST_FLASH_SECTOR];
+    uint32_t operations;
+    uint32_t tearAt;                // 0 for never
+    bool lost;
+} testFlash_t;
+
+static bool test_flash_cut(testFlash_t* flash) {
+    flash->operations++;
+    if(flash->tearAt != 0 && flash->operations >= flash->tearAt) {
+        bool torn = !flash->lost;
+        flash->lost = true;
+        return torn;
+    }
+    return false;
+}
+
+static bool test_flash_read(void* context, uint32_t address, void* data, uint32_t size) {
+    testFlash_t* flash = context;
+    if(flash->lost) {
+        return false;
+    }
+    memcpy(data, &flash->memory[address], size);
+    return true;
+}
+
+static bool test_flash_prog(void* context, uint32_t address, const void* data, uint32_t size) {
+    testFlash_t* flash = context;
+    if(address / TEST_FLASH_PAGE != (address + size - 1) / TEST_FLASH_PAGE) {
+        fprintf(stderr, "checkpoint: program across a page at 0x%x\n", (unsigned)address);
+        abort();
+    }
+    if(flash->lost) {
+        return false;
+    }
+    // a torn program gets the first half of its bytes in
+    uint32_t length = test_flash_cut(flash) ? size / 2 : size;
+    for(uint32_t i = 0; i < length; i++) {
+        flash->memory[address + i] &= ((const uint8_t*)data)[i];
+    }
+    return !flash->lost;
+}
+
+static bool test_flash_erase(void* context, uint32_t address) {
+    testFlash_t* flash = context;
+    if(flash->lost) {
+        return false;
+    }
+    uint32_t length = test_flash_cut(flash) ? TEST_FLASH_SECTOR / 2 : TEST_FLASH_SECTOR;
+    memset(&flash->memory[address - address % TEST_FLASH_SECTOR], 0xFF, length);
+    return !flash->lost;
+}
+
+static bool test_snapshot_same(const raceSnapshot_t* a, const raceSnapshot_t* b) {
+    return a->state.id == b->state.id && a->state.size == b->state.size &&
+           memcmp(a->state.data, b->state.data, a->state.size) == 0 && a->batch == b->batch &&
+           a->elapsedUs == b->elapsedUs && a->cpuUs == b->cpuUs && a->cycles == b->cycles;
+}
+
+// Checkpoints through the writer task while the race runs, a reboot restores the runs where they
+// stopped. Then saves with a reset at every point of a write (torn programs and erases) across
+// several sector swaps: after every reboot each engine holds its last complete record. A flipped
+// bit in the newest record falls back to the one before.
+static int test_checkpoint(void) {
+    const uint32_t saves = 300;
+    int result = 0;
+    static testFlash_t flash;
+    memset(flash.memory, 0xFF, sizeof(flash.memory));
+    checkpointFlash_t port = {&flash, test_flash_read, test_flash_prog, test_flash_erase,
+                              TEST_FLASH_PAGE, TEST_FLASH_SECTOR, 0, sizeof(flash.memory)};
+    uint32_t mask = PI_ALGO_MASK(PI_ALGO_LEIBNIZ) | PI_ALGO_MASK(PI_ALGO_BASEL) | PI_ALGO_MASK(PI_ALGO_NILAKANTHA) |
+                    PI_ALGO_MASK(PI_ALGO_MONTE_CARLO);
+    piAlgoConfig_t config = {SERIES_FORMAT_ADAPTIVE, SERIES_SUM_NEUMAIER, SERIES_ACCEL_NONE, 1, SERIES_SPLIT_BLOCKED, NULL, 1, 0};
+
+    static race_t race;
+    static checkpoint_t checkpoint;
+    race_init(&race, &config, 1000, 100000);
+    race_start_workers(&race, 1, 3 * 2048);
+    if(!checkpoint_init(&checkpoint, &port, &race)) {
+        fprintf(stderr, "checkpoint: the region does not fit\n");
+        return 1;
+    }
+    checkpoint_start_writer(&checkpoint, 20, 1, 3 * 2048, 0);
+    race_start(&race, mask, ALGO_MAX_DIGITS);
+    vTaskDelay(pdMS_TO_TICKS(500));
+    for(uint32_t id = 0; id < PI_ALGO_COUNT; id++) {
+        race.engines[id].running = false;
+    }
+    // the last step ends and the writer catches up
+    vTaskDelay(pdMS_TO_TICKS(200));
+    if(checkpoint.stats.records == 0 || checkpoint.stats.errors != 0) {
+        fprintf(stderr, "checkpoint: the writer saved %u records with %u errors\n", (unsigned)checkpoint.stats.records,
+                (unsigned)checkpoint.stats.errors);
+        result = 1;
+    }
+
+    static race_t rebooted;
+    static checkpoint_t reboot;
+    race_init(&rebooted, &config, 1000, 100000);
+    checkpoint_init(&reboot, &port, &rebooted);
+    uint32_t restored = checkpoint_restore(&reboot);
+    for(uint32_t id = 0; id < PI_ALGO_COUNT; id++) {
+        raceSnapshot_t kept, back;
+        race_snapshot(&race, (piAlgoId_t)id, &kept);
+        race_snapshot(&rebooted, (piAlgoId_t)id, &back);
+        if(!test_snapshot_same(&kept, &back) || ((mask & PI_ALGO_MASK(id)) != 0) != ((restored & PI_ALGO_MASK(id)) != 0)) {
+            fprintf(stderr, "checkpoint: %s did not come back after the reboot\n", piAlgos[id].name);
+            result = 1;
+        }
+    }
+
+    // the engines of this race are stepped here, it has no workers. The writer above goes on but
+    // has nothing to write, its engines stopped.
+    static race_t torn;
+    static checkpoint_t saver;
+    static raceSnapshot_t expected[PI_ALGO_COUNT];
+    race_init(&torn, &config, 1000, 100000);
+    memset(flash.memory, 0xFF, sizeof(flash.memory));
+    checkpoint_init(&saver, &port, &torn);
+    for(uint32_t id = 0; id < PI_ALGO_COUNT; id++) {
+        race_snapshot(&torn, (piAlgoId_t)id, &expected[id]);
+    }
+    for(uint32_t i = 0; i < saves; i++) {
+        piAlgoId_t id = (piAlgoId_t)(i % PI_ALGO_COUNT);
+        raceEngine_t* engine = &torn.engines[id];
+        engine->algo->step(engine->state, engine->algo->batch);
+        engine->elapsedUs += 1000;
+        // a reset at the first, second or third flash operation of the save, every fourth one completes
+        flash.operations = 0;
+        flash.tearAt = (i % 4 == 3) ? 0 : 1 + (i / 4) % 3;
+        bool saved = checkpoint_save(&saver, id);
+        if(saved) {
+            race_snapshot(&torn, id, &expected[id]);
+        }
+        flash.lost = false;
+        flash.tearAt = 0;
+
+        race_init(&rebooted, &config, 1000, 100000);
+        checkpoint_init(&reboot, &port, &rebooted);
+        checkpoint_restore(&reboot);
+        for(uint32_t check = 0; check < PI_ALGO_COUNT; check++) {
+            raceSnapshot_t back;
+            race_snapshot(&rebooted, (piAlgoId_t)check, &back);
+            if(!test_snapshot_same(&back, &expected[check])) {
+                fprintf(stderr, "checkpoint: save %u, %s lost its last complete record\n", (unsigned)i, piAlgos[check].name);
+                result = 1;
+            }
+        }
+        for(uint32_t freeId = 0; freeId < PI_ALGO_COUNT; freeId++) {
+            free(rebooted.engines[freeId].state);
+        }
+        // the writer boots again on what the flash holds now
+        checkpoint_init(&saver, &port, &torn);
+    }
+
+    // a flipped bit in the newest record of Nilakantha, the one before counts
+    checkpointEngine_t* nilakantha = &saver.engines[PI_ALGO_NILAKANTHA];
+    uint32_t sequence = nilakantha->sequence;
+    uint32_t sector = 2 * PI_ALGO_NILAKANTHA + nilakantha->newest / nilakantha->slots;
+    flash.memory[sector * TEST_FLASH_SECTOR + (nilakantha->newest % nilakantha->slots) * nilakantha->slotSize +
+                 sizeof(checkpointHeader_t)] ^= 0x01;
+    race_init(&rebooted, &config, 1000, 100000);
+    checkpoint_init(&reboot, &port, &rebooted);
+    if(sequence < 2 || reboot.engines[PI_ALGO_NILAKANTHA].sequence != sequence - 1) {
+        fprintf(stderr, "checkpoint: the corrupt record was not passed over\n");
+        result = 1;
+    }
+
+    // records of another version or engine layout with a valid CRC, as an older build left them
+    const piAlgoId_t stale[2] = {PI_ALGO_BASEL, PI_ALGO_LEIBNIZ};
+    for(uint32_t i = 0; i < 2; i++) {
+        checkpointEngine_t* engine = &saver.engines[stale[i]];
+        uint32_t staleSequence = engine->sequence;
+        uint8_t* record = &flash.memory[(2 * stale[i] + engine->newest / engine->slots) * TEST_FLASH_SECTOR +
+                                        (engine->newest % engine->slots) * engine->slotSize];
+        checkpointHeader_t header;
+        memcpy(&header, record, sizeof(header));
+        if(i == 0) {
+            header.version = CHECKPOINT_VERSION + 1;
+        } else {
+            header.layout ^= 0x01;
+        }
+        memcpy(record, &header, sizeof(header));
+        header.crc = checkpoint_crc32(0, &record[offsetof(checkpointHeader_t, version)],
+                                      header.size - offsetof(checkpointHeader_t, version));
+        memcpy(&record[offsetof(checkpointHeader_t, crc)], &header.crc, sizeof(header.crc));
+        race_init(&rebooted, &config, 1000, 100000);
+        checkpoint_init(&reboot, &port, &rebooted);
+        if(staleSequence < 2 || reboot.engines[stale[i]].sequence != staleSequence - 1) {
+            fprintf(stderr, "checkpoint: the %s record of %s was not passed over\n", i == 0 ? "stale version" : "stale layout",
+                    piAlgos[stale[i]].name);
+            result = 1;
+        }
+    }
+    return result;
+}
+
+// Interval, digits and sample bookkeeping of the Monte-Carlo estimate
+static int test_montecarlo(void) {
+    montecarlo_t* mc = malloc(sizeof(montecarlo_t));
+    montecarlo_t* again = malloc(sizeof(montecarlo_t));
+    if(mc == NULL || again == NULL) {
+        abort();
+    }
+    int result = 0;
+
+    montecarlo_init(mc, 777, 1);
+    if(montecarlo_probable_digits(mc) != 0 || isfinite(montecarlo_half_width(mc))) {
+        fprintf(stderr, "montecarlo: digits without samples\n");
+        result = 1;
+    }
+    montecarlo_sample(mc, 1);
+    if(montecarlo_probable_digits(mc) != 0 || montecarlo_half_width(mc) < 1.0) {
+        fprintf(stderr, "montecarlo: one sample gave %u digits\n", (unsigned)montecarlo_probable_digits(mc));
+        result = 1;
+    }
+    // runs that always or never hit, from a handful of samples to far past MONTECARLO_MIN_SAMPLES
+    for(uint64_t samples = 1; samples <= 1000000000000ull; samples *= 10) {
+        for(uint32_t allHit = 0; allHit < 2; allHit++) {
+            montecarlo_init(mc, 777, 1);
+            mc->lane[0].samples = samples;
+            mc->lane[0].hits = allHit ? samples : 0;
+            if(montecarlo_probable_digits(mc) != 0) {
+                fprintf(stderr, "montecarlo: %llu samples, %s hit, gave %u digits\n", (unsigned long long)samples,
+                        allHit ? "all" : "none", (unsigned)montecarlo_probable_digits(mc));
+                result = 1;
+            }
+        }
+    }
+
+    // the interval holds pi and the lanes lose no samples, on one lane and on several
+    for(uint32_t lanes = 1; lanes <= 4; lanes *= 2) {
+        const uint32_t samples = 4000000;
+        montecarlo_init(mc, 12345, lanes);
+        montecarlo_sample_parallel(mc, samples, NULL);
+        double lo, hi;
+        montecarlo_interval(mc, &lo, &hi);
+        if(montecarlo_samples(mc) != samples) {
+            fprintf(stderr, "montecarlo: %u lanes lost samples\n", (unsigned)lanes);
+            result = 1;
+        }
+        if(!(lo < M_PI && M_PI < hi)) {
+            fprintf(stderr, "montecarlo: %u lanes, pi is outside [%.6f, %.6f]\n", (unsigned)lanes, lo, hi);
+            result = 1;
+        }
+    }
+
+    // the same seed gives the same samples, however they are batched
+    montecarlo_init(mc, 777, 1);
+    montecarlo_init(again, 777, 1);
+    montecarlo_sample(mc, 100000);
+    for(uint32_t i = 0; i < 100; i++) {
+        montecarlo_sample(again, 1000);
+    }
+    if(montecarlo_hits(mc) != montecarlo_hits(again)) {
+        fprintf(stderr, "montecarlo: batching changed the samples\n");
+        result = 1;
+    }
+    free(again);
+    free(mc);
+    return result;
+}
+
+typedef struct {
+    const char* name;
+    int (*run)(void);
+} testEntry_t;
+
+static const testEntry_t tests[] = {
+    {"bigint", test_bigint},
+    {"digits", test_digits},
+    {"ff", test_ff},
+    {"simd", test_simd},
+    {"fixed", test_fixed},
+    {"wide", test_wide},
+    {"parallel", test_parallel},
+    {"executor", test_executor},
+    {"race", test_race},
+    {"certify", test_certify},
+    {"adaptive", test_adaptive},
+    {"resume", test_resume},
+    {"checkpoint", test_checkpoint},
+    {"montecarlo", test_montecarlo},
+};
+
+int main(int argc, char** argv) {
+    size_t count = sizeof(tests) / sizeof(tests[0]);
+    int result = 0;
+    if(argc < 2) {
+        for(size_t i = 0; i < count; i++) {
+            int failed = tests[i].run();
+            printf("%-12s %s\n", tests[i].name, failed ? "FAILED" : "ok");
+            result |= failed;
+        }
+        return result;
+    }
+    for(int arg = 1; arg < argc; arg++) {
+        size_t i = 0;
+        while(i < count && strcmp(argv[arg], tests[i].name) != 0) {
+            i++;
+        }
+        if(i == count) {
+            fprintf(stderr, "Usage: %s [test...]\n", argv[0]);
+            for(i = 0; i < count; i++) {
+                fprintf(stderr, "    %s\n", tests[i].name);
+            }
+            return 1;
+        }
+        int failed = tests[i].run();
+        printf("%-12s %s\n", tests[i].name, failed ? "FAILED" : "ok");
+        result |= failed;
+    }
+    return result;
+}
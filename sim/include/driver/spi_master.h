@@ -0,0 +1,72 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <assert.h>
+
+#include "esp_err.h"
+#include "esp_attr.h"
+#include "freertos/FreeRTOS.h"
+
+// SPI master of the simulated board. A transaction goes to the device model attached to the
+// chip select of the device (sim_spi_attach) and is counted in the bus statistics.
+typedef enum {
+    SPI1_HOST,
+    SPI2_HOST,
+    SPI3_HOST,
+} spi_host_device_t;
+
+#define SPI_DMA_DISABLED    0
+#define SPI_DMA_CH_AUTO     3
+
+#define SPI_MASTER_FREQ_8M      (80 * 1000 * 1000 / 10)
+#define SPI_MASTER_FREQ_10M     (80 * 1000 * 1000 / 8)
+#define SPI_MASTER_FREQ_20M     (80 * 1000 * 1000 / 4)
+#define SPI_MASTER_FREQ_26M     (80 * 1000 * 1000 / 3)
+#define SPI_MASTER_FREQ_40M     (80 * 1000 * 1000 / 2)
+#define SPI_MASTER_FREQ_80M     (80 * 1000 * 1000 / 1)
+
+#define SPI_DEVICE_HALFDUPLEX   (1 << 4)
+
+typedef struct {
+    int mosi_io_num;
+    int miso_io_num;
+    int sclk_io_num;
+    int quadwp_io_num;
+    int quadhd_io_num;
+    int max_transfer_sz;
+    uint32_t flags;
+} spi_bus_config_t;
+
+typedef struct {
+    uint8_t command_bits;
+    uint8_t address_bits;
+    uint8_t dummy_bits;
+    uint8_t mode;
+    int clock_speed_hz;
+    int spics_io_num;
+    uint32_t flags;
+    int queue_size;
+} spi_device_interface_config_t;
+
+typedef struct {
+    uint32_t flags;
+    uint16_t cmd;
+    uint64_t addr;
+    size_t length;              // bits
+    size_t rxlength;            // bits
+    void* user;
+    const void* tx_buffer;
+    void* rx_buffer;
+} spi_transaction_t;
+
+typedef struct simSpiDevice* spi_device_handle_t;
+
+esp_err_t spi_bus_initialize(spi_host_device_t host, const spi_bus_config_t* config, int dmaChannel);
+esp_err_t spi_bus_add_device(spi_host_device_t host, const spi_device_interface_config_t* config,
+                             spi_device_handle_t* handle);
+esp_err_t spi_device_transmit(spi_device_handle_t handle, spi_transaction_t* trans);
+esp_err_t spi_device_polling_transmit(spi_device_handle_t handle, spi_transaction_t* trans);
+esp_err_t spi_device_acquire_bus(spi_device_handle_t handle, TickType_t ticks);
+void spi_device_release_bus(spi_device_handle_t handle);
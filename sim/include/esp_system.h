@@ -0,0 +1,8 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "esp_err.h"
+#include "esp_attr.h"
+
+void esp_restart(void);
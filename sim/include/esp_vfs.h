@@ -0,0 +1,9 @@
+#pragma once
+
+#include <stdio.h>
+
+// The simulator mounts a host directory at the base path of a partition. Paths below a mount
+// point are resolved by sim_vfs_fopen, which every file that includes this header gets for fopen.
+FILE* sim_vfs_fopen(const char* path, const char* mode);
+
+#define fopen(path, mode)   sim_vfs_fopen(path, mode)
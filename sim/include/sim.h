@@ -0,0 +1,93 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+// Board simulator: the unmodified app (src/main.c) with the real LCD, button and rotary encoder
+// drivers of components/eduboard2 on top of in-memory devices. The FreeRTOS calls go to the
+// pthread shim of components/picalc/host, the ESP-IDF calls to the stubs in sim/include.
+
+// Microseconds since the simulator started, the time base of the script
+int64_t sim_time_us(void);
+
+// GPIO: levels of the outputs as the drivers set them, inputs as the script drives them
+void sim_gpio_drive(int gpio, int level);
+int sim_gpio_level(int gpio);
+
+// SPI: every transaction goes to the model attached to the chip select of its device. A full
+// duplex model also answers: reply gets length bytes while data is clocked out, it may be data
+// and is NULL for a write-only transaction.
+typedef void (*simSpiReceive_t)(const uint8_t* data, size_t length);
+typedef void (*simSpiExchange_t)(const uint8_t* data, uint8_t* reply, size_t length);
+
+typedef struct {
+    uint64_t transactions;
+    uint64_t bytes;
+    int64_t wireNs;                 // time on the wire at the device clock, without gaps
+} simSpiStats_t;
+
+void sim_spi_attach(int csGpio, simSpiReceive_t receive);
+void sim_spi_attach_duplex(int csGpio, simSpiExchange_t exchange);
+// true holds every transaction for its wire time, so frame times include the bus like on the board
+void sim_spi_set_realtime(bool realtime);
+void sim_spi_stats(simSpiStats_t* stats);
+
+// ILI9488 panel behind the LCD chip select: column/page address, memory write of RGB666 pixels,
+// display on/off and inversion. The other commands are counted and ignored.
+typedef struct {
+    uint64_t commands;
+    uint64_t pixels;
+} simPanelStats_t;
+
+void sim_panel_init(int dcGpio, uint16_t width, uint16_t height, uint16_t rotation);
+void sim_panel_receive(const uint8_t* data, size_t length);
+void sim_panel_stats(simPanelStats_t* stats);
+// FNV-1a of what the panel shows, tells whether a frame changed anything
+uint32_t sim_panel_checksum(void);
+// Binary PPM in the orientation the app draws in (rotation applied), false on a write error
+bool sim_panel_dump_ppm(const char* path);
+
+// W25Q32 behind the flash chip select with the commands of w25.c: JEDEC ID, status, write enable,
+// read, page program and sector erase. NOR like the chip, an erase sets a sector to 0xFF and a
+// program only clears bits and wraps within its page. Every transaction is one command.
+typedef struct {
+    uint64_t reads;
+    uint64_t pagePrograms;
+    uint64_t sectorErases;
+    uint64_t rejected;              // programs and erases without the write enable latch
+} simFlashStats_t;
+
+// The flash contents live in this file, written through on every program and erase, so a second
+// run boots on what the first one left. NULL (the default) keeps a blank flash in memory.
+void sim_flash_set_image(const char* path);
+// Loads the image, false if it cannot be opened or created
+bool sim_flash_init(void);
+void sim_flash_exchange(const uint8_t* data, uint8_t* reply, size_t length);
+void sim_flash_stats(simFlashStats_t* stats);
+
+// LED0..7 as bits, as the app last set them
+uint8_t sim_board_leds(void);
+
+// Host directory that esp_vfs_spiffs_register mounts
+void sim_vfs_set_root(const char* directory);
+
+// Log level of ESP_LOGx, ESP_LOG_INFO by default
+void sim_log_set_level(int level);
+
+// Frames: every lcdUpdateVScreen of the app is timed with the SPI traffic it caused
+typedef struct {
+    uint32_t frames;
+    uint32_t changed;               // frames that changed the panel
+    int64_t updateUsMin;
+    int64_t updateUsMax;
+    int64_t updateUsSum;
+    uint64_t bytesMax;              // SPI bytes of the busiest frame
+} simFrameStats_t;
+
+// Every frame that changes the panel goes to directory/frame_NNNNN.ppm, NULL for none
+void sim_frames_set_directory(const char* directory);
+// Latency of an input: from now to the end of the first frame that changes the panel
+void sim_frames_mark_input(const char* label);
+void sim_frames_stats(simFrameStats_t* stats);
+void sim_frames_print_latencies(void);
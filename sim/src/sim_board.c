@@ -0,0 +1,101 @@
+#include "eduboard2.h"
+#include "driver/gpio.h"
+#include "sim.h"
+
+#define TAG "Eduboard2_Sim"
+
+// The parts of the board support package that the simulator replaces: the init sequence, the LEDs
+// (RMT on the board) and eduboard_init_lcd (the boot logo needs the JPEG decoder in the ROM).
+// Buttons, rotary encoder, fonts, the LCD driver and the flash driver with littlefs are the ones
+// of components/eduboard2.
+
+static const uint8_t ledPins[] = {GPIO_LED_0, GPIO_LED_1, GPIO_LED_2, GPIO_LED_3, GPIO_LED_4, GPIO_LED_5, GPIO_LED_6, GPIO_LED_7};
+static SemaphoreHandle_t ledLock;
+static uint8_t ledValue = 0;
+
+static void sim_board_update_leds(void) {
+    for(int i = 0; i < 8; i++) {
+        gpio_set_level(ledPins[i], (ledValue >> i) & 0x01);
+    }
+}
+
+void led_set(uint8_t led_num, uint8_t level) {
+    xSemaphoreTake(ledLock, portMAX_DELAY);
+    if(level > 0) {
+        ledValue |= (0x01 << led_num);
+    } else {
+        ledValue &= ~(0x01 << led_num);
+    }
+    sim_board_update_leds();
+    xSemaphoreGive(ledLock);
+}
+
+void led_toggle(uint8_t led_num) {
+    xSemaphoreTake(ledLock, portMAX_DELAY);
+    ledValue ^= (0x01 << led_num);
+    sim_board_update_leds();
+    xSemaphoreGive(ledLock);
+}
+
+void led_setAll(uint8_t newLedValue) {
+    xSemaphoreTake(ledLock, portMAX_DELAY);
+    ledValue = newLedValue;
+    sim_board_update_leds();
+    xSemaphoreGive(ledLock);
+}
+
+void ws2812_set(uint8_t red, uint8_t green, uint8_t blue) {
+    (void)red;
+    (void)green;
+    (void)blue;
+}
+
+void eduboard_init_leds() {
+    ledLock = xSemaphoreCreateMutex();
+    led_setAll(0);
+}
+
+void eduboard_init_lcd() {
+    ESP_LOGI(TAG, "Init LCD...");
+    sim_panel_init(GPIO_LCD_DC, CONFIG_WIDTH, CONFIG_HEIGHT, SCREEN_ROTATION);
+    sim_spi_attach(GPIO_LCD_CS, sim_panel_receive);
+    lcd_init();
+    rotation_t screenRotation = rot_0;
+    #if SCREEN_ROTATION == 90
+    screenRotation = rot_90;
+    #elif SCREEN_ROTATION == 180
+    screenRotation = rot_180;
+    #elif SCREEN_ROTATION == 270
+    screenRotation = rot_270;
+    #endif
+    lcdSetupVScreen(screenRotation);
+    lcdBacklightOn();
+    lcdFillScreen(BLACK);
+    char version[20];
+    sprintf(version, "Eduboard V%.1f", (float)EDUBOARD2_HWVERSION);
+    lcdDrawString(fx24Comic, 55, 300, version, WHITE);
+    lcdUpdateVScreen();
+    ESP_LOGI(TAG, "Init LCD Done.");
+}
+
+void eduboard2_init() {
+    ESP_LOGI(TAG, "Init Eduboard2...");
+    eduboard_init_leds();
+    eduboard_init_buttons();
+    eduboard_init_rotary_encoder();
+    eduboard_init_spiffs();
+    #ifdef CONFIG_ENABLE_FLASH
+    if(!sim_flash_init()) {
+        ESP_LOGE(TAG, "Cannot open the flash image");
+        abort();
+    }
+    sim_spi_attach_duplex(GPIO_FLASH_DAC_CS, sim_flash_exchange);
+    eduboard_init_flash();
+    #endif
+    eduboard_init_lcd();
+    ESP_LOGI(TAG, "Init Eduboard2 done");
+}
+
+uint8_t sim_board_leds(void) {
+    return ledValue;
+}
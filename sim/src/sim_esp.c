@@ -0,0 +1,96 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <string.h>
+#include <limits.h>
+
+#include "esp_err.h"
+#include "esp_log.h"
+#include "esp_system.h"
+#include "esp_spiffs.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "sim.h"
+
+// the real one from here on
+#undef fopen
+
+static esp_log_level_t logLevel = ESP_LOG_INFO;
+static const char* vfsRoot = ".";
+static char vfsBase[32] = "";
+
+const char* esp_err_to_name(esp_err_t code) {
+    switch(code) {
+        case ESP_OK:                return "ESP_OK";
+        case ESP_FAIL:              return "ESP_FAIL";
+        case ESP_ERR_NO_MEM:        return "ESP_ERR_NO_MEM";
+        case ESP_ERR_INVALID_ARG:   return "ESP_ERR_INVALID_ARG";
+        case ESP_ERR_INVALID_STATE: return "ESP_ERR_INVALID_STATE";
+        case ESP_ERR_INVALID_SIZE:  return "ESP_ERR_INVALID_SIZE";
+        case ESP_ERR_NOT_FOUND:     return "ESP_ERR_NOT_FOUND";
+        case ESP_ERR_NOT_SUPPORTED: return "ESP_ERR_NOT_SUPPORTED";
+        case ESP_ERR_TIMEOUT:       return "ESP_ERR_TIMEOUT";
+        default:                    return "UNKNOWN ERROR";
+    }
+}
+
+void sim_log_set_level(int level) {
+    logLevel = (esp_log_level_t)level;
+}
+
+void esp_log_level_set(const char* tag, esp_log_level_t level) {
+    // one level for all tags
+    (void)tag;
+    logLevel = level;
+}
+
+void esp_log_write(esp_log_level_t level, const char* tag, const char* format, ...) {
+    static const char letters[] = "NEWIDV";
+    if(level > logLevel) {
+        return;
+    }
+    va_list args;
+    va_start(args, format);
+    flockfile(stdout);
+    printf("%c (%u) %s: ", letters[level], (unsigned)xTaskGetTickCount(), tag);
+    vprintf(format, args);
+    putchar('\n');
+    funlockfile(stdout);
+    va_end(args);
+}
+
+void esp_restart(void) {
+    fflush(stdout);
+    fprintf(stderr, "sim: esp_restart called\n");
+    exit(3);
+}
+
+void sim_vfs_set_root(const char* directory) {
+    vfsRoot = directory;
+}
+
+esp_err_t esp_vfs_spiffs_register(const esp_vfs_spiffs_conf_t* conf) {
+    if(strlen(conf->base_path) >= sizeof(vfsBase)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    strcpy(vfsBase, conf->base_path);
+    return ESP_OK;
+}
+
+esp_err_t esp_spiffs_info(const char* partition_label, size_t* total, size_t* used) {
+    // the size of the storage partition in partitions.csv
+    (void)partition_label;
+    *total = 0xF0000;
+    *used = 0;
+    return ESP_OK;
+}
+
+FILE* sim_vfs_fopen(const char* path, const char* mode) {
+    size_t baseLength = strlen(vfsBase);
+    if(baseLength > 0 && strncmp(path, vfsBase, baseLength) == 0 && path[baseLength] == '/') {
+        char hostPath[PATH_MAX];
+        snprintf(hostPath, sizeof(hostPath), "%s%s", vfsRoot, &path[baseLength]);
+        return fopen(hostPath, mode);
+    }
+    return fopen(path, mode);
+}
@@ -0,0 +1,139 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+
+#include "sim.h"
+
+#define W25_JEDEC_ID_COMMAND        0x9F
+#define W25_STATUS_COMMAND          0x05
+#define W25_WRITE_ENABLE            0x06
+#define W25_READ_DATA_COMMAND       0x03
+#define W25_PAGE_PROGRAM_COMMAND    0x02
+#define W25_SECTOR_ERASE_COMMAND    0x20
+
+#define W25_STATUS_WEL              0x02
+
+#define SIM_FLASH_BYTES     (4 * 1024 * 1024)
+#define SIM_FLASH_PAGE      256
+#define SIM_FLASH_SECTOR    4096
+
+// Winbond, SPI NOR, 32 Mbit
+static const uint8_t simFlashJedecId[3] = {0xEF, 0x40, 0x16};
+
+// Programs and erases finish within their transaction, the status never reads busy
+typedef struct {
+    pthread_mutex_t lock;
+    uint8_t* memory;
+    const char* imagePath;
+    FILE* image;
+    bool writeEnabled;
+    simFlashStats_t stats;
+} simFlash_t;
+
+static simFlash_t flash = {.lock = PTHREAD_MUTEX_INITIALIZER};
+
+void sim_flash_set_image(const char* path) {
+    flash.imagePath = path;
+}
+
+bool sim_flash_init(void) {
+    flash.memory = malloc(SIM_FLASH_BYTES);
+    if(flash.memory == NULL) {
+        abort();
+    }
+    memset(flash.memory, 0xFF, SIM_FLASH_BYTES);
+    if(flash.imagePath == NULL) {
+        return true;
+    }
+    flash.image = fopen(flash.imagePath, "r+b");
+    if(flash.image == NULL) {
+        flash.image = fopen(flash.imagePath, "w+b");
+    }
+    if(flash.image == NULL) {
+        return false;
+    }
+    // a new or short image is filled up with erased bytes
+    size_t loaded = fread(flash.memory, 1, SIM_FLASH_BYTES, flash.image);
+    if(loaded < SIM_FLASH_BYTES) {
+        fseek(flash.image, (long)loaded, SEEK_SET);
+        fwrite(&flash.memory[loaded], 1, SIM_FLASH_BYTES - loaded, flash.image);
+        fflush(flash.image);
+    }
+    return true;
+}
+
+static void sim_flash_write_through(uint32_t address, uint32_t size) {
+    if(flash.image != NULL) {
+        fseek(flash.image, (long)address, SEEK_SET);
+        fwrite(&flash.memory[address], 1, size, flash.image);
+        fflush(flash.image);
+    }
+}
+
+void sim_flash_exchange(const uint8_t* data, uint8_t* reply, size_t length) {
+    if(length == 0) {
+        return;
+    }
+    pthread_mutex_lock(&flash.lock);
+    uint8_t command = data[0];
+    uint32_t address = (length >= 4) ? ((uint32_t)data[1] << 16 | (uint32_t)data[2] << 8 | data[3]) % SIM_FLASH_BYTES : 0;
+    // what the command takes from data is used before reply overwrites it
+    switch(command) {
+        case W25_WRITE_ENABLE:
+            flash.writeEnabled = true;
+            break;
+        case W25_PAGE_PROGRAM_COMMAND: {
+            if(!flash.writeEnabled || length < 4) {
+                flash.stats.rejected++;
+                break;
+            }
+            uint32_t page = address - address % SIM_FLASH_PAGE;
+            for(size_t i = 4; i < length; i++) {
+                flash.memory[page + (address + i - 4) % SIM_FLASH_PAGE] &= data[i];
+            }
+            sim_flash_write_through(page, SIM_FLASH_PAGE);
+            flash.writeEnabled = false;
+            flash.stats.pagePrograms++;
+            break;
+        }
+        case W25_SECTOR_ERASE_COMMAND: {
+            if(!flash.writeEnabled || length < 4) {
+                flash.stats.rejected++;
+                break;
+            }
+            uint32_t sector = address - address % SIM_FLASH_SECTOR;
+            memset(&flash.memory[sector], 0xFF, SIM_FLASH_SECTOR);
+            sim_flash_write_through(sector, SIM_FLASH_SECTOR);
+            flash.writeEnabled = false;
+            flash.stats.sectorErases++;
+            break;
+        }
+        case W25_READ_DATA_COMMAND:
+            flash.stats.reads++;
+            break;
+        default:
+            break;
+    }
+    if(reply != NULL) {
+        // MISO idles high while the command goes out
+        for(size_t i = 0; i < length; i++) {
+            uint8_t out = 0xFF;
+            if(command == W25_JEDEC_ID_COMMAND && i >= 1 && i <= 3) {
+                out = simFlashJedecId[i - 1];
+            } else if(command == W25_STATUS_COMMAND && i >= 1) {
+                out = flash.writeEnabled ? W25_STATUS_WEL : 0x00;
+            } else if(command == W25_READ_DATA_COMMAND && i >= 4) {
+                out = flash.memory[(address + i - 4) % SIM_FLASH_BYTES];
+            }
+            reply[i] = out;
+        }
+    }
+    pthread_mutex_unlock(&flash.lock);
+}
+
+void sim_flash_stats(simFlashStats_t* stats) {
+    pthread_mutex_lock(&flash.lock);
+    *stats = flash.stats;
+    pthread_mutex_unlock(&flash.lock);
+}
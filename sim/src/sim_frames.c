@@ -0,0 +1,98 @@
+#include <stdio.h>
+#include <string.h>
+#include <limits.h>
+#include <pthread.h>
+
+#include "sim.h"
+
+#define SIM_MAX_LATENCIES   256
+
+typedef struct {
+    char label[32];
+    int64_t inputUs;
+    int64_t latencyUs;      // -1 while no frame has changed the panel since
+} simLatency_t;
+
+// lcdUpdateVScreen of the app ends up here through the linker (--wrap), the frame is the
+// diff update with all SPI transactions it makes
+void __real_lcdUpdateVScreen(void);
+
+static pthread_mutex_t framesLock = PTHREAD_MUTEX_INITIALIZER;
+static simFrameStats_t frames = {0, 0, INT64_MAX, 0, 0, 0};
+static uint32_t lastChecksum = 0;
+static const char* framesDirectory = NULL;
+static simLatency_t latencies[SIM_MAX_LATENCIES];
+static uint32_t latencyCount = 0;
+
+void sim_frames_set_directory(const char* directory) {
+    framesDirectory = directory;
+}
+
+void sim_frames_mark_input(const char* label) {
+    pthread_mutex_lock(&framesLock);
+    if(latencyCount < SIM_MAX_LATENCIES) {
+        simLatency_t* l = &latencies[latencyCount++];
+        snprintf(l->label, sizeof(l->label), "%s", label);
+        l->inputUs = sim_time_us();
+        l->latencyUs = -1;
+    }
+    pthread_mutex_unlock(&framesLock);
+}
+
+void __wrap_lcdUpdateVScreen(void) {
+    simSpiStats_t before, after;
+    sim_spi_stats(&before);
+    int64_t start = sim_time_us();
+    __real_lcdUpdateVScreen();
+    int64_t end = sim_time_us();
+    sim_spi_stats(&after);
+    uint32_t checksum = sim_panel_checksum();
+
+    pthread_mutex_lock(&framesLock);
+    int64_t us = end - start;
+    uint64_t bytes = after.bytes - before.bytes;
+    frames.frames++;
+    frames.updateUsSum += us;
+    frames.updateUsMin = (us < frames.updateUsMin) ? us : frames.updateUsMin;
+    frames.updateUsMax = (us > frames.updateUsMax) ? us : frames.updateUsMax;
+    frames.bytesMax = (bytes > frames.bytesMax) ? bytes : frames.bytesMax;
+    bool changed = (frames.frames == 1 || checksum != lastChecksum);
+    lastChecksum = checksum;
+    uint32_t number = 0;
+    if(changed) {
+        number = frames.changed++;
+        for(uint32_t i = 0; i < latencyCount; i++) {
+            if(latencies[i].latencyUs < 0) {
+                latencies[i].latencyUs = end - latencies[i].inputUs;
+            }
+        }
+    }
+    pthread_mutex_unlock(&framesLock);
+
+    if(changed && framesDirectory != NULL) {
+        char path[PATH_MAX];
+        snprintf(path, sizeof(path), "%s/frame_%05u.ppm", framesDirectory, (unsigned)number);
+        if(!sim_panel_dump_ppm(path)) {
+            fprintf(stderr, "sim: cannot write %s\n", path);
+        }
+    }
+}
+
+void sim_frames_stats(simFrameStats_t* stats) {
+    pthread_mutex_lock(&framesLock);
+    *stats = frames;
+    pthread_mutex_unlock(&framesLock);
+}
+
+void sim_frames_print_latencies(void) {
+    pthread_mutex_lock(&framesLock);
+    for(uint32_t i = 0; i < latencyCount; i++) {
+        const simLatency_t* l = &latencies[i];
+        if(l->latencyUs >= 0) {
+            fprintf(stderr, "sim: latency %-12s at %8.3f s: %8.3f ms\n", l->label, l->inputUs / 1e6, l->latencyUs / 1e3);
+        } else {
+            fprintf(stderr, "sim: latency %-12s at %8.3f s: no frame changed\n", l->label, l->inputUs / 1e6);
+        }
+    }
+    pthread_mutex_unlock(&framesLock);
+}
@@ -0,0 +1,61 @@
+#include <stdatomic.h>
+
+#include "driver/gpio.h"
+#include "sim.h"
+
+// One level per pin, written by the drivers (outputs) and by the script (inputs)
+static atomic_int gpioLevels[GPIO_NUM_MAX];
+
+static bool sim_gpio_valid(gpio_num_t gpio) {
+    return gpio >= 0 && gpio < GPIO_NUM_MAX;
+}
+
+esp_err_t gpio_config(const gpio_config_t* config) {
+    (void)config;
+    return ESP_OK;
+}
+
+esp_err_t gpio_reset_pin(gpio_num_t gpio) {
+    if(!sim_gpio_valid(gpio)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    atomic_store(&gpioLevels[gpio], 0);
+    return ESP_OK;
+}
+
+esp_err_t gpio_set_direction(gpio_num_t gpio, gpio_mode_t mode) {
+    (void)mode;
+    return sim_gpio_valid(gpio) ? ESP_OK : ESP_ERR_INVALID_ARG;
+}
+
+esp_err_t gpio_set_level(gpio_num_t gpio, uint32_t level) {
+    if(!sim_gpio_valid(gpio)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    atomic_store(&gpioLevels[gpio], level ? 1 : 0);
+    return ESP_OK;
+}
+
+int gpio_get_level(gpio_num_t gpio) {
+    return sim_gpio_valid(gpio) ? atomic_load(&gpioLevels[gpio]) : 0;
+}
+
+esp_err_t gpio_install_isr_service(int flags) {
+    (void)flags;
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+esp_err_t gpio_isr_handler_add(gpio_num_t gpio, gpio_isr_t handler, void* arg) {
+    (void)gpio;
+    (void)handler;
+    (void)arg;
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+void sim_gpio_drive(int gpio, int level) {
+    gpio_set_level(gpio, (uint32_t)level);
+}
+
+int sim_gpio_level(int gpio) {
+    return gpio_get_level(gpio);
+}
@@ -0,0 +1,226 @@
+/********************************************************************************************* */
+//    picalc_sim
+//    Runs app_main of src/main.c on a Linux host with the board's LCD, button and rotary encoder
+//    drivers on simulated devices. Input comes from a script, output is the UART log on stdout,
+//    PPM frames and a report of frame times, SPI traffic, flash use and input latencies on stderr.
+//    With --flash the W25 flash lives in a file, a second run with it boots like after a reset.
+//
+//    Usage: picalc_sim [options] [script|-]
+//
+//    Script lines, times in ms since start, lines run in order and wait for their time:
+//        <ms> press <SW0..SW3|ENC> [holdMs]    short press, held 100 ms by default
+//        <ms> long <SW0..SW3|ENC>              held 800 ms
+//        <ms> turn <steps>                     rotary encoder, positive is clockwise
+//        <ms> dump <file.ppm>                  what the panel shows now
+//        <ms> stats                            report so far
+//        <ms> end                              report and exit
+//    '#' starts a comment. The latency of a press or turn is counted from its last edge.
+/********************************************************************************************* */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "eduboard2_config.h"
+#include "eduboard2_defines.h"
+#include "esp_log.h"
+#include "picalc_port.h"
+#include "sim.h"
+
+#define SIM_PRESS_MS        100
+#define SIM_LONG_PRESS_MS   800
+// The encoder driver samples every ms, every level is held a few samples
+#define SIM_ENCODER_EDGE_MS 3
+#define SIM_DURATION_MS     5000
+
+void app_main();
+
+static int64_t simBootUs;
+
+int64_t sim_time_us(void) {
+    return picalc_time_us() - simBootUs;
+}
+
+static void sim_wait_until_ms(uint32_t ms) {
+    int64_t now = sim_time_us() / 1000;
+    if(now < ms) {
+        vTaskDelay(pdMS_TO_TICKS(ms - now));
+    }
+}
+
+static int sim_button_gpio(const char* name) {
+    static const struct {
+        const char* name;
+        int gpio;
+    } buttons[] = {
+        {"SW0", GPIO_SW_0}, {"SW1", GPIO_SW_1}, {"SW2", GPIO_SW_2}, {"SW3", GPIO_SW_3}, {"ENC", GPIO_RotEnc_SW},
+    };
+    for(size_t i = 0; i < sizeof(buttons) / sizeof(buttons[0]); i++) {
+        if(strcmp(name, buttons[i].name) == 0) {
+            return buttons[i].gpio;
+        }
+    }
+    return -1;
+}
+
+static void sim_press(const char* name, int gpio, uint32_t holdMs) {
+    char label[32];
+    sim_gpio_drive(gpio, 1);
+    vTaskDelay(pdMS_TO_TICKS(holdMs));
+    sim_gpio_drive(gpio, 0);
+    snprintf(label, sizeof(label), "%s %ums", name, (unsigned)holdMs);
+    sim_frames_mark_input(label);
+}
+
+// One detent per B edge, A is set up before so the driver (edge B mode) counts in the right direction
+static void sim_turn(int32_t steps) {
+    char label[32];
+    int32_t direction = (steps > 0) ? 1 : -1;
+    for(int32_t i = 0; i != steps; i += direction) {
+        int b = sim_gpio_level(GPIO_RotEnc_B);
+        sim_gpio_drive(GPIO_RotEnc_A, (direction > 0) != (b == 1));
+        vTaskDelay(pdMS_TO_TICKS(SIM_ENCODER_EDGE_MS));
+        sim_gpio_drive(GPIO_RotEnc_B, !b);
+        vTaskDelay(pdMS_TO_TICKS(SIM_ENCODER_EDGE_MS));
+    }
+    snprintf(label, sizeof(label), "turn %d", (int)steps);
+    sim_frames_mark_input(label);
+}
+
+static void sim_report(void) {
+    simFrameStats_t frames;
+    simSpiStats_t spi;
+    simPanelStats_t panel;
+    simFlashStats_t flash;
+    sim_frames_stats(&frames);
+    sim_spi_stats(&spi);
+    sim_panel_stats(&panel);
+    sim_flash_stats(&flash);
+    fflush(stdout);
+    fprintf(stderr, "sim: %.3f s, %u frames (%u changed the panel)\n", sim_time_us() / 1e6, (unsigned)frames.frames,
+            (unsigned)frames.changed);
+    if(frames.frames > 0) {
+        fprintf(stderr, "sim: frame update %.3f / %.3f / %.3f ms min/mean/max, busiest frame %llu SPI bytes\n",
+                frames.updateUsMin / 1e3, frames.updateUsSum / 1e3 / frames.frames, frames.updateUsMax / 1e3,
+                (unsigned long long)frames.bytesMax);
+    }
+    fprintf(stderr, "sim: SPI %llu transactions, %llu bytes, %.3f s on the wire at the device clock\n",
+            (unsigned long long)spi.transactions, (unsigned long long)spi.bytes, spi.wireNs / 1e9);
+    fprintf(stderr, "sim: panel %llu commands, %llu pixels written, LEDs 0x%02x\n", (unsigned long long)panel.commands,
+            (unsigned long long)panel.pixels, (unsigned)sim_board_leds());
+    fprintf(stderr, "sim: flash %llu reads, %llu page programs, %llu sector erases, %llu rejected\n",
+            (unsigned long long)flash.reads, (unsigned long long)flash.pagePrograms,
+            (unsigned long long)flash.sectorErases, (unsigned long long)flash.rejected);
+    sim_frames_print_latencies();
+}
+
+// false on a line it does not understand
+static bool sim_run_line(char* line, bool* end) {
+    char* comment = strchr(line, '#');
+    if(comment != NULL) {
+        *comment = '\0';
+    }
+    char* timeField = strtok(line, " \t\r\n");
+    if(timeField == NULL) {
+        return true;
+    }
+    char* action = strtok(NULL, " \t\r\n");
+    char* arg = strtok(NULL, " \t\r\n");
+    char* arg2 = strtok(NULL, " \t\r\n");
+    if(action == NULL) {
+        return false;
+    }
+    sim_wait_until_ms((uint32_t)strtoul(timeField, NULL, 10));
+    if(strcmp(action, "press") == 0 || strcmp(action, "long") == 0) {
+        int gpio = (arg != NULL) ? sim_button_gpio(arg) : -1;
+        if(gpio < 0) {
+            return false;
+        }
+        uint32_t holdMs = (action[0] == 'l') ? SIM_LONG_PRESS_MS : SIM_PRESS_MS;
+        if(arg2 != NULL) {
+            holdMs = (uint32_t)strtoul(arg2, NULL, 10);
+        }
+        sim_press(arg, gpio, holdMs);
+    } else if(strcmp(action, "turn") == 0 && arg != NULL) {
+        sim_turn((int32_t)strtol(arg, NULL, 10));
+    } else if(strcmp(action, "dump") == 0 && arg != NULL) {
+        if(!sim_panel_dump_ppm(arg)) {
+            fprintf(stderr, "sim: cannot write %s\n", arg);
+        }
+    } else if(strcmp(action, "stats") == 0) {
+        sim_report();
+    } else if(strcmp(action, "end") == 0) {
+        *end = true;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+static void sim_usage(const char* name) {
+    fprintf(stderr, "Usage: %s [options] [script|-]\n", name);
+    fprintf(stderr, "    --data DIR       directory mounted at /spiffs (%s)\n", SIM_DATA_DIR);
+    fprintf(stderr, "    --flash FILE     image of the W25 flash, kept from run to run (blank, in memory)\n");
+    fprintf(stderr, "    --frames DIR     every frame that changes the panel to DIR/frame_NNNNN.ppm\n");
+    fprintf(stderr, "    --spi-realtime   hold every SPI transaction for its time on the wire\n");
+    fprintf(stderr, "    --duration MS    run time without a script (%d)\n", SIM_DURATION_MS);
+    fprintf(stderr, "    --quiet          warnings and errors only on the log\n");
+}
+
+int main(int argc, char** argv) {
+    const char* scriptPath = NULL;
+    const char* dataDirectory = SIM_DATA_DIR;
+    uint32_t durationMs = SIM_DURATION_MS;
+    for(int i = 1; i < argc; i++) {
+        if(strcmp(argv[i], "--data") == 0 && i + 1 < argc) {
+            dataDirectory = argv[++i];
+        } else if(strcmp(argv[i], "--flash") == 0 && i + 1 < argc) {
+            sim_flash_set_image(argv[++i]);
+        } else if(strcmp(argv[i], "--frames") == 0 && i + 1 < argc) {
+            sim_frames_set_directory(argv[++i]);
+        } else if(strcmp(argv[i], "--spi-realtime") == 0) {
+            sim_spi_set_realtime(true);
+        } else if(strcmp(argv[i], "--duration") == 0 && i + 1 < argc) {
+            durationMs = (uint32_t)strtoul(argv[++i], NULL, 10);
+        } else if(strcmp(argv[i], "--quiet") == 0) {
+            sim_log_set_level(ESP_LOG_WARN);
+        } else if(argv[i][0] != '-' || strcmp(argv[i], "-") == 0) {
+            scriptPath = argv[i];
+        } else {
+            sim_usage(argv[0]);
+            return 1;
+        }
+    }
+    FILE* script = NULL;
+    if(scriptPath != NULL) {
+        script = (strcmp(scriptPath, "-") == 0) ? stdin : fopen(scriptPath, "r");
+        if(script == NULL) {
+            fprintf(stderr, "sim: cannot open %s\n", scriptPath);
+            return 1;
+        }
+    }
+
+    simBootUs = picalc_time_us();
+    sim_vfs_set_root(dataDirectory);
+    app_main();
+
+    int result = 0;
+    if(script != NULL) {
+        char line[256];
+        bool end = false;
+        for(uint32_t number = 1; !end && fgets(line, sizeof(line), script) != NULL; number++) {
+            if(!sim_run_line(line, &end)) {
+                fprintf(stderr, "sim: %s:%u: cannot run this line\n", scriptPath, (unsigned)number);
+                result = 1;
+                break;
+            }
+        }
+    } else {
+        sim_wait_until_ms(durationMs);
+    }
+    sim_report();
+    fflush(stdout);
+    // the app's tasks never end, exit takes them down
+    exit(result);
+}
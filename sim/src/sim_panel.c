@@ -0,0 +1,209 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+
+#include "sim.h"
+
+#define ILI9488_NOP                 0x00
+#define ILI9488_DISP_INVERSION_OFF  0x20
+#define ILI9488_DISP_INVERSION_ON   0x21
+#define ILI9488_DISPLAY_OFF         0x28
+#define ILI9488_DISPLAY_ON          0x29
+#define ILI9488_COLUMN_ADDRESS_SET  0x2A
+#define ILI9488_PAGE_ADDRESS_SET    0x2B
+#define ILI9488_MEMORY_WRITE        0x2C
+
+// The controller's frame memory, RGB with the 6 bits of each channel in the upper bits like
+// they arrive over SPI
+typedef struct {
+    pthread_mutex_t lock;
+    int dcGpio;
+    uint16_t width;
+    uint16_t height;
+    uint16_t rotation;
+    uint8_t* memory;
+    uint8_t command;
+    uint8_t params[4];
+    uint32_t paramCount;
+    uint16_t xStart, xEnd, yStart, yEnd;
+    uint16_t x, y;
+    uint8_t pixel[3];
+    uint32_t pixelBytes;
+    bool displayOn;
+    bool inverted;
+    simPanelStats_t stats;
+} simPanel_t;
+
+static simPanel_t panel = {.lock = PTHREAD_MUTEX_INITIALIZER};
+
+void sim_panel_init(int dcGpio, uint16_t width, uint16_t height, uint16_t rotation) {
+    panel.dcGpio = dcGpio;
+    panel.width = width;
+    panel.height = height;
+    panel.rotation = rotation;
+    panel.memory = calloc((size_t)width * height, 3);
+    if(panel.memory == NULL) {
+        abort();
+    }
+    panel.xEnd = width - 1;
+    panel.yEnd = height - 1;
+}
+
+static void sim_panel_command(uint8_t command) {
+    panel.command = command;
+    panel.paramCount = 0;
+    panel.stats.commands++;
+    switch(command) {
+        case ILI9488_DISP_INVERSION_OFF:
+            panel.inverted = false;
+            break;
+        case ILI9488_DISP_INVERSION_ON:
+            panel.inverted = true;
+            break;
+        case ILI9488_DISPLAY_OFF:
+            panel.displayOn = false;
+            break;
+        case ILI9488_DISPLAY_ON:
+            panel.displayOn = true;
+            break;
+        case ILI9488_MEMORY_WRITE:
+            panel.x = panel.xStart;
+            panel.y = panel.yStart;
+            panel.pixelBytes = 0;
+            break;
+        default:
+            break;
+    }
+}
+
+static void sim_panel_pixel(void) {
+    // the window wraps like on the controller, what lies outside of the memory is dropped
+    if(panel.x < panel.width && panel.y < panel.height) {
+        memcpy(&panel.memory[((size_t)panel.y * panel.width + panel.x) * 3], panel.pixel, 3);
+    }
+    panel.stats.pixels++;
+    if(panel.x++ == panel.xEnd) {
+        panel.x = panel.xStart;
+        if(panel.y++ == panel.yEnd) {
+            panel.y = panel.yStart;
+        }
+    }
+}
+
+static void sim_panel_data(uint8_t value) {
+    switch(panel.command) {
+        case ILI9488_COLUMN_ADDRESS_SET:
+        case ILI9488_PAGE_ADDRESS_SET:
+            if(panel.paramCount < 4) {
+                panel.params[panel.paramCount++] = value;
+            }
+            if(panel.paramCount == 4) {
+                uint16_t start = (uint16_t)(panel.params[0] << 8 | panel.params[1]);
+                uint16_t end = (uint16_t)(panel.params[2] << 8 | panel.params[3]);
+                if(panel.command == ILI9488_COLUMN_ADDRESS_SET) {
+                    panel.xStart = start;
+                    panel.xEnd = end;
+                } else {
+                    panel.yStart = start;
+                    panel.yEnd = end;
+                }
+            }
+            break;
+        case ILI9488_MEMORY_WRITE:
+            panel.pixel[panel.pixelBytes++] = value;
+            if(panel.pixelBytes == 3) {
+                sim_panel_pixel();
+                panel.pixelBytes = 0;
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+void sim_panel_receive(const uint8_t* data, size_t length) {
+    pthread_mutex_lock(&panel.lock);
+    // the data/command line is sampled per transaction like the controller does per byte
+    if(sim_gpio_level(panel.dcGpio) == 0) {
+        for(size_t i = 0; i < length; i++) {
+            sim_panel_command(data[i]);
+        }
+    } else {
+        for(size_t i = 0; i < length; i++) {
+            sim_panel_data(data[i]);
+        }
+    }
+    pthread_mutex_unlock(&panel.lock);
+}
+
+void sim_panel_stats(simPanelStats_t* stats) {
+    pthread_mutex_lock(&panel.lock);
+    *stats = panel.stats;
+    pthread_mutex_unlock(&panel.lock);
+}
+
+uint32_t sim_panel_checksum(void) {
+    uint32_t hash = 2166136261u;
+    pthread_mutex_lock(&panel.lock);
+    for(size_t i = 0; i < (size_t)panel.width * panel.height * 3; i++) {
+        hash = (hash ^ panel.memory[i]) * 16777619u;
+    }
+    hash = (hash ^ (uint32_t)(panel.displayOn << 1 | panel.inverted)) * 16777619u;
+    pthread_mutex_unlock(&panel.lock);
+    return hash;
+}
+
+// Pixel of the panel memory behind (x, y) of the picture, the inverse of the rotation that
+// lcdDrawPixel applies
+static const uint8_t* sim_panel_at(uint16_t x, uint16_t y) {
+    uint16_t px = x, py = y;
+    switch(panel.rotation) {
+        case 90:
+            px = panel.width - y - 1;
+            py = x;
+            break;
+        case 180:
+            px = panel.width - x - 1;
+            py = panel.height - y - 1;
+            break;
+        case 270:
+            px = y;
+            py = panel.height - x - 1;
+            break;
+        default:
+            break;
+    }
+    return &panel.memory[((size_t)py * panel.width + px) * 3];
+}
+
+bool sim_panel_dump_ppm(const char* path) {
+    FILE* f = fopen(path, "wb");
+    if(f == NULL) {
+        return false;
+    }
+    pthread_mutex_lock(&panel.lock);
+    bool turned = (panel.rotation == 90 || panel.rotation == 270);
+    uint16_t width = turned ? panel.height : panel.width;
+    uint16_t height = turned ? panel.width : panel.height;
+    uint8_t* row = malloc((size_t)width * 3);
+    if(row == NULL) {
+        abort();
+    }
+    fprintf(f, "P6\n%u %u\n255\n", (unsigned)width, (unsigned)height);
+    for(uint16_t y = 0; y < height; y++) {
+        for(uint16_t x = 0; x < width; x++) {
+            const uint8_t* p = sim_panel_at(x, y);
+            for(int c = 0; c < 3; c++) {
+                // 6 bits per channel, the low bits repeat the high ones for full white
+                uint8_t v = (uint8_t)(p[c] | p[c] >> 6);
+                v = panel.inverted ? (uint8_t)~v : v;
+                row[x * 3 + c] = panel.displayOn ? v : 0;
+            }
+        }
+        fwrite(row, 3, width, f);
+    }
+    pthread_mutex_unlock(&panel.lock);
+    free(row);
+    return fclose(f) == 0;
+}
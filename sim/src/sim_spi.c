@@ -0,0 +1,121 @@
+#include <stdlib.h>
+#include <time.h>
+#include <pthread.h>
+
+#include "driver/spi_master.h"
+#include "sim.h"
+
+#define SIM_SPI_MAX_MODELS  4
+
+struct simSpiDevice {
+    int csGpio;
+    int clockHz;
+    simSpiReceive_t receive;
+    simSpiExchange_t exchange;
+};
+
+typedef struct {
+    int csGpio;
+    simSpiReceive_t receive;
+    simSpiExchange_t exchange;
+} simSpiModel_t;
+
+// The bus lock serializes the transactions of all devices like the single SPI2 host does
+static pthread_mutex_t spiBus = PTHREAD_MUTEX_INITIALIZER;
+static simSpiModel_t spiModels[SIM_SPI_MAX_MODELS];
+static uint32_t spiModelCount = 0;
+static simSpiStats_t spiStats;
+static bool spiRealtime = false;
+
+static int64_t sim_spi_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+void sim_spi_attach(int csGpio, simSpiReceive_t receive) {
+    if(spiModelCount == SIM_SPI_MAX_MODELS) {
+        abort();
+    }
+    spiModels[spiModelCount++] = (simSpiModel_t){csGpio, receive, NULL};
+}
+
+void sim_spi_attach_duplex(int csGpio, simSpiExchange_t exchange) {
+    if(spiModelCount == SIM_SPI_MAX_MODELS) {
+        abort();
+    }
+    spiModels[spiModelCount++] = (simSpiModel_t){csGpio, NULL, exchange};
+}
+
+void sim_spi_set_realtime(bool realtime) {
+    spiRealtime = realtime;
+}
+
+void sim_spi_stats(simSpiStats_t* stats) {
+    pthread_mutex_lock(&spiBus);
+    *stats = spiStats;
+    pthread_mutex_unlock(&spiBus);
+}
+
+esp_err_t spi_bus_initialize(spi_host_device_t host, const spi_bus_config_t* config, int dmaChannel) {
+    (void)host;
+    (void)config;
+    (void)dmaChannel;
+    return ESP_OK;
+}
+
+esp_err_t spi_bus_add_device(spi_host_device_t host, const spi_device_interface_config_t* config,
+                             spi_device_handle_t* handle) {
+    (void)host;
+    struct simSpiDevice* device = calloc(1, sizeof(struct simSpiDevice));
+    if(device == NULL) {
+        abort();
+    }
+    device->csGpio = config->spics_io_num;
+    device->clockHz = config->clock_speed_hz;
+    for(uint32_t i = 0; i < spiModelCount; i++) {
+        if(spiModels[i].csGpio == device->csGpio) {
+            device->receive = spiModels[i].receive;
+            device->exchange = spiModels[i].exchange;
+        }
+    }
+    *handle = device;
+    return ESP_OK;
+}
+
+esp_err_t spi_device_transmit(spi_device_handle_t handle, spi_transaction_t* trans) {
+    size_t bytes = (trans->length + 7) / 8;
+    int64_t wireNs = (handle->clockHz > 0) ? (int64_t)(trans->length * 1000000000ull / (uint64_t)handle->clockHz) : 0;
+    pthread_mutex_lock(&spiBus);
+    if(handle->receive != NULL && trans->tx_buffer != NULL) {
+        handle->receive(trans->tx_buffer, bytes);
+    }
+    if(handle->exchange != NULL && trans->tx_buffer != NULL) {
+        handle->exchange(trans->tx_buffer, trans->rx_buffer, bytes);
+    }
+    spiStats.transactions++;
+    spiStats.bytes += bytes;
+    spiStats.wireNs += wireNs;
+    if(spiRealtime) {
+        // busy, a sleep would take longer than most transactions
+        int64_t end = sim_spi_now_ns() + wireNs;
+        while(sim_spi_now_ns() < end) {
+        }
+    }
+    pthread_mutex_unlock(&spiBus);
+    return ESP_OK;
+}
+
+esp_err_t spi_device_polling_transmit(spi_device_handle_t handle, spi_transaction_t* trans) {
+    return spi_device_transmit(handle, trans);
+}
+
+esp_err_t spi_device_acquire_bus(spi_device_handle_t handle, TickType_t ticks) {
+    (void)handle;
+    (void)ticks;
+    return ESP_OK;
+}
+
+void spi_device_release_bus(spi_device_handle_t handle) {
+    (void)handle;
+}
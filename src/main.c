@@ -10,6 +10,15 @@
 /********************************************************************************************* */
 #include "eduboard2.h"
 #include "memon.h"
+#include "picalc_chudnovsky.h"
+#include "picalc_spigot.h"
+#include "picalc_machin.h"
+#include "picalc_algo.h"
+#include "picalc_race.h"
+#include "picalc_checkpoint.h"
+#include "picalc_sweep.h"
+#include "picalc_executor.h"
+#include "picalc_port.h"
 
 #include "math.h"
 
@@ -17,74 +26,148 @@
 
 #define UPDATETIME_MS 100
 
-typedef struct {
-    double     piValue;
-    TickType_t tickCount;
-    uint32_t   iterations;
-} piResult_t;
+#define CHUDNOVSKY_START_DIGITS     16
+#define CHUDNOVSKY_MAX_DIGITS       10000
+
+#define MACHIN_FORMULA              MACHIN_FORMULA_MACHIN
+#define MACHIN_START_DIGITS         16
+#define MACHIN_MAX_DIGITS           5000
+
+// Number format of the Leibniz and Euler sums:
+//   SERIES_FORMAT_DOUBLE  soft-float double
+//   SERIES_FORMAT_FF      float-float on the single precision FPU
+//   SERIES_FORMAT_FIXED   Q2.62 integers with an exact rounding error, the tightest interval around pi
+//   SERIES_FORMAT_FLOAT   plain float, a few digits at the lowest cost
+//   SERIES_FORMAT_ADAPTIVE float, then float-float, then Q2.62, as far as the digit target needs
+#define SERIES_FORMAT               SERIES_FORMAT_ADAPTIVE
+// Summation strategy of the double format (naive, Neumaier, pairwise, reverse)
+#define SERIES_SUM_MODE             SERIES_SUM_NEUMAIER
+// Workers per series, 2 splits every Leibniz/Euler batch over both cores
+#define SERIES_PARALLEL_WORKERS     1
+#define SERIES_PARALLEL_SPLIT       SERIES_SPLIT_INTERLEAVED
+// 1 hands the chunks to a work-stealing executor shared by both series instead of a static split
+#define SERIES_PARALLEL_STEALING    0
+
+// Race engines from picalc_race.h. One worker task per core steps the running engines in turn,
+// every step is sized to take about RACE_SLICE_US and publishes a result.
+#define RACE_SLICE_US               10000
+// Workers sleep for a tick this often so the idle tasks can feed the watchdog
+#define RACE_YIELD_US               50000
+// Index into raceSelections at boot, a long press on SW2 while idle selects the next one
+#define RACE_SELECTION              0
+// Seed of the Monte-Carlo engine, 0 takes a new one from the hardware RNG on every reset
+#define MONTE_CARLO_SEED            0
+// Lanes of the Monte-Carlo engine, 2 splits every batch over both cores
+#define MONTE_CARLO_LANES           1
+// Every race engine that moved is written to the reserved blocks of the flash this often, at boot
+// the engines come back from their last checkpoint and continue on the next start
+#define CHECKPOINT_PERIOD_MS        5000
+
+// Headless benchmark: every engine to every digit target, BENCH_REPEATS times each, one line per
+// configuration over the UART. A long press on SW3 while idle starts it, BENCH_AT_BOOT 1 right
+// after boot. `picalc_bench sweep` runs the same sweep on a host.
+#define BENCH_AT_BOOT               0
+#define BENCH_REPEATS               3
+#define BENCH_TIMEOUT_US            20000000
+#define BENCH_FORMAT                SWEEP_FORMAT_CSV
 
-const double piReference = 3.141592653589793238;
+#define SPIGOT_MAX_DIGITS           1000
+#define SPIGOT_TICKER_DIGITS        50
+#define SPIGOT_LOG_DIGITS           50
 
+// Grid of result panels below the spigot ticker line, sized to the number of participants
+#define SCREEN_WIDTH        480
+#define PANEL_TOP           26
+#define PANEL_AREA_HEIGHT   294
+// Panels below this height leave out the error bound line and use the small font for the title
+#define PANEL_FULL_HEIGHT   147
+
+// What one panel of the grid shows
+typedef struct {
+    const char* title;
+    const char* passesLabel;
+    const piResult_t* result;
+    uint32_t digits;
+    seriesAccel_t accel;
+    bool running;
+} resultPanel_t;
+
+// The encoder goes as far as race and sweep can prove digits
+#define DIGIT_TARGET_MAX    ALGO_MAX_DIGITS
 uint8_t digitTarget = 6;
 
-QueueHandle_t leibnizQueue;
-QueueHandle_t eulerQueue;
+// Engines that race on SW2, Chudnovsky and Machin always join
+typedef struct {
+    const char* name;
+    uint32_t algos;     // PI_ALGO_MASK bits
+} raceSelection_t;
+
+const raceSelection_t raceSelections[] = {
+    {"All", PI_ALGO_ALL},
+    {"Leibniz/Euler", PI_ALGO_MASK(PI_ALGO_LEIBNIZ) | PI_ALGO_MASK(PI_ALGO_BASEL)},
+    {"Series", PI_ALGO_MASK(PI_ALGO_LEIBNIZ) | PI_ALGO_MASK(PI_ALGO_BASEL) | PI_ALGO_MASK(PI_ALGO_NILAKANTHA) | PI_ALGO_MASK(PI_ALGO_RAMANUJAN)},
+    {"Products", PI_ALGO_MASK(PI_ALGO_WALLIS) | PI_ALGO_MASK(PI_ALGO_VIETE) | PI_ALGO_MASK(PI_ALGO_MONTE_CARLO)},
+};
+#define RACE_SELECTIONS (sizeof(raceSelections) / sizeof(raceSelections[0]))
+
+volatile uint8_t raceSelection = RACE_SELECTION;
+
+race_t race;
+
+#ifdef CONFIG_ENABLE_FLASH
+checkpoint_t checkpoint;
+#endif
+// Engines with terms from a checkpoint at boot, shown like the ones started alone
+uint32_t restoredAlgos = 0;
+
+// Shared by both series with SERIES_PARALLEL_STEALING, idle workers steal the other series' chunks
+executor_t seriesExecutor;
 
-TaskHandle_t leibnizTaskHandle = NULL;
-TaskHandle_t eulerTaskHandle = NULL;
+QueueHandle_t chudnovskyQueue;
+QueueHandle_t machinQueue;
+
+TaskHandle_t chudnovskyTaskHandle = NULL;
+TaskHandle_t machinTaskHandle = NULL;
+
+// Set by controlTask on reset, makes chudnovskyTask drop its current run and release its memory
+volatile bool chudnovskyCancel = false;
+volatile bool machinCancel = false;
+// Set by controlTask on reset, ends the sweep of benchTask
+volatile bool benchCancel = false;
+
+// Spigot state is sized at compile time, digits stream to controlTask through spigotRing
+TaskHandle_t spigotTaskHandle = NULL;
+uint32_t spigotCells[SPIGOT_CELLS(SPIGOT_MAX_DIGITS)];
+uint8_t spigotRingStorage[64];
+ringbuf_t spigotRing;
 
 EventGroupHandle_t piCalcEventGroup;
 #define LEIBNIZ_START      (1 << 0)  // bit 0
 #define EULER_START         (1 << 1)  // bit 1
 #define RACE_START          (1 << 2)  // bit 2
+#define BENCH_START         (1 << 3)  // bit 3, cleared by benchTask when the sweep ends
 #define RESET               (1 << 5)  // bit 5
 
 // Forward declarations
-void leibnizTask(void* param);
-void eulerTask(void* param);
+void chudnovskyTask(void* param);
+void machinTask(void* param);
+void spigotTask(void* param);
+void benchTask(void* param);
 
-int checkPiDigits__(double calculatedPi, double referencePi) {
+// The first provenDigits decimals in green, the digits the engine's interval holds
+void drawColoredPi__(const FontxFile *font, uint16_t charWidth, uint16_t x, uint16_t y, const char* label, double calculatedPi, uint32_t provenDigits) {
     char calcStr[32];
-    char refStr[32];
-    
-    sprintf(calcStr, "%.15f", calculatedPi);
-    sprintf(refStr, "%.15f", referencePi);
-    
-    int matchingDigits = 0;
-    bool afterDecimal = false;
-    
-    for(int i = 0; calcStr[i] != '\0' && refStr[i] != '\0'; i++) {
-        if(calcStr[i] == '.') {
-            afterDecimal = true;
-            continue;
-        }
-        
-        if(afterDecimal) {
-            if(calcStr[i] == refStr[i]) {
-                matchingDigits++;
-            } else {
-                break;
-            }
-        }
-    }
-    
-    return matchingDigits;
-}
-
-void drawColoredPi__(const FontxFile *font, uint16_t x, uint16_t y, double calculatedPi, double referencePi) {
-    char calcStr[32];
-    char refStr[32];
     char singleChar[2] = {0, 0};
     
     sprintf(calcStr, "%.10f", calculatedPi);
-    sprintf(refStr, "%.10f", referencePi);
     
     uint16_t xOffset = x;
+    uint32_t decimals = 0;
     bool afterDecimal = false;
     
-    // Draw "Pi = " label in white
-    lcdDrawString(font, xOffset, y, "Pi = ", WHITE);
-    xOffset += 5*12;
+    // Draw label in white
+    lcdDrawString(font, xOffset, y, label, WHITE);
+    xOffset += strlen(label)*charWidth;
     
     for(int i = 0; calcStr[i] != '\0'; i++) {
         singleChar[0] = calcStr[i];
@@ -93,12 +176,144 @@ void drawColoredPi__(const FontxFile *font, uint16_t x, uint16_t y, double calcu
         if(calcStr[i] == '.') {
             afterDecimal = true;
             color = WHITE;
-        } else if(afterDecimal && calcStr[i] == refStr[i]) {
+        } else if(afterDecimal && decimals++ < provenDigits) {
             color = GREEN;
         }
         
         lcdDrawString(font, xOffset, y, singleChar, color);
-        xOffset += 12;
+        xOffset += charWidth;
+    }
+}
+
+// Iterations per CPU second and cycles per iteration, "-" until there is a measurement
+void formatRate__(char* line, const char* prefix, const piResult_t* result) {
+    if(result->iterations == 0 || result->cpuUs <= 0) {
+        sprintf(line, "%s-", prefix);
+        return;
+    }
+    sprintf(line, "%s%.3g/s %.3gcy", prefix, (double)result->iterations * 1e6 / (double)result->cpuUs,
+            (double)result->cycles / (double)result->iterations);
+}
+
+void drawResultPanel__(uint16_t x, uint16_t y, uint16_t width, uint16_t height, const char* title, const piResult_t* result, uint32_t digits, const char* passesLabel, seriesAccel_t accel) {
+    char line[48];
+    uint16_t color = WHITE;
+
+    if(height >= PANEL_FULL_HEIGHT) {
+        if(accel != SERIES_ACCEL_NONE) {
+            // accelerated value replaces the error bound, the raw partial sum stays visible. The
+            // digits are proven with the acceleration, only its value gets them.
+            sprintf(line, "%s (%s)", title, accel_mode_name(accel));
+            lcdDrawString(fx24G, x+8, y+28, line, color);
+            drawColoredPi__(fx16G, 8, x+8, y+48, "Pi = ", result->piValue, 0);
+            drawColoredPi__(fx16G, 8, x+8, y+66, "Ac = ", result->piAccelerated, digits);
+        } else {
+            lcdDrawString(fx24G, x+8, y+28, title, color);
+            drawColoredPi__(fx16G, 8, x+8, y+48, "Pi = ", result->piValue, digits);
+            sprintf(line, result->probable ? "Err ~ %.2e" : "Err < %.2e", result->errorBound);
+            lcdDrawString(fx16G, x+8, y+66, line, color);
+        }
+        sprintf(line, "%s = %llu", passesLabel, (unsigned long long)result->iterations);
+        lcdDrawString(fx16G, x+8, y+84, line, color);
+        sprintf(line, "Time = %.3fs cpu %.3fs", (double)result->elapsedUs / 1e6, (double)result->cpuUs / 1e6);
+        lcdDrawString(fx16G, x+8, y+102, line, color);
+        formatRate__(line, "Rate = ", result);
+        lcdDrawString(fx16G, x+8, y+120, line, color);
+        sprintf(line, result->probable ? "Digits ~ %d / %d" : "Digits = %d / %d", (int)digits, digitTarget);
+        lcdDrawString(fx16G, x+8, y+138, line, color);
+    } else {
+        // five lines of the small font, the accelerated value replaces the raw one and the rate the count
+        if(accel != SERIES_ACCEL_NONE) {
+            sprintf(line, "%s (%s)", title, accel_mode_name(accel));
+            lcdDrawString(fx16G, x+8, y+20, line, color);
+            drawColoredPi__(fx16G, 8, x+8, y+38, "Ac = ", result->piAccelerated, digits);
+        } else {
+            lcdDrawString(fx16G, x+8, y+20, title, color);
+            drawColoredPi__(fx16G, 8, x+8, y+38, "Pi = ", result->piValue, digits);
+        }
+        formatRate__(line, "", result);
+        lcdDrawString(fx16G, x+8, y+56, line, color);
+        sprintf(line, "Time = %.3fs", (double)result->elapsedUs / 1e6);
+        lcdDrawString(fx16G, x+8, y+74, line, color);
+        sprintf(line, result->probable ? "Digits ~ %d / %d" : "Digits = %d / %d", (int)digits, digitTarget);
+        lcdDrawString(fx16G, x+8, y+92, line, color);
+    }
+    if(digits >= digitTarget) {
+        lcdDrawRect(x+2, y+4, x+width-3, y+height-2, GREEN);
+    } else if (digits == 0) {
+        lcdDrawRect(x+2, y+4, x+width-3, y+height-2, BLUE);
+    } else {
+        lcdDrawRect(x+2, y+4, x+width-3, y+height-2, RED);
+    }
+}
+
+// Columns of the panel grid: 1 panel fills the screen, up to 4 make a 2x2 grid, up to 9 a 3x3 grid
+uint16_t panelColumns__(uint32_t panels) {
+    if(panels <= 1) {
+        return 1;
+    }
+    if(panels <= 4) {
+        return 2;
+    }
+    return (panels <= 9) ? 3 : 4;
+}
+
+#ifdef CONFIG_ENABLE_FLASH
+// The checkpoints go through the littlefs block device to the blocks the filesystem leaves out
+bool checkpointRead__(void* context, uint32_t address, void* data, uint32_t size) {
+    (void)context;
+    return storage_lfs_read(NULL, address / FLASH_BLOCK_SIZE, address % FLASH_BLOCK_SIZE, data, size) == 0;
+}
+
+bool checkpointProg__(void* context, uint32_t address, const void* data, uint32_t size) {
+    (void)context;
+    return storage_lfs_prog(NULL, address / FLASH_BLOCK_SIZE, address % FLASH_BLOCK_SIZE, data, size) == 0;
+}
+
+bool checkpointErase__(void* context, uint32_t address) {
+    (void)context;
+    return storage_lfs_erase(NULL, address / FLASH_BLOCK_SIZE) == 0;
+}
+
+void restoreCheckpoints__(void) {
+    if(!eduboard_flash_reserved_free()) {
+        ESP_LOGW(TAG, "The filesystem still uses the reserved flash blocks, the race is not checkpointed");
+        return;
+    }
+    checkpointFlash_t flash = {NULL, checkpointRead__, checkpointProg__, checkpointErase__, FLASH_PAGE_SIZE, FLASH_BLOCK_SIZE,
+                               (FLASH_BLOCK_COUNT - FLASH_RESERVED_BLOCKS) * FLASH_BLOCK_SIZE, FLASH_RESERVED_BLOCKS * FLASH_BLOCK_SIZE};
+    if(!checkpoint_init(&checkpoint, &flash, &race)) {
+        ESP_LOGE(TAG, "The checkpoints do not fit into the reserved flash blocks");
+        return;
+    }
+    restoredAlgos = checkpoint_restore(&checkpoint);
+    for(uint32_t id = 0; id < PI_ALGO_COUNT; id++) {
+        raceEngine_t* engine = &race.engines[id];
+        if(restoredAlgos & PI_ALGO_MASK(id)) {
+            ESP_LOGI(TAG, "%s restored at %llu %s, %.3fs", engine->algo->name,
+                     (unsigned long long)engine->algo->count(engine->state), engine->algo->countLabel, engine->elapsedUs / 1e6);
+        }
+    }
+    // next to the race worker of core 0, the flash waits do not hold up core 1
+    checkpoint_start_writer(&checkpoint, CHECKPOINT_PERIOD_MS, 1, 3*2048, 0);
+}
+#endif
+
+// race_start continues a stopped engine from its terms, only the ones a raised target needs are new
+void startEngines__(uint32_t algos) {
+    uint32_t stopped = 0;
+    for(uint32_t id = 0; id < PI_ALGO_COUNT; id++) {
+        if(!race.engines[id].running) {
+            stopped |= PI_ALGO_MASK(id);
+        }
+    }
+    race_start(&race, algos, digitTarget);
+    for(uint32_t id = 0; id < PI_ALGO_COUNT; id++) {
+        raceEngine_t* engine = &race.engines[id];
+        if((algos & stopped & PI_ALGO_MASK(id)) && engine->running && engine->result.iterations > 0) {
+            ESP_LOGI(TAG, "%s continues at %llu %s toward %d digits", engine->algo->name,
+                     (unsigned long long)engine->result.iterations, engine->algo->countLabel, digitTarget);
+        }
     }
 }
 
@@ -107,26 +322,54 @@ void inputTask(void* param) {
     uint32_t eventBits;
     for(;;) {
         eventBits = xEventGroupGetBits(piCalcEventGroup);
-        if(button_get_state(SW0, true) == SHORT_PRESSED) {
-            if(!(eventBits & EULER_START || eventBits & RACE_START)) {
+        bool idle = !(eventBits & LEIBNIZ_START || eventBits & EULER_START || eventBits & RACE_START || eventBits & BENCH_START);
+        button_state sw0 = button_get_state(SW0, true);
+        if(sw0 == SHORT_PRESSED) {
+            if(!(eventBits & EULER_START || eventBits & RACE_START || eventBits & BENCH_START)) {
                 xEventGroupSetBits(piCalcEventGroup, LEIBNIZ_START);
             }
+        } else if(sw0 == LONG_PRESSED && idle) {
+            // raw -> Euler transform -> Wynn epsilon -> raw
+            piAlgoConfig_t* config = &race.engines[PI_ALGO_LEIBNIZ].config;
+            if(config->accel == SERIES_ACCEL_NONE) {
+                config->accel = SERIES_ACCEL_EULER;
+            } else if(config->accel == SERIES_ACCEL_EULER) {
+                config->accel = SERIES_ACCEL_WYNN;
+            } else {
+                config->accel = SERIES_ACCEL_NONE;
+            }
         }
-        if(button_get_state(SW1, true) == SHORT_PRESSED) {
-            if(!(eventBits & LEIBNIZ_START || eventBits & RACE_START)) {
+        button_state sw1 = button_get_state(SW1, true);
+        if(sw1 == SHORT_PRESSED) {
+            if(!(eventBits & LEIBNIZ_START || eventBits & RACE_START || eventBits & BENCH_START)) {
                 xEventGroupSetBits(piCalcEventGroup, EULER_START);
             }
+        } else if(sw1 == LONG_PRESSED && idle) {
+            piAlgoConfig_t* config = &race.engines[PI_ALGO_BASEL].config;
+            config->accel = (config->accel == SERIES_ACCEL_NONE) ? SERIES_ACCEL_EULER_MACLAURIN : SERIES_ACCEL_NONE;
         }
-        if(button_get_state(SW2, true) == SHORT_PRESSED) {
-            if(!(eventBits & LEIBNIZ_START || eventBits & EULER_START)) {
+        button_state sw2 = button_get_state(SW2, true);
+        if(sw2 == SHORT_PRESSED) {
+            if(!(eventBits & LEIBNIZ_START || eventBits & EULER_START || eventBits & BENCH_START)) {
                 xEventGroupSetBits(piCalcEventGroup, RACE_START);
             }
+        } else if(sw2 == LONG_PRESSED && idle) {
+            raceSelection = (raceSelection + 1) % RACE_SELECTIONS;
+            ESP_LOGI(TAG, "Race selection: %s", raceSelections[raceSelection].name);
         }
-        if(button_get_state(SW3, true) == SHORT_PRESSED) {
+        button_state sw3 = button_get_state(SW3, true);
+        if(sw3 == SHORT_PRESSED) {
             xEventGroupSetBits(piCalcEventGroup, RESET);
+        } else if(sw3 == LONG_PRESSED && idle) {
+            xEventGroupSetBits(piCalcEventGroup, BENCH_START);
+        }
+        // the target also moves once the started engines have stopped, controlTask continues them
+        bool stopped = !(eventBits & BENCH_START);
+        for(uint32_t id = 0; id < PI_ALGO_COUNT; id++) {
+            stopped = stopped && !race.engines[id].running;
         }
         rotationChange = rotary_encoder_get_rotation(true);
-        if(!(eventBits & LEIBNIZ_START || eventBits & EULER_START || eventBits & RACE_START)) {
+        if(idle || stopped) {
             if(rotationChange != 0) {
                 if(rotationChange > 0) {
                     digitTarget ++;
@@ -136,8 +379,8 @@ void inputTask(void* param) {
                 if(digitTarget < 1) {
                     digitTarget = 1;
                 }
-                if(digitTarget > 10) {
-                    digitTarget = 10;
+                if(digitTarget > DIGIT_TARGET_MAX) {
+                    digitTarget = DIGIT_TARGET_MAX;
                 }
             }
         }
@@ -147,155 +390,190 @@ void inputTask(void* param) {
 }
 
 void controlTask(void* param) {
-    piResult_t leibnizResult;
-    uint8_t leibnizDigits = 0;
-    leibnizResult.iterations = 0;
-    leibnizResult.piValue = 0.0;
-    leibnizResult.tickCount = 0;
-    piResult_t eulerResult;
-    uint8_t eulerDigits = 0;
-    eulerResult.iterations = 0;
-    eulerResult.piValue = 0.0;
-    eulerResult.tickCount = 0;
+    piResult_t chudnovskyResult;
+    piResult_t machinResult;
+    memset(&chudnovskyResult, 0, sizeof(piResult_t));
+    memset(&machinResult, 0, sizeof(piResult_t));
+    bool chudnovskyRunning = false;
+    bool machinRunning = false;
+    // engines started on their own since the last reset are shown next to the race selection, a raised
+    // target continues them. Restored engines are only shown, they stay parked until a start picks them up.
+    uint32_t soloAlgos = 0;
+    uint32_t parkedAlgos = restoredAlgos;
+    resultPanel_t panels[PI_ALGO_COUNT + 2];
+    uint8_t leds = 0;
+    uint32_t spigotDigits = 0;
+    uint8_t spigotDigit;
+    char spigotTicker[SPIGOT_TICKER_DIGITS + 1] = "";
+    char spigotLog[SPIGOT_LOG_DIGITS + 1];
+    char displaySpigot[SPIGOT_TICKER_DIGITS + 16];
     EventBits_t eventBits;
     EventBits_t eventBitsLast = 0;
-    uint16_t xpos = 20;
-	uint16_t ypos = 50;
-    char displayTicksLeibniz[24];
-    char displayIterationsLeibniz[24];
-    char displayTimeLeibniz[24];
-    char displayMatchingDigitsLeibniz[24];
-    char displayTicksEuler[24];
-    char displayIterationsEuler[24];
-    char displayTimeEuler[24];
-    char displayMatchingDigitsEuler[24];
+    uint8_t digitTargetLast = digitTarget;
+    uint16_t xpos = 10;
 	uint16_t color = WHITE;
 
     for(;;) {
         eventBits = xEventGroupGetBits(piCalcEventGroup);
         if(eventBits & LEIBNIZ_START && !(eventBitsLast & LEIBNIZ_START)) {
-            led_set(LED0, 1);
-            if(leibnizTaskHandle != NULL && eTaskGetState(leibnizTaskHandle) == eSuspended) {
-                vTaskResume(leibnizTaskHandle);
-            }
+            soloAlgos |= PI_ALGO_MASK(PI_ALGO_LEIBNIZ);
+            startEngines__(PI_ALGO_MASK(PI_ALGO_LEIBNIZ));
         }
         if(eventBits & EULER_START && !(eventBitsLast & EULER_START)) {
-            led_set(LED1, 1);
-            if(eulerTaskHandle != NULL && eTaskGetState(eulerTaskHandle) == eSuspended) {
-                vTaskResume(eulerTaskHandle);
-            }
+            soloAlgos |= PI_ALGO_MASK(PI_ALGO_BASEL);
+            startEngines__(PI_ALGO_MASK(PI_ALGO_BASEL));
         }
         if(eventBits & RACE_START && !(eventBitsLast & RACE_START)) {
-            led_set(LED0, 1);
-            led_set(LED1, 1);
-            if(leibnizTaskHandle != NULL && eTaskGetState(leibnizTaskHandle) == eSuspended) {
-                vTaskResume(leibnizTaskHandle);
+            startEngines__(raceSelections[raceSelection].algos);
+            chudnovskyRunning = chudnovskyResult.digits < digitTarget;
+            machinRunning = machinResult.digits < digitTarget;
+            if(chudnovskyTaskHandle != NULL && eTaskGetState(chudnovskyTaskHandle) == eSuspended) {
+                vTaskResume(chudnovskyTaskHandle);
             }
-            if(eulerTaskHandle != NULL && eTaskGetState(eulerTaskHandle) == eSuspended) {
-                vTaskResume(eulerTaskHandle);
+            if(machinTaskHandle != NULL && eTaskGetState(machinTaskHandle) == eSuspended) {
+                vTaskResume(machinTaskHandle);
+            }
+            if(spigotTaskHandle != NULL && eTaskGetState(spigotTaskHandle) == eSuspended) {
+                vTaskResume(spigotTaskHandle);
             }
         }
+        if(digitTarget != digitTargetLast) {
+            // a raised target picks up the runs where they stopped instead of starting over
+            uint32_t started = soloAlgos | ((eventBits & RACE_START) ? raceSelections[raceSelection].algos : 0);
+            if(started != 0) {
+                startEngines__(started);
+            }
+            if(eventBits & RACE_START) {
+                chudnovskyRunning = chudnovskyResult.digits < digitTarget;
+                machinRunning = machinResult.digits < digitTarget;
+            }
+            digitTargetLast = digitTarget;
+        }
+        if(eventBits & BENCH_START && !(eventBitsLast & BENCH_START)) {
+            benchCancel = false;
+            xTaskCreatePinnedToCore(benchTask, "benchTask", 3*2048, NULL, 1, NULL, 1);
+        }
         if(eventBits & RESET && !(eventBitsLast & RESET)) {
             xEventGroupClearBits(piCalcEventGroup, LEIBNIZ_START | EULER_START  | RACE_START | RESET);
-            led_set(LED0, 0);
-            led_set(LED1, 0);
-            
-            // Delete and recreate tasks to fully reset their internal state
-            if(leibnizTaskHandle != NULL) {
-                vTaskDelete(leibnizTaskHandle);
-                leibnizTaskHandle = NULL;
-            }
-            if(eulerTaskHandle != NULL) {
-                vTaskDelete(eulerTaskHandle);
-                eulerTaskHandle = NULL;
+            benchCancel = true;
+
+            race_reset(&race);
+            // chudnovskyTask and machinTask own heap memory, so they are cancelled instead of deleted.
+            // They drop their run and suspend themselves, the next resume starts from scratch.
+            chudnovskyCancel = true;
+            machinCancel = true;
+            if(spigotTaskHandle != NULL) {
+                vTaskDelete(spigotTaskHandle);
+                spigotTaskHandle = NULL;
             }
             
             // Clear queues
-            xQueueReset(leibnizQueue);
-            xQueueReset(eulerQueue);
+            xQueueReset(chudnovskyQueue);
+            xQueueReset(machinQueue);
+            ringbuf_init(&spigotRing, spigotRingStorage, sizeof(spigotRingStorage));
             
-            // Recreate tasks in suspended state
-            xTaskCreatePinnedToCore(leibnizTask, "leibnizTask", 2*2048, NULL, 1, &leibnizTaskHandle, 1);
-            xTaskCreatePinnedToCore(eulerTask, "eulerTask", 2*2048, NULL, 1, &eulerTaskHandle, 1);
-            vTaskSuspend(leibnizTaskHandle);
-            vTaskSuspend(eulerTaskHandle);
+            // Recreate the spigot in suspended state
+            xTaskCreatePinnedToCore(spigotTask, "spigotTask", 2*2048, NULL, 1, &spigotTaskHandle, 1);
+            vTaskSuspend(spigotTaskHandle);
             
-            leibnizResult.iterations = 0;
-            leibnizResult.piValue = 0.0;
-            leibnizResult.tickCount = 0;
-            leibnizDigits = 0;
-            eulerResult.iterations = 0;
-            eulerResult.piValue = 0.0;
-            eulerResult.tickCount = 0;
-            eulerDigits = 0;
+            memset(&chudnovskyResult, 0, sizeof(piResult_t));
+            memset(&machinResult, 0, sizeof(piResult_t));
+            chudnovskyRunning = false;
+            machinRunning = false;
+            soloAlgos = 0;
+            parkedAlgos = 0;
+            spigotDigits = 0;
+            spigotTicker[0] = '\0';
             
             eventBits = xEventGroupGetBits(piCalcEventGroup);
         }
 
         eventBitsLast = eventBits;
 
-        if(leibnizDigits < digitTarget) {
-            if(xQueueReceive(leibnizQueue, &leibnizResult, 0) == pdTRUE) {
-                xQueueReset(leibnizQueue);
-                leibnizDigits = checkPiDigits__(leibnizResult.piValue, piReference);
+        // Engines stop at digitTarget, a step that was already under way may still publish
+        for(uint32_t id = 0; id < PI_ALGO_COUNT; id++) {
+            raceEngine_t* engine = &race.engines[id];
+            if(race_update(&race, (piAlgoId_t)id, digitTarget)) {
+                const piResult_t* r = &engine->result;
+                ESP_LOGI(TAG, "%s: %d digits, %llu %s in %.3fs, cpu %.3fs, %.0f/s, %.1f cycles each", engine->algo->name,
+                         (int)engine->digits, (unsigned long long)r->iterations, engine->algo->countLabel, r->elapsedUs / 1e6,
+                         r->cpuUs / 1e6, (r->cpuUs > 0) ? r->iterations * 1e6 / r->cpuUs : 0.0,
+                         (r->iterations > 0) ? (double)r->cycles / r->iterations : 0.0);
             }
-        } else {
-            led_set(LED0, 0);
-            if(leibnizTaskHandle != NULL && eTaskGetState(leibnizTaskHandle) != eSuspended) {
-                vTaskSuspend(leibnizTaskHandle);
+        }
+
+        // Chudnovsky and Machin win the race as soon as they reach digitTarget, but keep
+        // refining up to their maximum digits and suspend themselves when done.
+        xQueueReceive(chudnovskyQueue, &chudnovskyResult, 0);
+        if(chudnovskyResult.digits >= digitTarget) {
+            chudnovskyRunning = false;
+        }
+        xQueueReceive(machinQueue, &machinResult, 0);
+        if(machinResult.digits >= digitTarget) {
+            machinRunning = false;
+        }
+
+        // Consume the spigot stream: scrolling ticker on the display, lines of digits to the log
+        while(ringbuf_pop(&spigotRing, &spigotDigit)) {
+            size_t tickerLength = strlen(spigotTicker);
+            if(tickerLength == SPIGOT_TICKER_DIGITS) {
+                memmove(&spigotTicker[0], &spigotTicker[1], SPIGOT_TICKER_DIGITS - 1);
+                tickerLength--;
+            }
+            spigotTicker[tickerLength] = '0' + spigotDigit;
+            spigotTicker[tickerLength + 1] = '\0';
+            spigotLog[spigotDigits % SPIGOT_LOG_DIGITS] = '0' + spigotDigit;
+            spigotDigits++;
+            if(spigotDigits % SPIGOT_LOG_DIGITS == 0 || spigotDigits == SPIGOT_MAX_DIGITS) {
+                spigotLog[(spigotDigits - 1) % SPIGOT_LOG_DIGITS + 1] = '\0';
+                ESP_LOGI(TAG, "Spigot %4d: %s", (int)spigotDigits, spigotLog);
             }
         }
-        
-        if(eulerDigits < digitTarget) {
-            if(xQueueReceive(eulerQueue, &eulerResult, 0) == pdTRUE) {
-                xQueueReset(eulerQueue);
-                eulerDigits = checkPiDigits__(eulerResult.piValue, piReference);
+
+        // One panel per participant: the selected engines, the ones started alone or restored, Chudnovsky and Machin
+        uint32_t shown = raceSelections[raceSelection].algos | soloAlgos | parkedAlgos;
+        uint32_t panelCount = 0;
+        for(uint32_t id = 0; id < PI_ALGO_COUNT; id++) {
+            raceEngine_t* engine = &race.engines[id];
+            if(shown & PI_ALGO_MASK(id)) {
+                panels[panelCount++] = (resultPanel_t){engine->algo->name, engine->algo->countLabel, &engine->result,
+                                                       engine->digits, engine->config.accel, engine->running};
             }
-        } else {
-            led_set(LED1, 0);
-            if(eulerTaskHandle != NULL && eTaskGetState(eulerTaskHandle) != eSuspended) {
-                vTaskSuspend(eulerTaskHandle);
+        }
+        panels[panelCount++] = (resultPanel_t){"Chudnovsky", "Terms", &chudnovskyResult, chudnovskyResult.digits, SERIES_ACCEL_NONE, chudnovskyRunning};
+        panels[panelCount++] = (resultPanel_t){machin_formula_name(MACHIN_FORMULA), "Terms", &machinResult, machinResult.digits, SERIES_ACCEL_NONE, machinRunning};
+
+        // LED n is lit while the engine of panel n runs
+        uint8_t ledsNow = 0;
+        for(uint32_t i = 0; i < panelCount && i < 8; i++) {
+            if(panels[i].running) {
+                ledsNow |= 1 << i;
             }
         }
+        for(uint8_t led = 0; led < 8; led++) {
+            if((ledsNow ^ leds) & (1 << led)) {
+                led_set(LED0 + led, (ledsNow >> led) & 1);
+            }
+        }
+        leds = ledsNow;
 
         lcdFillScreen(BLACK);
 
-        sprintf((char*)displayTicksLeibniz, "Ticks = %d", (int)leibnizResult.tickCount);
-        sprintf((char*)displayIterationsLeibniz, "Passes = %d", (int)leibnizResult.iterations);
-        sprintf((char*)displayTimeLeibniz, "Time = %.3fs", ((float)(leibnizResult.tickCount * portTICK_PERIOD_MS)) / 1000);
-        sprintf((char*)displayMatchingDigitsLeibniz, "Digits = %d / %d", leibnizDigits, digitTarget);
-
-        lcdDrawString(fx32G, xpos, ypos, "Leibniz", color);
-        drawColoredPi__(fx24G, xpos, ypos+50, leibnizResult.piValue, piReference);
-        lcdDrawString(fx24G, xpos, ypos+100, &displayTicksLeibniz[0], color);
-        lcdDrawString(fx24G, xpos, ypos+150, &displayIterationsLeibniz[0], color);
-        lcdDrawString(fx24G, xpos, ypos+200, &displayTimeLeibniz[0], color);
-        lcdDrawString(fx24G, xpos, ypos+250, &displayMatchingDigitsLeibniz[0], color);
-        if(leibnizDigits >= digitTarget) {
-            lcdDrawRect(xpos-10, ypos+10, ypos+180, ypos+260, GREEN);
-        } else if (leibnizDigits == 0) {
-            lcdDrawRect(xpos-10, ypos+10, ypos+180, ypos+260, BLUE);
+        if(eventBits & BENCH_START) {
+            sprintf((char*)displaySpigot, "Benchmark running, results on UART");
         } else {
-            lcdDrawRect(xpos-10, ypos+10, ypos+180, ypos+260, RED);
+            sprintf((char*)displaySpigot, "%4d %s", (int)spigotDigits, spigotTicker);
         }
+        lcdDrawString(fx16G, xpos, 20, &displaySpigot[0], color);
 
-        sprintf((char*)displayTicksEuler, "Ticks = %d", (int)eulerResult.tickCount);
-        sprintf((char*)displayIterationsEuler, "Passes = %d", (int)eulerResult.iterations);
-        sprintf((char*)displayTimeEuler, "Time = %.3fs", ((float)(eulerResult.tickCount * portTICK_PERIOD_MS)) / 1000);
-        sprintf((char*)displayMatchingDigitsEuler, "Digits = %d / %d", eulerDigits, digitTarget);
-
-        lcdDrawString(fx32G, xpos+230, ypos, "Euler", color);
-        drawColoredPi__(fx24G, xpos+230, ypos+50, eulerResult.piValue, piReference);
-        lcdDrawString(fx24G, xpos+230, ypos+100, &displayTicksEuler[0], color);
-        lcdDrawString(fx24G, xpos+230, ypos+150, &displayIterationsEuler[0], color);
-        lcdDrawString(fx24G, xpos+230, ypos+200, &displayTimeEuler[0], color);
-        lcdDrawString(fx24G, xpos+230, ypos+250, &displayMatchingDigitsEuler[0], color);
-        if(eulerDigits >= digitTarget) {
-            lcdDrawRect(xpos+220, ypos+10, ypos+410, ypos+260, GREEN);
-        } else if (eulerDigits == 0) {
-            lcdDrawRect(xpos+220, ypos+10, ypos+410, ypos+260, BLUE);
-        } else {
-            lcdDrawRect(xpos+220, ypos+10, ypos+410, ypos+260, RED);
+        uint16_t columns = panelColumns__(panelCount);
+        uint16_t rows = (panelCount + columns - 1) / columns;
+        uint16_t width = SCREEN_WIDTH / columns;
+        uint16_t height = PANEL_AREA_HEIGHT / rows;
+        for(uint32_t i = 0; i < panelCount; i++) {
+            resultPanel_t* panel = &panels[i];
+            drawResultPanel__((i % columns) * width, PANEL_TOP + (i / columns) * height, width, height,
+                              panel->title, panel->result, panel->digits, panel->passesLabel, panel->accel);
         }
 
         lcdUpdateVScreen();
@@ -303,79 +581,182 @@ void controlTask(void* param) {
     }
 }
 
-void leibnizTask(void* param) {
+// Runs the sweep once and ends, SW3 cancels it
+void benchTask(void* param) {
+    sweepConfig_t sweep;
+    sweep_default_config(&sweep);
+    sweep.maxDigits = DIGIT_TARGET_MAX;
+    sweep.repeats = BENCH_REPEATS;
+    sweep.timeoutUs = BENCH_TIMEOUT_US;
+    sweep.format = BENCH_FORMAT;
+    sweep.config.format = SERIES_FORMAT;
+    sweep.config.sumMode = SERIES_SUM_MODE;
+    sweep.config.seed = MONTE_CARLO_SEED;
+    sweep.cancel = &benchCancel;
+    ESP_LOGI(TAG, "Benchmark: %d repeats, %d s timeout", BENCH_REPEATS, BENCH_TIMEOUT_US / 1000000);
+    bool done = sweep_run(&sweep);
+    ESP_LOGI(TAG, "Benchmark %s", done ? "done" : "cancelled");
+    xEventGroupClearBits(piCalcEventGroup, BENCH_START);
+    vTaskDelete(NULL);
+}
+
+void chudnovskyTask(void* param) {
     piResult_t piResult;
-    
-    uint32_t iterator = 0;
-    double sum = 0;
-    double divisionValue = 0;
+    chudnovskyStats_t stats;
+    char* piDigits = malloc(CHUDNOVSKY_MAX_DIGITS + 3);
+    assert(piDigits != NULL);
+
     vTaskDelay(100);
-    TickType_t startTick = xTaskGetTickCount();
     for(;;) {
-        divisionValue = 1.0 / (((double)iterator * 2.0) + 1.0);
-        if(iterator % 2) {
-            sum -= divisionValue;
-        } else {
-            sum += divisionValue;
-        }
-        iterator++;
-        piResult.tickCount = xTaskGetTickCount() - startTick;
-        piResult.piValue = sum * 4.0;
-        piResult.iterations = iterator;
-        xQueueSendToFront(leibnizQueue, &piResult, 0);
-        if(iterator % 500 == 0) {
-            vTaskDelay(1);
-        } else {
-            taskYIELD();
+        // A new run starts every time the task gets resumed
+        chudnovskyCancel = false;
+        int64_t startUs = picalc_time_us();
+        uint32_t digits = CHUDNOVSKY_START_DIGITS;
+        for(;;) {
+            // every round starts from scratch, the rate is the one of the last round. A round can
+            // outlast the 32-bit cycle counter, the cycles come from the CPU time.
+            uint64_t cpuStart = picalc_cpu_time_us();
+            if(!chudnovsky_compute(digits, piDigits, CHUDNOVSKY_MAX_DIGITS + 3, &chudnovskyCancel, &stats)) {
+                break;
+            }
+            if(chudnovskyCancel) {
+                break;
+            }
+            piResult.elapsedUs = picalc_time_us() - startUs;
+            piResult.cpuUs = (int64_t)picalc_cpu_time_since_us(cpuStart);
+            piResult.cycles = (uint64_t)piResult.cpuUs * picalc_cycles_per_us();
+            piResult.piValue = strtod(piDigits, NULL);
+            piResult.piAccelerated = piResult.piValue;
+            piResult.iterations = stats.terms;
+            piResult.digits = stats.digits;
+            piResult.errorBound = pow(10.0, -(double)stats.digits);
+            piResult.probable = false;
+            xQueueOverwrite(chudnovskyQueue, &piResult);
+            if(digits >= CHUDNOVSKY_MAX_DIGITS) {
+                ESP_LOGI(TAG, "Chudnovsky: %d digits in %.3fs, last round cpu %.3fs", (int)digits, piResult.elapsedUs / 1e6, piResult.cpuUs / 1e6);
+                break;
+            }
+            // Every round doubles the precision
+            digits = (digits * 2 > CHUDNOVSKY_MAX_DIGITS) ? CHUDNOVSKY_MAX_DIGITS : digits * 2;
         }
+        vTaskSuspend(NULL);
     }
 }
 
-void eulerTask(void* param) {
+void machinTask(void* param) {
     piResult_t piResult;
-    
-    uint32_t n = 1;
-    double sum = 0;
-    
+    machinStats_t stats;
+    char* piDigits = malloc(MACHIN_MAX_DIGITS + 3);
+    assert(piDigits != NULL);
+
     vTaskDelay(100);
-    TickType_t startTick = xTaskGetTickCount();
-    
     for(;;) {
-        sum += 1.0 / ((double)n * (double)n);
-        
-        piResult.tickCount = xTaskGetTickCount() - startTick;
-        piResult.piValue = sqrt(6.0 * sum);
-        piResult.iterations = n;
-        xQueueSendToFront(eulerQueue, &piResult, 0);
-        
-        n++;
-        
-        if(n % 500 == 0) {
+        // A new run starts every time the task gets resumed
+        machinCancel = false;
+        int64_t startUs = picalc_time_us();
+        uint32_t digits = MACHIN_START_DIGITS;
+        for(;;) {
+            // like Chudnovsky per round, the CPU time of the series workers and of this task
+            uint64_t cpuStart = picalc_cpu_time_us();
+            // one worker task per arctan series, pinned alternately to core 0 and core 1
+            if(!machin_compute(MACHIN_FORMULA, digits, piDigits, MACHIN_MAX_DIGITS + 3, 0, &machinCancel, &stats)) {
+                break;
+            }
+            if(machinCancel) {
+                break;
+            }
+            uint32_t terms = 0;
+            int64_t cpuUs = (int64_t)picalc_cpu_time_since_us(cpuStart);
+            for(uint32_t i = 0; i < stats.seriesCount; i++) {
+                terms += stats.series[i].terms;
+                cpuUs += stats.series[i].cpuUs;
+            }
+            piResult.elapsedUs = picalc_time_us() - startUs;
+            piResult.cpuUs = cpuUs;
+            piResult.cycles = (uint64_t)cpuUs * picalc_cycles_per_us();
+            piResult.piValue = strtod(piDigits, NULL);
+            piResult.piAccelerated = piResult.piValue;
+            piResult.iterations = terms;
+            piResult.digits = stats.digits;
+            piResult.errorBound = pow(10.0, -(double)stats.digits);
+            piResult.probable = false;
+            xQueueOverwrite(machinQueue, &piResult);
+            if(digits >= MACHIN_MAX_DIGITS) {
+                ESP_LOGI(TAG, "%s: %d digits, %d limbs in %.3fs", machin_formula_name(MACHIN_FORMULA), (int)digits, (int)stats.limbs, piResult.elapsedUs / 1e6);
+                for(uint32_t i = 0; i < stats.seriesCount; i++) {
+                    machinSeriesStats_t* series = &stats.series[i];
+                    float seconds = (float)series->cpuUs / 1000000;
+                    ESP_LOGI(TAG, "  atan(1/%d) on core %d: %.0f terms/s, %.0f limbs/s, cpu %.3fs of %.3fs", (int)series->k,
+                             (int)(series->worker % portNUM_PROCESSORS), series->terms / seconds, series->limbOps / seconds,
+                             seconds, series->timeUs / 1e6);
+                }
+                break;
+            }
+            digits = (digits * 2 > MACHIN_MAX_DIGITS) ? MACHIN_MAX_DIGITS : digits * 2;
+        }
+        vTaskSuspend(NULL);
+    }
+}
+
+void spigotTask(void* param) {
+    spigot_t spigot;
+    bool ready = spigot_init(&spigot, SPIGOT_MAX_DIGITS, spigotCells);
+    if(!ready) {
+        ESP_LOGE(TAG, "SPIGOT_MAX_DIGITS is above SPIGOT_DIGIT_LIMIT");
+    }
+
+    vTaskDelay(100);
+    while(ready && !spigot_done(&spigot)) {
+        if(spigot_generate(&spigot, &spigotRing, 1) == 0) {
+            // controlTask has not caught up with the ring buffer yet
             vTaskDelay(1);
         } else {
             taskYIELD();
         }
     }
+    for(;;) {
+        vTaskSuspend(NULL);
+    }
 }
 
+
 void app_main()
 {
     //Initialize Eduboard2 BSP
     eduboard2_init();
 
     piCalcEventGroup = xEventGroupCreate();
-    leibnizQueue = xQueueCreate(100, sizeof(piResult_t));
-    eulerQueue = xQueueCreate(100, sizeof(piResult_t));
+    chudnovskyQueue = xQueueCreate(1, sizeof(piResult_t));
+    machinQueue = xQueueCreate(1, sizeof(piResult_t));
+    ringbuf_init(&spigotRing, spigotRingStorage, sizeof(spigotRingStorage));
+    if(SERIES_PARALLEL_WORKERS > 1 && SERIES_PARALLEL_STEALING) {
+        executor_init(&seriesExecutor, SERIES_PARALLEL_WORKERS, 1);
+    }
+    piAlgoConfig_t config = {SERIES_FORMAT, SERIES_SUM_MODE, SERIES_ACCEL_NONE, SERIES_PARALLEL_WORKERS, SERIES_PARALLEL_SPLIT,
+                             (SERIES_PARALLEL_WORKERS > 1 && SERIES_PARALLEL_STEALING) ? &seriesExecutor : NULL, MONTE_CARLO_SEED, 0};
+    race_init(&race, &config, RACE_SLICE_US, RACE_YIELD_US);
+    race.engines[PI_ALGO_MONTE_CARLO].config.workers = MONTE_CARLO_LANES;
+    race.engines[PI_ALGO_MONTE_CARLO].config.executor = NULL;
+    race_reset(&race);
+#ifdef CONFIG_ENABLE_FLASH
+    restoreCheckpoints__();
+#endif
     
     //Create templateTask
     xTaskCreatePinnedToCore(inputTask, "inputTask", 2*2048, NULL, 10, NULL, 0);
-    xTaskCreatePinnedToCore(controlTask, "controlTask", 2*2048, NULL, 10, NULL, 0);
-    xTaskCreatePinnedToCore(leibnizTask, "leibnizTask", 2*2048, NULL, 1, &leibnizTaskHandle, 1);
-    xTaskCreatePinnedToCore(eulerTask, "eulerTask", 2*2048, NULL, 1, &eulerTaskHandle, 1);
+    xTaskCreatePinnedToCore(controlTask, "controlTask", 3*2048, NULL, 10, NULL, 0);
+    race_start_workers(&race, 1, 3*2048);
+    xTaskCreatePinnedToCore(chudnovskyTask, "chudnovskyTask", 4*2048, NULL, 1, &chudnovskyTaskHandle, 1);
+    xTaskCreatePinnedToCore(machinTask, "machinTask", 3*2048, NULL, 1, &machinTaskHandle, 1);
+    xTaskCreatePinnedToCore(spigotTask, "spigotTask", 2*2048, NULL, 1, &spigotTaskHandle, 1);
     
-    // Initially suspend both calculation tasks
-    vTaskSuspend(leibnizTaskHandle);
-    vTaskSuspend(eulerTaskHandle);
+    // Initially suspend the digit engines, the race workers park until an engine gets started
+    vTaskSuspend(chudnovskyTaskHandle);
+    vTaskSuspend(machinTaskHandle);
+    vTaskSuspend(spigotTaskHandle);
 
+    if(BENCH_AT_BOOT) {
+        xEventGroupSetBits(piCalcEventGroup, BENCH_START);
+    }
     return;
-}
\ No newline at end of file
+}